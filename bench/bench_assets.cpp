@@ -0,0 +1,228 @@
+/// @file
+/// Benchmarks for asset loading on the CPU side (file reads, image decode, mip chains,
+/// block compression, path handling).
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "core/AssetPath.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Platform.hpp"
+#include "core/Simd.hpp"
+#include "harness.hpp"
+#include "rendering/BlockEncoder.hpp"
+#include "rendering/MipGenerator.hpp"
+#include "rendering/ShaderManager.hpp"
+#include "rendering/TextureLoader.hpp"
+
+namespace
+{
+
+/// Repository root holding data/, set by CMake.
+const std::string kAssetDir = VIBEGL_BENCH_ASSET_DIR;
+
+/// Read the demo vertex shader, as ShaderManager::loadProgram does.
+void shaderReadFile(vibegl::bench::State& state)
+{
+    const std::string path =
+        vibegl::resolveAssetPath(kAssetDir, std::string("data/shaders/cube") +
+                                                vibegl::kShaderSuffix + ".vert");
+    std::error_code error;
+    const auto size = std::filesystem::file_size(path, error);
+    if (error)
+    {
+        state.skip("missing " + path);
+        return;
+    }
+    state.setBytesPerIteration(size);
+
+    for (std::uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        auto source = vibegl::ShaderManager::readFile(path);
+        vibegl::bench::doNotOptimize(source);
+    }
+}
+VIBEGL_BENCHMARK(shaderReadFile);
+
+/// Decode the demo texture to RGBA8, as TextureLoader::loadTexture does before upload.
+void textureDecode(vibegl::bench::State& state)
+{
+    const std::string path = vibegl::resolveAssetPath(kAssetDir, "data/textures/sample.png");
+    std::error_code error;
+    const auto size = std::filesystem::file_size(path, error);
+    if (error)
+    {
+        state.skip("missing " + path);
+        return;
+    }
+    state.setBytesPerIteration(size);
+
+    for (std::uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        auto image = vibegl::TextureLoader::decodeImage(path);
+        if (!image)
+        {
+            state.skip(image.error().message + ": " + image.error().context);
+            return;
+        }
+        vibegl::bench::doNotOptimize(image->pixels);
+    }
+}
+VIBEGL_BENCHMARK(textureDecode);
+
+/// Build the demo texture's mip chain as TextureStreamer does on a worker. Compare with
+/// the glGenerateMipmap() path by running the app with and without --gl-mipmaps.
+void runMipChain(vibegl::bench::State& state, bool simd, vibegl::JobSystem* jobs)
+{
+    static const auto image = vibegl::TextureLoader::decodeImage(
+        vibegl::resolveAssetPath(kAssetDir, "data/textures/sample.png"));
+    if (!image)
+    {
+        state.skip(image.error().message + ": " + image.error().context);
+        return;
+    }
+    if (simd && !vibegl::Simd::available())
+    {
+        state.skip("no SSE2 kernel in this build");
+        return;
+    }
+    state.setBytesPerIteration(static_cast<std::uint64_t>(image->width) *
+                               static_cast<std::uint64_t>(image->height) * 4);
+
+    vibegl::Simd::setEnabled(simd);
+    for (std::uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        auto chain =
+            vibegl::MipGenerator::generate(image->pixels.get(), image->width, image->height, jobs);
+        vibegl::bench::doNotOptimize(chain.pixels);
+    }
+    vibegl::Simd::setEnabled(true);
+}
+
+void mipChainScalar(vibegl::bench::State& state)
+{
+    runMipChain(state, false, nullptr);
+}
+VIBEGL_BENCHMARK(mipChainScalar);
+
+void mipChainSimd(vibegl::bench::State& state)
+{
+    runMipChain(state, true, nullptr);
+}
+VIBEGL_BENCHMARK(mipChainSimd);
+
+/// SIMD kernel with large levels split across all cores.
+void mipChainParallel(vibegl::bench::State& state)
+{
+    static vibegl::JobSystem jobs;
+    if (!jobs.isRunning())
+    {
+        jobs.start(-1);
+    }
+    runMipChain(state, vibegl::Simd::available(), &jobs);
+}
+VIBEGL_BENCHMARK(mipChainParallel);
+
+/// Encode the demo texture's base level as TextureLoader::compressImage() does on a cache
+/// miss. Bytes per iteration are RGBA8 input bytes.
+void runBlockEncode(vibegl::bench::State& state, vibegl::BlockFormat format,
+                    vibegl::BlockQuality quality, bool simd, vibegl::JobSystem* jobs)
+{
+    static const auto image = vibegl::TextureLoader::decodeImage(
+        vibegl::resolveAssetPath(kAssetDir, "data/textures/sample.png"));
+    if (!image)
+    {
+        state.skip(image.error().message + ": " + image.error().context);
+        return;
+    }
+    if (simd && !vibegl::Simd::available())
+    {
+        state.skip("no SSE2 kernel in this build");
+        return;
+    }
+    state.setBytesPerIteration(static_cast<std::uint64_t>(image->width) *
+                               static_cast<std::uint64_t>(image->height) * 4);
+
+    std::vector<std::byte> blocks(
+        vibegl::BlockEncoder::encodedSize(format, image->width, image->height));
+    vibegl::Simd::setEnabled(simd);
+    for (std::uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        vibegl::BlockEncoder::encode(image->pixels.get(), image->width, image->height, format,
+                                     quality, blocks, jobs);
+        vibegl::bench::doNotOptimize(blocks);
+    }
+    vibegl::Simd::setEnabled(true);
+}
+
+void bc1Normal(vibegl::bench::State& state)
+{
+    runBlockEncode(state, vibegl::BlockFormat::BC1, vibegl::BlockQuality::Normal, true,
+                   nullptr);
+}
+VIBEGL_BENCHMARK(bc1Normal);
+
+void bc3Normal(vibegl::bench::State& state)
+{
+    runBlockEncode(state, vibegl::BlockFormat::BC3, vibegl::BlockQuality::Normal, true,
+                   nullptr);
+}
+VIBEGL_BENCHMARK(bc3Normal);
+
+void bc7Fast(vibegl::bench::State& state)
+{
+    runBlockEncode(state, vibegl::BlockFormat::BC7, vibegl::BlockQuality::Fast, true, nullptr);
+}
+VIBEGL_BENCHMARK(bc7Fast);
+
+void bc7Normal(vibegl::bench::State& state)
+{
+    runBlockEncode(state, vibegl::BlockFormat::BC7, vibegl::BlockQuality::Normal, true,
+                   nullptr);
+}
+VIBEGL_BENCHMARK(bc7Normal);
+
+void bc7High(vibegl::bench::State& state)
+{
+    runBlockEncode(state, vibegl::BlockFormat::BC7, vibegl::BlockQuality::High, true, nullptr);
+}
+VIBEGL_BENCHMARK(bc7High);
+
+/// bc7Normal with the scalar palette search.
+void bc7NormalScalar(vibegl::bench::State& state)
+{
+    runBlockEncode(state, vibegl::BlockFormat::BC7, vibegl::BlockQuality::Normal, false,
+                   nullptr);
+}
+VIBEGL_BENCHMARK(bc7NormalScalar);
+
+/// bc7Normal with block rows split across all cores.
+void bc7NormalParallel(vibegl::bench::State& state)
+{
+    static vibegl::JobSystem jobs;
+    if (!jobs.isRunning())
+    {
+        jobs.start(-1);
+    }
+    runBlockEncode(state, vibegl::BlockFormat::BC7, vibegl::BlockQuality::Normal,
+                   vibegl::Simd::available(), &jobs);
+}
+VIBEGL_BENCHMARK(bc7NormalParallel);
+
+/// Application::resolvePath with a configured asset base path.
+void resolvePath(vibegl::bench::State& state)
+{
+    const std::string base = "/opt/vibegl/assets/";
+    const std::string relative = "data/shaders/cube_gl46.vert";
+
+    for (std::uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        std::string path = vibegl::resolveAssetPath(base, relative);
+        vibegl::bench::doNotOptimize(path);
+    }
+}
+VIBEGL_BENCHMARK(resolvePath);
+
+} // namespace
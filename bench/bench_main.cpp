@@ -0,0 +1,100 @@
+/// @file
+/// Entry point of the vibegl_bench microbenchmark runner.
+
+#include <charconv>
+#include <cstdio>
+#include <span>
+#include <string_view>
+
+#include "harness.hpp"
+
+namespace
+{
+
+template<typename T>
+void parseNumber(std::string_view text, T& value)
+{
+    std::from_chars(text.data(), text.data() + text.size(), value);
+}
+
+/// Parse command line options.
+///
+/// Supported options:
+/// - `--filter TEXT`: run only benchmarks whose name contains TEXT
+/// - `--reps N`: recorded repetitions (default 20)
+/// - `--warmup N`: warmup repetitions (default 3)
+/// - `--min-time MS`: minimum duration of one repetition in milliseconds (default 10)
+/// - `--json PATH`: write results as JSON
+/// - `--list`: print benchmark names and exit
+vibegl::bench::Options parseArguments(std::span<char*> args, bool& listOnly)
+{
+    vibegl::bench::Options options;
+    for (std::size_t i = 1; i < args.size(); ++i)
+    {
+        const std::string_view arg = args[i];
+        const bool hasValue = i + 1 < args.size();
+        if (arg == "--filter" && hasValue)
+        {
+            options.filter = args[++i];
+        }
+        else if (arg == "--reps" && hasValue)
+        {
+            parseNumber(args[++i], options.repetitions);
+        }
+        else if (arg == "--warmup" && hasValue)
+        {
+            parseNumber(args[++i], options.warmupRepetitions);
+        }
+        else if (arg == "--min-time" && hasValue)
+        {
+            double milliseconds = 0.0;
+            parseNumber(args[++i], milliseconds);
+            options.minRepetitionSeconds = milliseconds / 1000.0;
+        }
+        else if (arg == "--json" && hasValue)
+        {
+            options.jsonPath = args[++i];
+        }
+        else if (arg == "--list")
+        {
+            listOnly = true;
+        }
+        else
+        {
+            std::fprintf(stderr, "Ignoring unknown argument: %s\n", args[i]);
+        }
+    }
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    bool listOnly = false;
+    const vibegl::bench::Options options =
+        parseArguments(std::span(argv, static_cast<std::size_t>(argc)), listOnly);
+
+    if (listOnly)
+    {
+        for (const auto& benchmark : vibegl::bench::registeredBenchmarks())
+        {
+            std::printf("%s\n", benchmark.name);
+        }
+        return 0;
+    }
+
+    const auto results = vibegl::bench::runBenchmarks(options);
+    if (!options.jsonPath.empty())
+    {
+        auto written = vibegl::bench::writeJson(options.jsonPath, options, results);
+        if (!written)
+        {
+            std::fprintf(stderr, "%s - %s\n", written.error().message.c_str(),
+                         written.error().context.c_str());
+            return 1;
+        }
+        std::printf("Wrote %s\n", options.jsonPath.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,45 @@
+/// @file
+/// Benchmarks for per-frame transform math.
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "harness.hpp"
+
+namespace
+{
+
+/// Model-view-projection construction as done for the demo cube every frame.
+void mvpConstruction(vibegl::bench::State& state)
+{
+    const glm::vec3 axis = glm::normalize(glm::vec3(0.5f, 1.0f, 0.0f));
+    const float aspect = 1280.0f / 720.0f;
+    float angle = 0.0f;
+
+    for (std::uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        glm::mat4 model = glm::rotate(glm::mat4(1.0f), glm::radians(angle), axis);
+        glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -3.0f));
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f), aspect, 0.1f, 100.0f);
+        glm::mat4 mvp = projection * view * model;
+        vibegl::bench::doNotOptimize(mvp);
+        angle += 0.25f;
+    }
+}
+VIBEGL_BENCHMARK(mvpConstruction);
+
+/// Matrix product alone, to separate it from the trigonometry in mvpConstruction.
+void matrixMultiply(vibegl::bench::State& state)
+{
+    glm::mat4 a = glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 2.0f, 3.0f));
+    const glm::mat4 b = glm::rotate(glm::mat4(1.0f), 0.1f, glm::vec3(0.0f, 1.0f, 0.0f));
+
+    for (std::uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        a = a * b;
+        vibegl::bench::doNotOptimize(a);
+    }
+}
+VIBEGL_BENCHMARK(matrixMultiply);
+
+} // namespace
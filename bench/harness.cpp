@@ -0,0 +1,236 @@
+#include "harness.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <numeric>
+#include <string_view>
+
+namespace vibegl::bench
+{
+
+namespace
+{
+
+std::vector<BenchmarkInfo>& registry()
+{
+    static std::vector<BenchmarkInfo> benchmarks;
+    return benchmarks;
+}
+
+/// Run one repetition and return its duration in seconds.
+double timeRepetition(const BenchmarkInfo& benchmark, State& state)
+{
+    const auto start = std::chrono::steady_clock::now();
+    benchmark.function(state);
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+/// Grow the iteration count until one repetition reaches the target duration.
+std::uint64_t calibrate(const BenchmarkInfo& benchmark, double targetSeconds, State& probe)
+{
+    constexpr std::uint64_t kMaxIterations = std::uint64_t{1} << 30;
+    std::uint64_t iterations = 1;
+    while (iterations < kMaxIterations)
+    {
+        probe = State(iterations);
+        const double seconds = timeRepetition(benchmark, probe);
+        if (!probe.skipReason().empty() || seconds >= targetSeconds)
+        {
+            break;
+        }
+        // Aim 20% past the target, growing at most 10x per step
+        const double scale = seconds > 0.0 ? (targetSeconds * 1.2) / seconds : 10.0;
+        const auto next = static_cast<std::uint64_t>(static_cast<double>(iterations) *
+                                                     std::clamp(scale, 2.0, 10.0));
+        iterations = std::min(next, kMaxIterations);
+    }
+    return iterations;
+}
+
+void writeJsonString(std::ostream& out, const std::string& text)
+{
+    out << '"';
+    for (const char c : text)
+    {
+        const auto byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\')
+        {
+            out << '\\' << c;
+        }
+        else if (byte < 0x20)
+        {
+            // Skip reasons and names may contain newlines or tabs; JSON needs them escaped
+            constexpr std::string_view kHex = "0123456789abcdef";
+            out << "\\u00" << kHex[byte >> 4U] << kHex[byte & 0xFU];
+        }
+        else
+        {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+bool registerBenchmark(const char* name, BenchmarkFunction function)
+{
+    registry().push_back(BenchmarkInfo{.name = name, .function = function});
+    return true;
+}
+
+const std::vector<BenchmarkInfo>& registeredBenchmarks()
+{
+    return registry();
+}
+
+Statistics summarize(std::vector<double>& samples)
+{
+    Statistics stats;
+    if (samples.empty())
+    {
+        return stats;
+    }
+
+    std::ranges::sort(samples);
+    const std::size_t count = samples.size();
+    stats.min = samples.front();
+    stats.max = samples.back();
+    stats.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(count);
+    stats.median = (count % 2 == 1) ? samples[count / 2]
+                                    : 0.5 * (samples[(count / 2) - 1] + samples[count / 2]);
+
+    double variance = 0.0;
+    for (const double sample : samples)
+    {
+        variance += (sample - stats.mean) * (sample - stats.mean);
+    }
+    stats.stddev = count > 1 ? std::sqrt(variance / static_cast<double>(count - 1)) : 0.0;
+    return stats;
+}
+
+std::vector<BenchmarkResult> runBenchmarks(const Options& options)
+{
+    std::vector<BenchmarkResult> results;
+    std::printf("%-32s %12s %12s %12s %10s %8s\n", "benchmark", "median ns", "min ns",
+                "stddev ns", "MB/s", "iters");
+
+    for (const BenchmarkInfo& benchmark : registeredBenchmarks())
+    {
+        if (!options.filter.empty() &&
+            std::string_view(benchmark.name).find(options.filter) == std::string_view::npos)
+        {
+            continue;
+        }
+
+        BenchmarkResult result;
+        result.name = benchmark.name;
+        State state(1);
+        result.iterations = calibrate(benchmark, options.minRepetitionSeconds, state);
+        if (!state.skipReason().empty())
+        {
+            result.skipReason = state.skipReason();
+            std::printf("%-32s skipped: %s\n", benchmark.name, result.skipReason.c_str());
+            results.push_back(std::move(result));
+            continue;
+        }
+
+        for (std::uint32_t i = 0; i < options.warmupRepetitions; ++i)
+        {
+            state = State(result.iterations);
+            timeRepetition(benchmark, state);
+        }
+
+        std::vector<double> samples;
+        samples.reserve(options.repetitions);
+        for (std::uint32_t i = 0; i < options.repetitions; ++i)
+        {
+            state = State(result.iterations);
+            const double seconds = timeRepetition(benchmark, state);
+            samples.push_back(seconds * 1e9 / static_cast<double>(result.iterations));
+        }
+
+        result.repetitions = options.repetitions;
+        result.nsPerIteration = summarize(samples);
+        if (state.bytesPerIteration() > 0 && result.nsPerIteration.median > 0.0)
+        {
+            result.bytesPerSecond = static_cast<double>(state.bytesPerIteration()) * 1e9 /
+                                    result.nsPerIteration.median;
+        }
+
+        std::printf("%-32s %12.1f %12.1f %12.1f %10.1f %8llu\n", benchmark.name,
+                    result.nsPerIteration.median, result.nsPerIteration.min,
+                    result.nsPerIteration.stddev, result.bytesPerSecond / 1e6,
+                    static_cast<unsigned long long>(result.iterations));
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+Result<void> writeJson(const std::string& path, const Options& options,
+                       const std::vector<BenchmarkResult>& results)
+{
+    std::ofstream out(path);
+    if (!out.is_open())
+    {
+        return std::unexpected(
+            Error{.message = "Failed to open benchmark output", .context = path});
+    }
+
+    const std::time_t now = std::time(nullptr);
+    std::tm utc{};
+#ifdef _WIN32
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+    char date[32] = {};
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", &utc);
+
+    out.precision(10);
+    out << "{\n  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+#ifdef NDEBUG
+    out << "    \"build_type\": \"release\",\n";
+#else
+    out << "    \"build_type\": \"debug\",\n";
+#endif
+    out << "    \"warmup_repetitions\": " << options.warmupRepetitions << ",\n";
+    out << "    \"min_repetition_seconds\": " << options.minRepetitionSeconds << "\n";
+    out << "  },\n  \"benchmarks\": [";
+
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchmarkResult& result = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+        writeJsonString(out, result.name);
+        if (!result.skipReason.empty())
+        {
+            out << ", \"skipped\": ";
+            writeJsonString(out, result.skipReason);
+            out << "}";
+            continue;
+        }
+        const Statistics& ns = result.nsPerIteration;
+        out << ", \"iterations\": " << result.iterations
+            << ", \"repetitions\": " << result.repetitions << ", \"ns_per_iteration\": {"
+            << "\"min\": " << ns.min << ", \"max\": " << ns.max << ", \"mean\": " << ns.mean
+            << ", \"median\": " << ns.median << ", \"stddev\": " << ns.stddev << "}"
+            << ", \"bytes_per_second\": " << result.bytesPerSecond << "}";
+    }
+    out << "\n  ]\n}\n";
+
+    if (!out)
+    {
+        return std::unexpected(
+            Error{.message = "Failed to write benchmark output", .context = path});
+    }
+    return {};
+}
+
+} // namespace vibegl::bench
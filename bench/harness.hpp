@@ -0,0 +1,114 @@
+#pragma once
+
+/// @file
+/// Minimal microbenchmark harness: registration, calibration, statistics and JSON output.
+///
+/// Each benchmark is a function taking a State and running the measured operation
+/// State::iterations() times. The harness picks an iteration count so one repetition
+/// lasts at least Options::minRepetitionSeconds, runs warmup repetitions, then records
+/// the time per iteration of every measured repetition.
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/Result.hpp"
+
+namespace vibegl::bench {
+
+/// Per-run context handed to a benchmark function.
+class State {
+public:
+    explicit State(std::uint64_t iterations) : iterations_(iterations) {}
+
+    /// Number of times the measured operation must run.
+    std::uint64_t iterations() const { return iterations_; }
+
+    /// Report bytes handled by one iteration to get a throughput figure.
+    void setBytesPerIteration(std::uint64_t bytes) { bytesPerIteration_ = bytes; }
+    std::uint64_t bytesPerIteration() const { return bytesPerIteration_; }
+
+    /// Mark the benchmark as not runnable (e.g. missing asset); its timing is discarded.
+    void skip(std::string reason) { skipReason_ = std::move(reason); }
+    const std::string& skipReason() const { return skipReason_; }
+
+private:
+    std::uint64_t iterations_;
+    std::uint64_t bytesPerIteration_ = 0;
+    std::string skipReason_;
+};
+
+/// Keep the compiler from discarding a computed value.
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    const volatile auto* sink = &value;
+    static_cast<void>(sink);
+#endif
+}
+
+using BenchmarkFunction = void (*)(State&);
+
+/// A registered benchmark.
+struct BenchmarkInfo {
+    const char* name;
+    BenchmarkFunction function;
+};
+
+/// Add a benchmark to the global registry (use VIBEGL_BENCHMARK instead).
+bool registerBenchmark(const char* name, BenchmarkFunction function);
+
+/// All benchmarks registered so far, in registration order.
+const std::vector<BenchmarkInfo>& registeredBenchmarks();
+
+/// Harness settings, filled from the command line.
+struct Options {
+    std::uint32_t warmupRepetitions = 3;   ///< Unrecorded repetitions before measuring
+    std::uint32_t repetitions = 20;        ///< Recorded repetitions
+    double minRepetitionSeconds = 0.01;    ///< Calibration target per repetition
+    std::string filter;                    ///< Run only names containing this substring
+    std::string jsonPath;                  ///< Write results here (empty = no JSON)
+};
+
+/// Nanoseconds per iteration across the recorded repetitions.
+struct Statistics {
+    double min = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    double median = 0.0;
+    double stddev = 0.0;
+};
+
+/// Outcome of one benchmark.
+struct BenchmarkResult {
+    std::string name;
+    std::uint64_t iterations = 0;   ///< Iterations per repetition
+    std::uint32_t repetitions = 0;  ///< Recorded repetitions
+    Statistics nsPerIteration;
+    double bytesPerSecond = 0.0;    ///< Based on the median (0 if not reported)
+    std::string skipReason;         ///< Non-empty if the benchmark was skipped
+};
+
+/// Compute summary statistics of per-iteration samples (sorts the input).
+Statistics summarize(std::vector<double>& samples);
+
+/// Run every registered benchmark matching the filter, printing progress to stdout.
+std::vector<BenchmarkResult> runBenchmarks(const Options& options);
+
+/// Write results as JSON for tracking across versions.
+Result<void> writeJson(const std::string& path, const Options& options,
+                       const std::vector<BenchmarkResult>& results);
+
+} // namespace vibegl::bench
+
+#define VIBEGL_BENCH_CONCAT_INNER(a, b) a##b
+#define VIBEGL_BENCH_CONCAT(a, b) VIBEGL_BENCH_CONCAT_INNER(a, b)
+
+/// Register a `void function(vibegl::bench::State&)` under its own name.
+#define VIBEGL_BENCHMARK(function)                                                                 \
+    static const bool VIBEGL_BENCH_CONCAT(vibeglBenchRegistered, __LINE__) =                       \
+        ::vibegl::bench::registerBenchmark(#function, function)
@@ -0,0 +1,44 @@
+# Script mode (cmake -P) helper for embed_shaders()
+# Inputs: OUTPUT (header path), ROOT (source root), FILES (list of files)
+
+set(CONTENT "#pragma once\n\n")
+string(APPEND CONTENT "// Generated by cmake/EmbedFiles.cmake - do not edit.\n\n")
+string(APPEND CONTENT "#include <array>\n#include <cstddef>\n#include <span>\n#include <string_view>\n\n")
+string(APPEND CONTENT "namespace vibegl::embedded {\n\n")
+string(APPEND CONTENT "struct File {\n")
+string(APPEND CONTENT "    std::string_view path;  ///< Relative to the source root\n")
+string(APPEND CONTENT "    std::span<const unsigned char> contents;\n")
+string(APPEND CONTENT "};\n\n")
+
+# CMake regexes have no {n} repetition, so spell out a 16-byte line
+string(REPEAT "0x[0-9a-f][0-9a-f]," 16 LINE_PATTERN)
+
+set(TABLE "")
+set(INDEX 0)
+foreach(FILE_PATH IN LISTS FILES)
+    file(RELATIVE_PATH RELATIVE "${ROOT}" "${FILE_PATH}")
+    file(READ "${FILE_PATH}" HEX HEX)
+    string(LENGTH "${HEX}" HEX_LENGTH)
+    if(HEX_LENGTH EQUAL 0)
+        # Zero-length arrays are ill-formed; an empty file is a single unused byte
+        set(HEX "00")
+        set(SIZE 0)
+    else()
+        math(EXPR SIZE "${HEX_LENGTH} / 2")
+    endif()
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," BYTES "${HEX}")
+    # Break the initializer into lines of 16 bytes
+    string(REGEX REPLACE "(${LINE_PATTERN})" "\\1\n    " BYTES "${BYTES}")
+    string(STRIP "${BYTES}" BYTES)
+
+    string(APPEND CONTENT "// ${RELATIVE}\n")
+    string(APPEND CONTENT "inline constexpr unsigned char kFile${INDEX}[] = {\n    ${BYTES}\n};\n\n")
+    string(APPEND TABLE "    File{\"${RELATIVE}\", std::span<const unsigned char>(kFile${INDEX}, ${SIZE})},\n")
+    math(EXPR INDEX "${INDEX} + 1")
+endforeach()
+
+string(APPEND CONTENT "inline constexpr std::array<File, ${INDEX}> kFiles = {\n${TABLE}};\n\n")
+string(APPEND CONTENT "} // namespace vibegl::embedded\n")
+
+# Only touch the header when its contents change, so dependents are not rebuilt needlessly
+file(CONFIGURE OUTPUT "${OUTPUT}" CONTENT "${CONTENT}" @ONLY)
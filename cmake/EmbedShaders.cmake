@@ -0,0 +1,37 @@
+# Shader embedding
+# Compiles the shader sources into the executable as constexpr byte arrays, so
+# shaders need no file I/O at startup
+
+# Generate EmbeddedShaders.hpp from every file under a directory and make it
+# available to a target. Paths in the table are relative to the source root
+# (e.g. "data/shaders/cube_gl46.vert").
+function(embed_shaders target directory)
+    if(NOT EMBED_SHADERS)
+        return()
+    endif()
+
+    file(GLOB_RECURSE SHADER_FILES CONFIGURE_DEPENDS "${directory}/*")
+    list(SORT SHADER_FILES)
+
+    set(GENERATED_DIR "${CMAKE_CURRENT_BINARY_DIR}/generated")
+    set(GENERATED_HEADER "${GENERATED_DIR}/EmbeddedShaders.hpp")
+
+    add_custom_command(
+        OUTPUT ${GENERATED_HEADER}
+        COMMAND ${CMAKE_COMMAND}
+            -DOUTPUT=${GENERATED_HEADER}
+            -DROOT=${CMAKE_SOURCE_DIR}
+            "-DFILES=${SHADER_FILES}"
+            -P ${CMAKE_SOURCE_DIR}/cmake/EmbedFiles.cmake
+        DEPENDS ${SHADER_FILES} ${CMAKE_SOURCE_DIR}/cmake/EmbedFiles.cmake
+        COMMENT "Embedding ${directory}"
+        VERBATIM
+    )
+
+    target_sources(${target} PRIVATE ${GENERATED_HEADER})
+    target_include_directories(${target} PRIVATE ${GENERATED_DIR})
+    target_compile_definitions(${target} PRIVATE VIBEGL_EMBEDDED_SHADERS)
+
+    list(LENGTH SHADER_FILES SHADER_COUNT)
+    message(STATUS "Embedding ${SHADER_COUNT} shader files into ${target}")
+endfunction()
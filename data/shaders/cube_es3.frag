@@ -9,6 +9,10 @@ uniform sampler2D uTexture;
 uniform vec3 uColor;
 
 void main() {
+#ifdef TEXTURED
     vec4 texColor = texture(uTexture, vTexCoord);
+#else
+    vec4 texColor = vec4(1.0);
+#endif
     FragColor = texColor * vec4(uColor, 1.0);
 }
@@ -3,6 +3,9 @@
 layout(location = 0) in vec3 aPosition;
 layout(location = 1) in vec2 aTexCoord;
 
+out gl_PerVertex {
+    vec4 gl_Position;
+};
 out vec2 vTexCoord;
 
 uniform mat4 uMVP;
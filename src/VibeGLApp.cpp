@@ -5,19 +5,25 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <imgui.h>
-#include <imgui_impl_glfw.h>
-#include <imgui_impl_opengl3.h>
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <array>
+#include <string>
 
+#include "core/GpuProfiler.hpp"
+#include "core/Platform.hpp"
+#include "core/Profiler.hpp"
+#include "core/ProfilerOverlay.hpp"
 #include "rendering/ShaderManager.hpp"
-#include "rendering/TextureLoader.hpp"
 
 namespace vibegl
 {
 
+/// Combinations drawn in earlier runs, warmed at startup.
+constexpr const char* PIPELINE_MANIFEST = "shader_cache/pipelines.txt";
+
 // Cube vertices using indexed drawing (position: x,y,z, texcoord: u,v)
 // 24 unique vertices (4 per face, needed for proper texture coordinates per face)
 // clang-format off
@@ -71,58 +77,141 @@ constexpr std::array<GLuint, 36> CUBE_INDICES = {
 };
 // clang-format on
 
-VibeGLApp::VibeGLApp() : Application(WindowConfig{"VibeGL", 1280, 720, true}) {}
+/// Interleaved cube vertex format (position: vec3, texcoord: vec2).
+static VertexLayout cubeVertexLayout()
+{
+    VertexLayout layout;
+    layout.stride = static_cast<GLsizei>(5 * sizeof(float));
+    layout.attributes = {
+        VertexAttribute{
+            .location = 0, .components = 3, .type = GL_FLOAT, .normalized = GL_FALSE, .offset = 0},
+        VertexAttribute{.location = 1,
+                        .components = 2,
+                        .type = GL_FLOAT,
+                        .normalized = GL_FALSE,
+                        .offset = static_cast<GLuint>(3 * sizeof(float))},
+    };
+    return layout;
+}
+
+VibeGLApp::VibeGLApp(const WindowConfig& config) : Application(config) {}
 
 VibeGLApp::~VibeGLApp() = default;
 
 void VibeGLApp::onInit()
 {
+    // Reuse linked program binaries from earlier runs (desktop GL only)
+    if constexpr (kIsDesktop)
+    {
+        ShaderManager::enableBinaryCache("shader_cache/");
+    }
+
     // Load shader program with automatic platform suffix
-    auto shaderResult = ShaderManager::loadProgram("cube", resolvePath("data/shaders/"));
+    auto shaderResult = shaders_.load("cube", resolvePath("data/shaders/"), {"TEXTURED"});
     if (!shaderResult)
     {
         spdlog::error("Failed to create shader program: {} - {}", shaderResult.error().message,
                       shaderResult.error().context);
         return;
     }
-    shaderProgram_ = shaderResult.value();
+    cubeShader_ = shaderResult.value();
+    texturedFeature_ = shaders_.feature(cubeShader_, "TEXTURED");
 
-    // Cache shader uniform locations for efficiency (avoid glGetUniformLocation per frame)
-    shaderLocations_.mvp = glGetUniformLocation(shaderProgram_, "uMVP");
-    shaderLocations_.color = glGetUniformLocation(shaderProgram_, "uColor");
-    shaderLocations_.texture = glGetUniformLocation(shaderProgram_, "uTexture");
-
-    // Load texture
-    auto textureResult = TextureLoader::loadTexture(resolvePath("data/textures/sample.png"));
-    if (!textureResult)
+    // Edited shader files are recompiled and swapped in at the next frame (only
+    // meaningful when shaders come from disk, see --shaders-from-disk)
+    if (!isHeadless() && !ShaderManager::embeddedShadersEnabled())
     {
-        spdlog::error("Failed to load texture: {} - {}", textureResult.error().message,
-                      textureResult.error().context);
-        return;
+        shaders_.enableHotReload([this] { requestRedraw(); });
     }
-    texture_ = textureResult.value();
+
+    // Texture decodes on a worker; the cube samples a placeholder until it is uploaded
+    textures_.setOnDecoded([this] { requestRedraw(); });
+    texture_ = textures_.load(resolvePath("data/textures/sample.png"));
 
     setupCubeGeometry();
+    setupSeparableStages();
     glEnable(GL_DEPTH_TEST);
+
+    // Warm start: both variants the UI can switch between, plus whatever earlier runs drew
+    cubeLayout_ = warmup_.addLayout("cube", cubeVertexLayout());
+    for (const ShaderFeatures features : {ShaderFeatures{0}, texturedFeature_})
+    {
+        warmup_.record(PipelineKey{.shader = cubeShader_,
+                                   .features = features,
+                                   .layout = cubeLayout_,
+                                   .state = PipelineWarmup::kDepthTest});
+    }
+    if constexpr (kIsDesktop)
+    {
+        if (auto manifest = warmup_.loadManifest(PIPELINE_MANIFEST); manifest)
+        {
+            spdlog::info("Pipeline manifest: {} combination(s)", manifest.value());
+        }
+    }
+}
+
+void VibeGLApp::onWarmup()
+{
+    // Compile variants and draw each combination once, offscreen, before the first frame
+    warmup_.warm();
 }
 
-void VibeGLApp::onTick(float deltaTime)
+void VibeGLApp::onFixedUpdate(double fixedDeltaTime)
 {
     // Update rotation
-    rotationAngle_ += rotationVelocity_ * deltaTime;
+    previousRotationAngle_ = rotationAngle_;
+    rotationAngle_ += rotationVelocity_ * static_cast<float>(fixedDeltaTime);
     if (rotationAngle_ >= 360.0f)
     {
         rotationAngle_ -= 360.0f;
+        previousRotationAngle_ -= 360.0f;
+    }
+    else if (rotationAngle_ < 0.0f)
+    {
+        rotationAngle_ += 360.0f;
+        previousRotationAngle_ += 360.0f;
+    }
+}
+
+void VibeGLApp::onUpdate(float /*deltaTime*/, FramePacket& packet)
+{
+    // The cube animates while it spins; in on-demand mode it idles once stopped
+    if (rotationVelocity_ != 0.0f)
+    {
+        requestRedraw();
+    }
+
+    buildScene(packet);
+    buildUI();
+}
+
+void VibeGLApp::onRender(const FramePacket& packet)
+{
+    // Frame boundary: swap in programs rebuilt from edited shader files
+    shaders_.applyReloads();
+
+    // Upload decoded textures within the frame budget; keep frames coming until done
+    textures_.update();
+    if (!textures_.isIdle())
+    {
+        requestRedraw();
     }
 
     // Clear
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    renderCube();
-    renderUI();
-
-    endFrame();
+    for (const DrawCommand& draw : packet.draws)
+    {
+        if (separable_)
+        {
+            renderCubeSeparable(draw);
+        }
+        else
+        {
+            renderCube(draw);
+        }
+    }
 }
 
 void VibeGLApp::onShutdown()
@@ -130,8 +219,33 @@ void VibeGLApp::onShutdown()
     glDeleteVertexArrays(1, &vao_);
     glDeleteBuffers(1, &vbo_);
     glDeleteBuffers(1, &ebo_);
-    TextureLoader::deleteTexture(texture_);
-    ShaderManager::deleteProgram(shaderProgram_);
+    textures_.clear();
+
+    // Remember what was drawn so the next run warms it (names resolve through shaders_)
+    if constexpr (kIsDesktop)
+    {
+        if (auto saved = warmup_.saveManifest(PIPELINE_MANIFEST); !saved)
+        {
+            spdlog::warn("{}: {}", saved.error().message, saved.error().context);
+        }
+    }
+    shaders_.clear();
+
+    const ShaderManager::SeparableStats stages = ShaderManager::separableStats();
+    if (stages.pipelinesBuilt > 0)
+    {
+        spdlog::info("Separable stages: {} built, {} reused; pipelines: {} built, {} reused",
+                     stages.stagesBuilt, stages.stageReuses, stages.pipelinesBuilt,
+                     stages.pipelineReuses);
+    }
+    ShaderManager::clearStages();
+
+    const ShaderManager::BinaryCacheStats cache = ShaderManager::binaryCacheStats();
+    if (cache.hits + cache.misses + cache.rejected > 0)
+    {
+        spdlog::info("Program binary cache: {} hit(s), {} miss(es), {} rejected, {} written",
+                     cache.hits, cache.misses, cache.rejected, cache.writes);
+    }
 }
 
 void VibeGLApp::setupCubeGeometry()
@@ -152,22 +266,41 @@ void VibeGLApp::setupCubeGeometry()
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * CUBE_INDICES.size(), CUBE_INDICES.data(),
                  GL_STATIC_DRAW);
 
-    // Position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), nullptr);
-    glEnableVertexAttribArray(0);
-
-    // Texture coordinate attribute
-    glVertexAttribPointer(
-        1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float),
-        reinterpret_cast<void*>(3 * sizeof(float))); // NOLINT(performance-no-int-to-ptr)
-    glEnableVertexAttribArray(1);
+    // Position and texture coordinate attributes (the layout warm-up draws use too)
+    cubeVertexLayout().apply();
 
     glBindVertexArray(0);
 }
 
-void VibeGLApp::renderCube()
+void VibeGLApp::setupSeparableStages()
 {
-    glUseProgram(shaderProgram_);
+    if (!ShaderManager::hasSeparateShaderObjects())
+    {
+        return;
+    }
+
+    // One vertex stage shared by both fragment variants (not hot reloaded)
+    const std::string base = resolvePath("data/shaders/") + "cube" + kShaderSuffix;
+    auto vert = ShaderManager::loadStage(GL_VERTEX_SHADER, base + ".vert");
+    auto plain = ShaderManager::loadStage(GL_FRAGMENT_SHADER, base + ".frag");
+    auto textured = ShaderManager::loadStage(GL_FRAGMENT_SHADER, base + ".frag",
+                                             "#define TEXTURED 1\n");
+    for (const auto* stage : {&vert, &plain, &textured})
+    {
+        if (!*stage)
+        {
+            spdlog::warn("Separable cube stages unavailable: {} - {}", stage->error().message,
+                         stage->error().context);
+            return;
+        }
+    }
+    cubeVertStage_ = vert.value();
+    cubeFragStages_ = {plain.value(), textured.value()};
+}
+
+void VibeGLApp::buildScene(FramePacket& packet) const
+{
+    VIBEGL_PROFILE_SCOPE("buildScene");
 
     // Build model matrix
     auto model = glm::mat4(1.0f);
@@ -175,7 +308,10 @@ void VibeGLApp::renderCube()
     if (glm::length(axis) > 0.0f)
     {
         axis = glm::normalize(axis);
-        model = glm::rotate(model, glm::radians(rotationAngle_), axis);
+        // Blend the last two simulation steps so motion stays smooth at any frame rate
+        auto alpha = static_cast<float>(packet.interpolationAlpha);
+        float angle = previousRotationAngle_ + ((rotationAngle_ - previousRotationAngle_) * alpha);
+        model = glm::rotate(model, glm::radians(angle), axis);
     }
 
     // View matrix
@@ -188,27 +324,15 @@ void VibeGLApp::renderCube()
     // MVP
     glm::mat4 mvp = projection * view * model;
 
-    // Use cached uniform locations (queried once during initialization)
-    glUniformMatrix4fv(shaderLocations_.mvp, 1, GL_FALSE, glm::value_ptr(mvp));
-    glUniform3fv(shaderLocations_.color, 1, cubeColor_.data());
-
-    // Bind texture
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texture_);
-    glUniform1i(shaderLocations_.texture, 0);
-
-    // Draw
-    glBindVertexArray(vao_);
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(CUBE_INDICES.size()), GL_UNSIGNED_INT,
-                   nullptr);
-    glBindVertexArray(0);
+    DrawCommand& draw = packet.draws.emplace_back();
+    std::copy_n(glm::value_ptr(mvp), draw.transform.size(), draw.transform.begin());
+    draw.color = {cubeColor_[0], cubeColor_[1], cubeColor_[2], 1.0f};
+    draw.material = textured_ ? texturedFeature_ : 0;
 }
 
-void VibeGLApp::renderUI()
+void VibeGLApp::buildUI()
 {
-    ImGui_ImplOpenGL3_NewFrame();
-    ImGui_ImplGlfw_NewFrame();
-    ImGui::NewFrame();
+    VIBEGL_PROFILE_SCOPE("buildUI");
 
     // Control panel
     int width = getWindowWidth();
@@ -224,11 +348,96 @@ void VibeGLApp::renderUI()
     ImGui::SliderFloat3("Rotation Axis", rotationAxis_.data(), -1.0f, 1.0f, "%.2f");
     ImGui::SliderFloat("Rotation Velocity", &rotationVelocity_, -180.0f, 180.0f, "%.1f deg/s");
     ImGui::ColorEdit3("Cube Color", cubeColor_.data());
+    ImGui::Checkbox("Textured", &textured_);
+    if (cubeVertStage_ != 0)
+    {
+        ImGui::Checkbox("Separable Stages", &separable_);
+        const ShaderManager::SeparableStats stats = ShaderManager::separableStats();
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+        ImGui::Text("Pipelines: %llu built, %llu reused",
+                    static_cast<unsigned long long>(stats.pipelinesBuilt),
+                    static_cast<unsigned long long>(stats.pipelineReuses));
+    }
 
     ImGui::End();
 
-    ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    drawProfilerOverlay(&getFrameArena());
+}
+
+void VibeGLApp::renderCube(const DrawCommand& draw)
+{
+    VIBEGL_PROFILE_SCOPE("renderCube");
+    VIBEGL_GPU_PROFILE_SCOPE("renderCube");
+
+    // The draw's material is the shader variant's feature mask
+    const GLuint program = shaders_.program(cubeShader_, draw.material);
+    ShaderReflection* uniforms = ShaderManager::reflection(program);
+    if (uniforms == nullptr)
+    {
+        return;
+    }
+    glUseProgram(program);
+
+    // Teach the warm-up manifest about this combination (a set lookup once known)
+    warmup_.record(PipelineKey{.shader = cubeShader_,
+                               .features = draw.material,
+                               .layout = cubeLayout_,
+                               .state = PipelineWarmup::kDepthTest});
+
+    // Uniforms reflected at link time; unchanged values are not re-uploaded
+    uniforms->set("uMVP", draw.transform);
+    uniforms->set("uColor", draw.color);  // vec3 uniform takes the first 3 components
+
+    // Bind texture
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textures_.texture(texture_));
+    uniforms->set("uTexture", 0);
+
+    // Draw
+    glBindVertexArray(vao_);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(CUBE_INDICES.size()), GL_UNSIGNED_INT,
+                   nullptr);
+    glBindVertexArray(0);
+}
+
+void VibeGLApp::renderCubeSeparable(const DrawCommand& draw)
+{
+    VIBEGL_PROFILE_SCOPE("renderCubeSeparable");
+    VIBEGL_GPU_PROFILE_SCOPE("renderCubeSeparable");
+
+#ifdef __EMSCRIPTEN__
+    // WebGL 2 has no program pipelines; setupSeparableStages() leaves the path disabled
+    static_cast<void>(draw);
+#else
+    // Same stages every frame, so after the first draw this is a cached lookup
+    const GLuint fragStage = cubeFragStages_[draw.material != 0 ? 1 : 0];
+    auto pipeline = ShaderManager::pipeline(cubeVertStage_, fragStage);
+    ShaderReflection* vertUniforms = ShaderManager::reflection(cubeVertStage_);
+    ShaderReflection* fragUniforms = ShaderManager::reflection(fragStage);
+    if (!pipeline || vertUniforms == nullptr || fragUniforms == nullptr)
+    {
+        return;
+    }
+
+    // A bound program takes precedence over the pipeline
+    glUseProgram(0);
+    glBindProgramPipeline(pipeline.value());
+
+    // Uniform setters target the active stage program
+    glActiveShaderProgram(pipeline.value(), cubeVertStage_);
+    vertUniforms->set("uMVP", draw.transform);
+    glActiveShaderProgram(pipeline.value(), fragStage);
+    fragUniforms->set("uColor", draw.color);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textures_.texture(texture_));
+    fragUniforms->set("uTexture", 0);
+
+    glBindVertexArray(vao_);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(CUBE_INDICES.size()), GL_UNSIGNED_INT,
+                   nullptr);
+    glBindVertexArray(0);
+    glBindProgramPipeline(0);
+#endif
 }
 
 } // namespace vibegl
@@ -4,21 +4,18 @@
 /// Demo application showing a rotating textured cube.
 
 #include "core/Application.hpp"
+#include "rendering/PipelineWarmup.hpp"
+#include "rendering/ShaderLibrary.hpp"
+#include "rendering/TextureStreamer.hpp"
 #include <array>
+#include <cstdint>
 
 namespace vibegl {
 
-/// Cached uniform locations for shader program efficiency.
-struct ShaderLocations {
-    GLint mvp = -1;
-    GLint color = -1;
-    GLint texture = -1;
-};
-
 /// Demo application with rotating textured cube and ImGui controls.
 class VibeGLApp : public Application {
 public:
-    VibeGLApp();
+    explicit VibeGLApp(const WindowConfig& config = WindowConfig{});
     ~VibeGLApp() override;
 
     // Non-copyable, non-movable
@@ -29,29 +26,44 @@ public:
 
 protected:
     void onInit() override;
-    void onTick(float deltaTime) override;
+    void onWarmup() override;
+    void onFixedUpdate(double fixedDeltaTime) override;
+    void onUpdate(float deltaTime, FramePacket& packet) override;
+    void onRender(const FramePacket& packet) override;
     void onShutdown() override;
 
 private:
     void setupCubeGeometry();
-    void renderCube();
-    void renderUI();
+    void buildScene(FramePacket& packet) const;
+    void buildUI();
+    void renderCube(const DrawCommand& draw);
+    void setupSeparableStages();
+    void renderCubeSeparable(const DrawCommand& draw);
 
     // OpenGL resources
-    GLuint shaderProgram_ = 0;
-    GLuint texture_ = 0;
+    ShaderLibrary shaders_;
+    PipelineWarmup warmup_{shaders_};
+    ShaderHandle cubeShader_;
+    ShaderFeatures texturedFeature_ = 0;
+    std::uint32_t cubeLayout_ = 0;  ///< Warm-up layout index of the cube vertices
+    TextureStreamer textures_{getJobSystem()};
+    TextureHandle texture_;
     GLuint vao_ = 0;
     GLuint vbo_ = 0;
     GLuint ebo_ = 0;
 
-    // Cached shader uniform locations
-    ShaderLocations shaderLocations_;
+    // Separable stages of the cube shader (desktop only; 0 where unavailable)
+    GLuint cubeVertStage_ = 0;
+    std::array<GLuint, 2> cubeFragStages_ = {};  ///< Untextured, textured
 
-    // Animation state
+    // Animation state (advanced in fixed steps, interpolated for rendering)
     float rotationAngle_ = 0.0f;
+    float previousRotationAngle_ = 0.0f;
     float rotationVelocity_ = 45.0f;
     std::array<float, 3> rotationAxis_ = {0.5f, 1.0f, 0.0f};
     std::array<float, 3> cubeColor_ = {1.0f, 1.0f, 1.0f};
+    bool textured_ = true;
+    bool separable_ = false;  ///< Draw through a program pipeline instead of a linked variant
 };
 
 } // namespace vibegl
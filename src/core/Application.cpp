@@ -1,6 +1,11 @@
 #include "Application.hpp"
 
+#include "AssetPath.hpp"
+#include "FramePacket.hpp"
+#include "GpuProfiler.hpp"
 #include "Platform.hpp"
+#include "Profiler.hpp"
+#include "ProfilerOverlay.hpp"
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
@@ -12,13 +17,39 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <cmath>
+#include <exception>
 #include <stdexcept>
 
 namespace vibegl
 {
 
-Application::Application(const WindowConfig& config) : assetBasePath_(config.assetBasePath)
+Application::Application(const WindowConfig& config)
+    : fixedTimestep_(config.fixedTimestep), maxFixedSteps_(config.maxFixedSteps),
+      assetBasePath_(config.assetBasePath), headless_(config.headless && kIsDesktop),
+      headlessReadback_(config.headlessReadback), maxFrames_(config.maxFrames),
+      threadedRendering_(config.threadedRendering && kIsDesktop),
+      framePackets_(static_cast<std::size_t>(std::clamp(config.framePackets, 2, 3))),
+      renderMode_(kIsDesktop && !config.headless ? config.renderMode : RenderMode::Continuous),
+      idleTimeout_(config.idleTimeout > 0.0 ? config.idleTimeout : 1.0),
+      mainThreadId_(std::this_thread::get_id()),
+      maxFramesInFlight_(static_cast<std::size_t>(
+          std::clamp(config.maxFramesInFlight, 1, static_cast<int>(kMaxFramesInFlight)))),
+      workerThreads_(kIsDesktop ? config.workerThreads : 0),
+      frameArenaSize_(config.frameArenaSize)
 {
+    Profiler::setEventsPerThread(config.profilerEventsPerThread);
+    Profiler::setThreadName("Main");
+
+    if (!(fixedTimestep_ > 0.0) || maxFixedSteps_ < 1)
+    {
+        spdlog::warn("Invalid fixed timestep settings ({} s, {} steps); using 1/60 s, 5 steps",
+                     fixedTimestep_, maxFixedSteps_);
+        fixedTimestep_ = 1.0 / 60.0;
+        maxFixedSteps_ = 5;
+    }
+
     if (!initWindow(config))
     {
         throw std::runtime_error("Failed to initialize window");
@@ -31,15 +62,27 @@ Application::Application(const WindowConfig& config) : assetBasePath_(config.ass
         throw std::runtime_error("Failed to initialize OpenGL");
     }
 
+    if (headless_ && !initOffscreenTarget(config.width, config.height))
+    {
+        glfwDestroyWindow(window_);
+        glfwTerminate();
+        throw std::runtime_error("Failed to create offscreen render target");
+    }
+
+    GpuProfiler::init();
     initImGui();
     initialized_ = true;
 }
 
 Application::~Application()
 {
+    stopRenderThread();
     if (initialized_)
     {
         shutdownImGui();
+        GpuProfiler::shutdown();
+        destroyFrameFences();
+        destroyOffscreenTarget();
     }
     if (window_ != nullptr)
     {
@@ -50,6 +93,15 @@ Application::~Application()
 
 bool Application::initWindow(const WindowConfig& config)
 {
+#ifndef __EMSCRIPTEN__
+    // Headless runs must not need a display server: GLFW's null platform creates no
+    // native windows and gets its context from EGL (Mesa surfaceless) or OSMesa
+    if (headless_ && glfwPlatformSupported(GLFW_PLATFORM_NULL) == GLFW_TRUE)
+    {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    }
+#endif
+
     if (glfwInit() == GLFW_FALSE)
     {
         spdlog::error("Failed to initialize GLFW");
@@ -68,7 +120,27 @@ bool Application::initWindow(const WindowConfig& config)
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 #endif
 
-    window_ = glfwCreateWindow(config.width, config.height, config.title.c_str(), nullptr, nullptr);
+    if (headless_)
+    {
+#ifndef __EMSCRIPTEN__
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        for (int contextApi : {GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API})
+        {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, contextApi);
+            window_ = glfwCreateWindow(config.width, config.height, config.title.c_str(),
+                                       nullptr, nullptr);
+            if (window_ != nullptr)
+            {
+                break;
+            }
+        }
+#endif
+    }
+    else
+    {
+        window_ = glfwCreateWindow(config.width, config.height, config.title.c_str(), nullptr,
+                                   nullptr);
+    }
     if (window_ == nullptr)
     {
         spdlog::error("Failed to create GLFW window");
@@ -81,15 +153,16 @@ bool Application::initWindow(const WindowConfig& config)
     // Set up callbacks
     glfwSetWindowUserPointer(window_, this);
 
-    // Set up framebuffer size callback to update cached dimensions
+    // Set up framebuffer size callback to update cached dimensions. The viewport is
+    // applied by the rendering thread, which may not be this one.
     glfwSetFramebufferSizeCallback(window_,
                                    [](GLFWwindow* win, int width, int height)
                                    {
-                                       glViewport(0, 0, width, height);
                                        auto* app =
                                            static_cast<Application*>(glfwGetWindowUserPointer(win));
                                        app->framebufferWidth_ = width;
                                        app->framebufferHeight_ = height;
+                                       app->markInput();
                                    });
 
     // Initialize cached dimensions
@@ -98,20 +171,127 @@ bool Application::initWindow(const WindowConfig& config)
     glfwSetKeyCallback(window_,
                        [](GLFWwindow* win, int key, int /*scancode*/, int action, int /*mods*/)
                        {
+                           static_cast<Application*>(glfwGetWindowUserPointer(win))->markInput();
                            if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
                            {
                                glfwSetWindowShouldClose(win, GLFW_TRUE);
                            }
+                           if (key == GLFW_KEY_F12 && action == GLFW_PRESS)
+                           {
+                               auto* app =
+                                   static_cast<Application*>(glfwGetWindowUserPointer(win));
+                               app->traceRequested_ = true;
+                           }
                        });
 
-    if (config.vsync)
+    // Installed before ImGui, whose GLFW backend chains to these callbacks
+    installInputCallbacks();
+
+    applyPresentMode(config.presentMode);
+
+    return true;
+}
+
+void Application::installInputCallbacks()
+{
+    static constexpr auto kMarkInput = [](GLFWwindow* win)
+    { static_cast<Application*>(glfwGetWindowUserPointer(win))->markInput(); };
+
+    glfwSetCursorPosCallback(window_, [](GLFWwindow* win, double /*x*/, double /*y*/)
+                             { kMarkInput(win); });
+    glfwSetMouseButtonCallback(window_,
+                               [](GLFWwindow* win, int /*button*/, int /*action*/, int /*mods*/)
+                               { kMarkInput(win); });
+    glfwSetScrollCallback(window_, [](GLFWwindow* win, double /*x*/, double /*y*/)
+                          { kMarkInput(win); });
+    glfwSetCharCallback(window_, [](GLFWwindow* win, unsigned int /*codepoint*/)
+                        { kMarkInput(win); });
+    glfwSetCursorEnterCallback(window_, [](GLFWwindow* win, int /*entered*/)
+                               { kMarkInput(win); });
+    glfwSetWindowFocusCallback(window_, [](GLFWwindow* win, int /*focused*/)
+                               { kMarkInput(win); });
+    glfwSetWindowRefreshCallback(window_, [](GLFWwindow* win) { kMarkInput(win); });
+}
+
+void Application::markInput()
+{
+    // ImGui needs a second frame to settle hover/active state after an event
+    constexpr int kFramesPerInput = 2;
+    int pending = redrawFrames_.load(std::memory_order_relaxed);
+    while (pending < kFramesPerInput &&
+           !redrawFrames_.compare_exchange_weak(pending, kFramesPerInput,
+                                                std::memory_order_relaxed))
     {
-        glfwSwapInterval(1);
     }
+}
 
+void Application::requestRedraw()
+{
+    if (renderMode_ != RenderMode::OnDemand)
+    {
+        return;
+    }
+    int pending = redrawFrames_.load(std::memory_order_relaxed);
+    while (pending < 1 &&
+           !redrawFrames_.compare_exchange_weak(pending, 1, std::memory_order_relaxed))
+    {
+    }
+    if (std::this_thread::get_id() != mainThreadId_)
+    {
+        // Wake the main loop if it is sleeping in glfwWaitEventsTimeout()
+        glfwPostEmptyEvent();
+    }
+}
+
+bool Application::waitForRedraw()
+{
+    if (redrawFrames_.load(std::memory_order_relaxed) == 0)
+    {
+        VIBEGL_PROFILE_SCOPE("waitForRedraw");
+        // A focused text field keeps its caret blinking at roughly ImGui's blink rate
+        constexpr double kCaretBlinkSeconds = 0.4;
+        glfwWaitEventsTimeout(uiTextInput_ ? std::min(kCaretBlinkSeconds, idleTimeout_)
+                                           : idleTimeout_);
+        if (redrawFrames_.load(std::memory_order_relaxed) == 0 && !uiTextInput_)
+        {
+            return false;
+        }
+        // Resuming from idle: the sleep is not simulation time
+        lastFrameTime_ = glfwGetTime();
+    }
+
+    int pending = redrawFrames_.load(std::memory_order_relaxed);
+    while (pending > 0 &&
+           !redrawFrames_.compare_exchange_weak(pending, pending - 1, std::memory_order_relaxed))
+    {
+    }
     return true;
 }
 
+void Application::applyPresentMode(PresentMode mode)
+{
+    int interval = 1;
+    if (mode == PresentMode::Immediate)
+    {
+        interval = 0;
+    }
+    else if (mode == PresentMode::Adaptive)
+    {
+        // Negative intervals need the swap-control-tear extension
+        if (glfwExtensionSupported("GLX_EXT_swap_control_tear") == GLFW_TRUE ||
+            glfwExtensionSupported("WGL_EXT_swap_control_tear") == GLFW_TRUE)
+        {
+            interval = -1;
+        }
+        else
+        {
+            spdlog::warn("Adaptive present mode not supported; using vsync");
+        }
+    }
+    glfwSwapInterval(interval);
+    spdlog::info("Swap interval: {}", interval);
+}
+
 bool Application::initOpenGL()
 {
 #ifndef __EMSCRIPTEN__
@@ -123,6 +303,7 @@ bool Application::initOpenGL()
     }
 #endif
 
+    spdlog::info("OpenGL Renderer: {}", reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
     spdlog::info("OpenGL Version: {}", reinterpret_cast<const char*>(glGetString(GL_VERSION)));
     spdlog::info("GLSL Version: {}",
                  reinterpret_cast<const char*>(glGetString(GL_SHADING_LANGUAGE_VERSION)));
@@ -130,6 +311,60 @@ bool Application::initOpenGL()
     return true;
 }
 
+bool Application::initOffscreenTarget(int width, int height)
+{
+    glGenFramebuffers(1, &offscreenFbo_);
+    glGenRenderbuffers(1, &offscreenColor_);
+    glGenRenderbuffers(1, &offscreenDepth_);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, offscreenColor_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, offscreenDepth_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, offscreenFbo_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+                              offscreenColor_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER,
+                              offscreenDepth_);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        spdlog::error("Offscreen framebuffer is incomplete ({}x{})", width, height);
+        destroyOffscreenTarget();
+        return false;
+    }
+
+    // The FBO stays bound for the lifetime of the application
+    glViewport(0, 0, width, height);
+    framebufferWidth_ = width;
+    framebufferHeight_ = height;
+    if (headlessReadback_)
+    {
+        readbackPixels_.resize(static_cast<std::size_t>(width) * static_cast<std::size_t>(height) *
+                               4);
+    }
+
+    spdlog::info("Headless mode: rendering offscreen at {}x{}", width, height);
+    return true;
+}
+
+void Application::destroyOffscreenTarget()
+{
+    if (offscreenFbo_ == 0)
+    {
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &offscreenFbo_);
+    glDeleteRenderbuffers(1, &offscreenColor_);
+    glDeleteRenderbuffers(1, &offscreenDepth_);
+    offscreenFbo_ = 0;
+    offscreenColor_ = 0;
+    offscreenDepth_ = 0;
+}
+
 void Application::initImGui()
 {
     IMGUI_CHECKVERSION();
@@ -143,6 +378,9 @@ void Application::initImGui()
 
     ImGui_ImplGlfw_InitForOpenGL(window_, true);
     ImGui_ImplOpenGL3_Init(kGLSLVersionString);
+
+    // Create the renderer's device objects now, while this thread still owns the context
+    ImGui_ImplOpenGL3_NewFrame();
 }
 
 void Application::shutdownImGui()
@@ -155,7 +393,15 @@ void Application::shutdownImGui()
 void Application::run()
 {
     spdlog::info("Entering main loop");
+    jobSystem_.start(workerThreads_);
+    spdlog::info("Job system running on {} thread(s)", jobSystem_.threadCount());
+    frameArena_ = std::make_unique<FrameArena>(jobSystem_, frameArenaSize_);
     onInit();
+    {
+        VIBEGL_PROFILE_SCOPE("onWarmup");
+        onWarmup();
+    }
+    lastFrameTime_ = glfwGetTime();
 
 #ifdef __EMSCRIPTEN__
     // Emscripten: browser controls the main loop via requestAnimationFrame
@@ -163,24 +409,245 @@ void Application::run()
     // Note: emscripten_set_main_loop_arg does not return when simulate_infinite_loop=1
 #else
     // Desktop: traditional main loop
+    const double startTime = glfwGetTime();
+    if (threadedRendering_)
+    {
+        startRenderThread(framePackets_);
+    }
     while (!shouldQuit())
     {
         tick();
     }
+    stopRenderThread();
+
+    if (headless_)
+    {
+        const double elapsed = glfwGetTime() - startTime;
+        spdlog::info("Rendered {} frames in {:.3f} s ({:.1f} fps)", frameCount_, elapsed,
+                     elapsed > 0.0 ? static_cast<double>(frameCount_) / elapsed : 0.0);
+    }
 
     spdlog::info("Shutting down...");
+    // Let in-flight jobs finish before the resources they use are released
+    jobSystem_.drain();
     onShutdown();
+    frameArena_.reset();
+    jobSystem_.stop();
 #endif
 }
 
 void Application::tick()
 {
-    auto currentTime = static_cast<float>(glfwGetTime());
-    float deltaTime = currentTime - lastFrameTime_;
+    if (renderMode_ == RenderMode::OnDemand && !waitForRedraw())
+    {
+        return;
+    }
+
+    Profiler::markFrame();
+    VIBEGL_PROFILE_SCOPE("Application::tick");
+    frameArena_->reset();
+    ++frameCount_;
+
+    const double currentTime = glfwGetTime();
+    const double deltaTime = currentTime - lastFrameTime_;
     lastFrameTime_ = currentTime;
 
-    glfwPollEvents();
-    onTick(deltaTime);
+    {
+        VIBEGL_PROFILE_SCOPE("glfwPollEvents");
+        glfwPollEvents();
+    }
+
+    {
+        VIBEGL_PROFILE_SCOPE("onFixedUpdate");
+        accumulator_ += deltaTime;
+        int steps = 0;
+        while (accumulator_ >= fixedTimestep_ && steps < maxFixedSteps_)
+        {
+            onFixedUpdate(fixedTimestep_);
+            accumulator_ -= fixedTimestep_;
+            simulationTime_ += fixedTimestep_;
+            ++steps;
+        }
+        if (accumulator_ >= fixedTimestep_)
+        {
+            // Too far behind (breakpoint, long load): drop the backlog instead of spiraling
+            accumulator_ = std::fmod(accumulator_, fixedTimestep_);
+        }
+        interpolationAlpha_ = accumulator_ / fixedTimestep_;
+    }
+
+    if (traceRequested_)
+    {
+        traceRequested_ = false;
+        writeTrace();
+    }
+
+    if (isRenderThreaded())
+    {
+        FramePacket* packet = nullptr;
+        {
+            // Blocks only while the render thread is a full queue behind
+            VIBEGL_PROFILE_SCOPE("waitForFramePacket");
+            packet = packets_->acquireForBuild();
+        }
+        if (packet != nullptr)
+        {
+            buildFrame(static_cast<float>(deltaTime), *packet);
+            packets_->publish(packet);
+        }
+        return;
+    }
+
+    GpuProfiler::beginFrame();
+    applyViewport(framebufferWidth_, framebufferHeight_);
+    {
+        VIBEGL_PROFILE_SCOPE("onTick");
+        onTick(static_cast<float>(deltaTime));
+    }
+}
+
+void Application::onTick(float deltaTime)
+{
+    buildFrame(deltaTime, localPacket_);
+    renderFrame(localPacket_);
+}
+
+void Application::onUpdate(float /*deltaTime*/, FramePacket& /*packet*/) {}
+
+void Application::onRender(const FramePacket& /*packet*/) {}
+
+void Application::buildFrame(float deltaTime, FramePacket& packet)
+{
+    VIBEGL_PROFILE_SCOPE("buildFrame");
+
+    packet.frameIndex = frameCount_;
+    packet.deltaTime = deltaTime;
+    packet.interpolationAlpha = interpolationAlpha_;
+    packet.framebufferWidth = framebufferWidth_;
+    packet.framebufferHeight = framebufferHeight_;
+    packet.draws.clear();
+
+    if (uiSyncFrame_ != 0)
+    {
+        // ImGui font/texture updates must be applied before the context moves on
+        VIBEGL_PROFILE_SCOPE("waitForUiTextures");
+        packets_->waitForRendered(uiSyncFrame_);
+        uiSyncFrame_ = 0;
+    }
+
+    ImGui_ImplGlfw_NewFrame();
+    ImGui::NewFrame();
+    {
+        VIBEGL_PROFILE_SCOPE("onUpdate");
+        onUpdate(deltaTime, packet);
+    }
+    if (renderMode_ == RenderMode::OnDemand)
+    {
+        // Keep rendering while a widget is dragged, a window moved or text edited
+        if (ImGui::IsAnyItemActive())
+        {
+            requestRedraw();
+        }
+        uiTextInput_ = ImGui::GetIO().WantTextInput;
+    }
+    ImGui::Render();
+
+    if (isRenderThreaded())
+    {
+        packet.ui.capture(ImGui::GetDrawData());
+        packet.uiDrawData = packet.ui.get();
+        if (packet.ui.hasTextureUpdates())
+        {
+            uiSyncFrame_ = packet.frameIndex;
+        }
+    }
+    else
+    {
+        packet.uiDrawData = ImGui::GetDrawData();
+    }
+}
+
+void Application::renderFrame(const FramePacket& packet)
+{
+    VIBEGL_PROFILE_SCOPE("renderFrame");
+    {
+        VIBEGL_PROFILE_SCOPE("onRender");
+        onRender(packet);
+    }
+
+    if (packet.uiDrawData != nullptr)
+    {
+        VIBEGL_PROFILE_SCOPE("renderImGui");
+        VIBEGL_GPU_PROFILE_SCOPE("ImGui");
+        ImGui_ImplOpenGL3_NewFrame();
+        ImGui_ImplOpenGL3_RenderDrawData(packet.uiDrawData);
+    }
+
+    endFrame();
+}
+
+void Application::applyViewport(int width, int height)
+{
+    if (width != viewportWidth_ || height != viewportHeight_)
+    {
+        glViewport(0, 0, width, height);
+        viewportWidth_ = width;
+        viewportHeight_ = height;
+    }
+}
+
+void Application::startRenderThread(std::size_t packetCount)
+{
+    packets_ = std::make_unique<FramePacketQueue>(packetCount);
+    glfwMakeContextCurrent(nullptr);
+    renderThread_ = std::thread(&Application::renderThreadMain, this);
+    spdlog::info("Rendering on a dedicated thread ({} frame packets)", packetCount);
+}
+
+void Application::stopRenderThread()
+{
+    if (!renderThread_.joinable())
+    {
+        return;
+    }
+    packets_->close();
+    renderThread_.join();
+    glfwMakeContextCurrent(window_);
+}
+
+void Application::renderThreadMain()
+{
+    Profiler::setThreadName("Render");
+    glfwMakeContextCurrent(window_);
+
+    while (FramePacket* packet = packets_->acquireForRender())
+    {
+        GpuProfiler::beginFrame();
+        applyViewport(packet->framebufferWidth, packet->framebufferHeight);
+        try
+        {
+            renderFrame(*packet);
+        }
+        catch (const std::exception& e)
+        {
+            spdlog::error("Render thread error: {}", e.what());
+            glfwSetWindowShouldClose(window_, GLFW_TRUE);
+        }
+        packets_->release(packet);
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
+
+void Application::writeTrace()
+{
+    auto result = Profiler::writeChromeTrace(kDefaultTracePath);
+    if (!result)
+    {
+        spdlog::error("{} - {}", result.error().message, result.error().context);
+        return;
+    }
+    spdlog::info("Wrote Chrome trace: {}", kDefaultTracePath);
 }
 
 void Application::emscriptenMainLoop(void* arg)
@@ -191,6 +658,10 @@ void Application::emscriptenMainLoop(void* arg)
 
 bool Application::shouldQuit() const
 {
+    if (maxFrames_ != 0 && frameCount_ >= maxFrames_)
+    {
+        return true;
+    }
     return glfwWindowShouldClose(window_) != 0;
 }
 
@@ -217,16 +688,71 @@ float Application::getAspectRatio() const
 
 std::string Application::resolvePath(const std::string& relativePath) const
 {
-    if (assetBasePath_.empty())
+    return resolveAssetPath(assetBasePath_, relativePath);
+}
+
+void Application::endFrame()
+{
+    VIBEGL_PROFILE_SCOPE("endFrame");
+    if (!headless_)
+    {
+        glfwSwapBuffers(window_);
+    }
+    else if (headlessReadback_)
     {
-        return relativePath;
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, framebufferWidth_, framebufferHeight_, GL_RGBA, GL_UNSIGNED_BYTE,
+                     readbackPixels_.data());
     }
-    return assetBasePath_ + relativePath;
+    else
+    {
+        // No swap to throttle us: keep the command queue moving
+        glFlush();
+    }
+
+    limitFramesInFlight();
 }
 
-void Application::endFrame()
+void Application::limitFramesInFlight()
+{
+#ifndef __EMSCRIPTEN__
+    // The browser paces frames itself, and WebGL forbids blocking client waits
+    frameFences_[frameFenceIndex_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frameFenceIndex_ = (frameFenceIndex_ + 1) % maxFramesInFlight_;
+
+    // The slot we will write next holds the oldest frame still allowed in flight
+    GLsync& oldest = frameFences_[frameFenceIndex_];
+    if (oldest == nullptr)
+    {
+        return;
+    }
+
+    VIBEGL_PROFILE_SCOPE("waitForGpu");
+    constexpr GLuint64 kWaitTimeoutNs = 100'000'000;
+    GLenum status = GL_TIMEOUT_EXPIRED;
+    while (status == GL_TIMEOUT_EXPIRED)
+    {
+        status = glClientWaitSync(oldest, GL_SYNC_FLUSH_COMMANDS_BIT, kWaitTimeoutNs);
+    }
+    if (status == GL_WAIT_FAILED)
+    {
+        spdlog::warn("glClientWaitSync failed; frames in flight are not limited");
+    }
+    glDeleteSync(oldest);
+    oldest = nullptr;
+#endif
+}
+
+void Application::destroyFrameFences()
 {
-    glfwSwapBuffers(window_);
+    for (GLsync& fence : frameFences_)
+    {
+        if (fence != nullptr)
+        {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
 }
 
 } // namespace vibegl
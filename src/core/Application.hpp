@@ -3,27 +3,73 @@
 /// @file
 /// Base application class with platform-abstracted main loop.
 
+#include "FrameArena.hpp"
+#include "FramePacket.hpp"
 #include "GLIncludes.hpp"
+#include "JobSystem.hpp"
+#include "Profiler.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace vibegl {
 
+/// How finished frames are presented.
+enum class PresentMode {
+    Vsync,     ///< Wait for vertical blank (swap interval 1)
+    Adaptive,  ///< Sync when on time, tear when late (swap interval -1, falls back to Vsync)
+    Immediate  ///< Never wait for vertical blank (swap interval 0, may tear)
+};
+
+/// When the main loop produces frames.
+enum class RenderMode {
+    Continuous,  ///< Render every iteration (paced by the present mode)
+    OnDemand     ///< Sleep in glfwWaitEventsTimeout() until input or requestRedraw()
+};
+
 /// Configuration for creating an Application window.
 struct WindowConfig {
     std::string title = "VibeGL";  ///< Window title displayed in title bar
     int width = 1280;               ///< Initial window width in pixels
     int height = 720;               ///< Initial window height in pixels
-    bool vsync = true;              ///< Enable vertical synchronization
+    PresentMode presentMode = PresentMode::Vsync;  ///< Swap interval policy
+    int maxFramesInFlight = 2;  ///< Frames submitted but not finished by the GPU (1-3)
+    RenderMode renderMode = RenderMode::Continuous;  ///< Desktop windows only
+    double idleTimeout = 1.0;  ///< Longest sleep between event checks in OnDemand mode (s)
     std::string assetBasePath = "";  ///< Base path for assets (empty = current directory)
+    bool headless = false;          ///< Render offscreen into an FBO without a visible window
+    bool headlessReadback = false;  ///< Read the offscreen FBO back in endFrame() (headless only)
+    std::uint64_t maxFrames = 0;    ///< Stop after this many frames (0 = run until closed)
+    double fixedTimestep = 1.0 / 60.0;  ///< Simulation step for onFixedUpdate() in seconds
+    int maxFixedSteps = 5;              ///< Max fixed steps per frame before dropping time
+    bool threadedRendering = false;  ///< Render on a dedicated thread owning the GL context
+    int framePackets = 2;            ///< Packets in flight (2 = double, 3 = triple buffered)
+    int workerThreads = -1;          ///< Job worker threads (-1 = cores - 1, 0 = main only)
+    std::size_t frameArenaSize = 1024 * 1024;  ///< Frame arena bytes per job thread
+    std::size_t profilerEventsPerThread = Profiler::kDefaultEventsPerThread;  ///< Zone history
 };
 
 /// Base class for applications with platform-abstracted main loop.
 ///
 /// Derive from this class and implement onInit(), onTick(), and onShutdown().
+/// Simulation that must advance at a stable rate goes in onFixedUpdate(), which runs
+/// zero or more times per frame with a constant step; onTick() renders once per frame
+/// and can blend simulation states with getInterpolationAlpha().
 /// The run() method handles the platform-specific main loop:
 /// - Desktop: Traditional while loop
 /// - Web: emscripten_set_main_loop callback
 ///
+/// Instead of overriding onTick(), a frame can be split into onUpdate(), which fills a
+/// FramePacket (and builds the ImGui UI), and onRender(), which draws that packet.
+/// With WindowConfig::threadedRendering the two run on separate threads: the main
+/// thread polls events and builds frame N+1 while a render thread, which owns the GL
+/// context, submits and swaps frame N.
+///
 /// Example:
 /// ```cpp
 /// class MyApp : public Application {
@@ -59,9 +105,31 @@ protected:
     /// Called once after window and OpenGL context are ready.
     virtual void onInit() {}
 
+    /// Called once after onInit(), before the first frame, on the thread owning the GL
+    /// context. Issue warm-up draws here (see PipelineWarmup) so drivers finish deferred
+    /// compilation at load time; the time spent does not count as a frame.
+    virtual void onWarmup() {}
+
+    /// Called at a fixed rate (WindowConfig::fixedTimestep) before onTick().
+    /// @param fixedDeltaTime Constant simulation step in seconds
+    virtual void onFixedUpdate(double fixedDeltaTime) { static_cast<void>(fixedDeltaTime); }
+
     /// Called every frame with delta time in seconds.
+    /// The default implementation builds the frame with onUpdate() and draws it with
+    /// onRender(). Overrides must call endFrame() and cannot use threaded rendering.
+    /// @param deltaTime Time elapsed since last frame
+    virtual void onTick(float deltaTime);
+
+    /// Update application state and describe the frame (main thread).
+    /// Runs inside an ImGui frame, so UI widgets can be built here.
     /// @param deltaTime Time elapsed since last frame
-    virtual void onTick(float deltaTime) = 0;
+    /// @param packet Packet to fill; its draw list is cleared beforehand
+    virtual void onUpdate(float deltaTime, FramePacket& packet);
+
+    /// Issue the GL commands for a packet (thread owning the GL context).
+    /// Must only read the packet and GL resources created in onInit().
+    /// @param packet Packet filled by onUpdate()
+    virtual void onRender(const FramePacket& packet);
 
     /// Called once before application exits (desktop only).
     virtual void onShutdown() {}
@@ -76,14 +144,52 @@ protected:
     int getWindowHeight() const;
     float getAspectRatio() const;
 
+    /// Fraction of a fixed step accumulated but not yet simulated, in [0, 1).
+    /// Blend previous and current simulation state with this value when rendering.
+    double getInterpolationAlpha() const { return interpolationAlpha_; }
+
+    /// Fixed simulation step in seconds.
+    double getFixedTimestep() const { return fixedTimestep_; }
+
+    /// Total simulated time in seconds (advances in fixed steps).
+    double getSimulationTime() const { return simulationTime_; }
+
+    /// Job scheduler, running from before onInit() until after onShutdown().
+    JobSystem& getJobSystem() { return jobSystem_; }
+
+    /// Scratch allocator reset at the start of every tick (see FrameArena).
+    /// Available from onInit() until onShutdown() returns.
+    FrameArena& getFrameArena() { return *frameArena_; }
+
+    /// Ask for another frame in RenderMode::OnDemand (no-op in Continuous mode).
+    /// Call every frame while an animation runs. Safe to call from any thread.
+    void requestRedraw();
+
+    /// Check if frames are rendered on a dedicated render thread.
+    bool isRenderThreaded() const { return renderThread_.joinable(); }
+
+    /// Check if the application renders offscreen without a visible window.
+    bool isHeadless() const { return headless_; }
+
+    /// Number of frames started since run() was called.
+    std::uint64_t getFrameCount() const { return frameCount_; }
+
+    /// RGBA8 pixels of the last frame, bottom row first (headless readback only).
+    const std::vector<std::uint8_t>& getReadbackPixels() const { return readbackPixels_; }
+
     /// Resolve asset path relative to configured base path.
     /// @param relativePath Path relative to asset base (e.g., "shaders/cube_gl46.vert")
     /// @return Full path with base path prepended
     std::string resolvePath(const std::string& relativePath) const;
 
-    /// Swap buffers and poll events (call at end of onTick).
+    /// Swap buffers (call at end of onTick).
+    /// In headless mode this flushes the GL pipeline and optionally reads the frame back.
+    /// Blocks while more than WindowConfig::maxFramesInFlight frames are queued on the GPU.
     void endFrame();
 
+    /// Maximum number of fence slots (WindowConfig::maxFramesInFlight is clamped to it).
+    static constexpr std::size_t kMaxFramesInFlight = 3;
+
 private:
     /// Initialize GLFW and create window.
     bool initWindow(const WindowConfig& config);
@@ -91,6 +197,21 @@ private:
     /// Initialize OpenGL loader (GLAD on desktop).
     bool initOpenGL();
 
+    /// Set the swap interval for the current context.
+    static void applyPresentMode(PresentMode mode);
+
+    /// Block until at most maxFramesInFlight_ - 1 earlier frames are still on the GPU.
+    void limitFramesInFlight();
+
+    /// Delete outstanding frame fences.
+    void destroyFrameFences();
+
+    /// Create the FBO used as render target in headless mode.
+    bool initOffscreenTarget(int width, int height);
+
+    /// Delete the headless FBO and its attachments.
+    void destroyOffscreenTarget();
+
     /// Initialize ImGui with GLFW and OpenGL backends.
     void initImGui();
 
@@ -100,15 +221,85 @@ private:
     /// Internal tick function called by main loop.
     void tick();
 
+    /// Sleep until a frame is needed (RenderMode::OnDemand).
+    /// @return true if a frame should be rendered now
+    bool waitForRedraw();
+
+    /// Record that user input arrived, so the next frames reflect it.
+    void markInput();
+
+    /// Install GLFW input callbacks that wake on-demand rendering.
+    void installInputCallbacks();
+
+    /// Fill a packet: start an ImGui frame, call onUpdate(), capture the UI draw data.
+    void buildFrame(float deltaTime, FramePacket& packet);
+
+    /// Draw a packet: call onRender(), draw the UI, then endFrame().
+    void renderFrame(const FramePacket& packet);
+
+    /// Set the GL viewport if the framebuffer size changed (rendering thread).
+    void applyViewport(int width, int height);
+
+    /// Hand the GL context to a new render thread.
+    void startRenderThread(std::size_t packetCount);
+
+    /// Join the render thread and make the GL context current on this thread again.
+    void stopRenderThread();
+
+    /// Render thread entry point: draw published packets until the queue closes.
+    void renderThreadMain();
+
+    /// Dump the profiler history to kDefaultTracePath.
+    void writeTrace();
+
     /// Static callback for Emscripten main loop.
     static void emscriptenMainLoop(void* arg);
 
     GLFWwindow* window_ = nullptr;
-    float lastFrameTime_ = 0.0f;
+    double lastFrameTime_ = 0.0;        ///< Clock value at the start of the previous frame
+    double accumulator_ = 0.0;          ///< Elapsed time not yet consumed by fixed steps
+    double interpolationAlpha_ = 0.0;   ///< accumulator_ / fixedTimestep_ after the fixed steps
+    double simulationTime_ = 0.0;       ///< Sum of all fixed steps taken
+    double fixedTimestep_ = 1.0 / 60.0; ///< WindowConfig::fixedTimestep
+    int maxFixedSteps_ = 5;             ///< WindowConfig::maxFixedSteps
     bool initialized_ = false;
+    bool traceRequested_ = false;  ///< Set by the F12 key, handled at the next frame boundary
     std::string assetBasePath_;  ///< Base path for asset loading
     int framebufferWidth_ = 0;   ///< Cached framebuffer width
     int framebufferHeight_ = 0;  ///< Cached framebuffer height
+
+    bool headless_ = false;                    ///< Rendering offscreen (WindowConfig::headless)
+    bool headlessReadback_ = false;            ///< Read back each headless frame in endFrame()
+    GLuint offscreenFbo_ = 0;                  ///< Headless render target
+    GLuint offscreenColor_ = 0;                ///< Headless color attachment (RGBA8)
+    GLuint offscreenDepth_ = 0;                ///< Headless depth attachment
+    std::vector<std::uint8_t> readbackPixels_;  ///< Last headless frame (when readback enabled)
+    std::uint64_t frameCount_ = 0;             ///< Frames started since run()
+    std::uint64_t maxFrames_ = 0;              ///< Frame limit (0 = unlimited)
+
+    bool threadedRendering_ = false;             ///< WindowConfig::threadedRendering
+    std::size_t framePackets_ = 2;               ///< WindowConfig::framePackets
+    FramePacket localPacket_;                    ///< Packet reused when rendering inline
+    std::unique_ptr<FramePacketQueue> packets_;  ///< Packets shared with the render thread
+    std::thread renderThread_;                   ///< Owns the GL context while running
+    std::uint64_t uiSyncFrame_ = 0;  ///< Frame whose ImGui texture updates must land first
+    int viewportWidth_ = 0;          ///< Last viewport applied on the rendering thread
+    int viewportHeight_ = 0;         ///< Last viewport applied on the rendering thread
+
+    RenderMode renderMode_ = RenderMode::Continuous;  ///< WindowConfig::renderMode
+    double idleTimeout_ = 1.0;                        ///< WindowConfig::idleTimeout
+    std::atomic<int> redrawFrames_{1};  ///< Frames still owed in OnDemand mode
+    bool uiTextInput_ = false;          ///< An ImGui text field is focused (caret blinks)
+    std::thread::id mainThreadId_;      ///< Thread running the main loop
+
+    std::size_t maxFramesInFlight_ = 2;  ///< WindowConfig::maxFramesInFlight
+    std::array<GLsync, kMaxFramesInFlight> frameFences_{};  ///< Fence per queued frame
+    std::size_t frameFenceIndex_ = 0;  ///< Slot receiving the next frame's fence
+
+    int workerThreads_ = -1;  ///< WindowConfig::workerThreads
+    JobSystem jobSystem_;     ///< Work-stealing scheduler shared by the application
+    std::size_t frameArenaSize_ = 0;          ///< WindowConfig::frameArenaSize
+    std::unique_ptr<FrameArena> frameArena_;  ///< Per-frame scratch memory
 };
 
 } // namespace vibegl
@@ -0,0 +1,26 @@
+#pragma once
+
+/// @file
+/// Asset path resolution shared by Application and tools that run without a window.
+
+#include <string>
+
+namespace vibegl {
+
+/// Resolve an asset path relative to a base path.
+/// @param basePath Base directory including trailing separator (empty = current directory)
+/// @param relativePath Path relative to the base (e.g., "shaders/cube_gl46.vert")
+/// @return Full path with base path prepended
+inline std::string resolveAssetPath(const std::string& basePath, const std::string& relativePath)
+{
+    if (basePath.empty())
+    {
+        return relativePath;
+    }
+    std::string path;
+    path.reserve(basePath.size() + relativePath.size());
+    path.append(basePath).append(relativePath);
+    return path;
+}
+
+} // namespace vibegl
@@ -0,0 +1,272 @@
+#include "FileWatcher.hpp"
+
+#include "Platform.hpp"
+#include "Profiler.hpp"
+
+#include <spdlog/spdlog.h>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#endif
+
+#include <algorithm>
+#include <system_error>
+
+namespace vibegl
+{
+
+FileWatcher::~FileWatcher()
+{
+    stop();
+}
+
+bool FileWatcher::isSupported()
+{
+    return kIsDesktop;
+}
+
+bool FileWatcher::start(Callback callback, Backend backend)
+{
+    if (isRunning())
+    {
+        return true;
+    }
+    if (!isSupported())
+    {
+        return false;
+    }
+
+    callback_ = std::move(callback);
+    quit_ = false;
+
+#ifdef __linux__
+    if (backend == Backend::Native)
+    {
+        openInotify();
+    }
+#else
+    static_cast<void>(backend);
+#endif
+
+    thread_ = std::thread(&FileWatcher::threadMain, this);
+    return true;
+}
+
+void FileWatcher::stop()
+{
+    if (!isRunning())
+    {
+        return;
+    }
+
+    {
+        const std::scoped_lock lock(mutex_);
+        quit_ = true;
+    }
+    wake_.notify_all();
+#ifdef __linux__
+    if (wakeFd_ >= 0)
+    {
+        const std::uint64_t one = 1;
+        static_cast<void>(write(wakeFd_, &one, sizeof(one)));
+    }
+#endif
+    thread_.join();
+
+#ifdef __linux__
+    if (inotifyFd_ >= 0)
+    {
+        close(inotifyFd_);
+        close(wakeFd_);
+    }
+    inotifyFd_ = -1;
+    wakeFd_ = -1;
+    directoryWatches_.clear();
+#endif
+}
+
+void FileWatcher::watch(const std::filesystem::path& file)
+{
+    std::error_code error;
+    const std::filesystem::path absolute =
+        std::filesystem::absolute(file, error).lexically_normal();
+    const std::filesystem::file_time_type modified = std::filesystem::last_write_time(file, error);
+
+    const std::scoped_lock lock(mutex_);
+    files_[absolute.string()] = WatchedFile{.path = file, .modified = modified};
+#ifdef __linux__
+    if (inotifyFd_ >= 0)
+    {
+        addDirectoryWatch(absolute.parent_path());
+    }
+#endif
+}
+
+void FileWatcher::threadMain()
+{
+    Profiler::setThreadName("FileWatch");
+#ifdef __linux__
+    if (inotifyFd_ >= 0)
+    {
+        inotifyLoop();
+        return;
+    }
+#endif
+    pollLoop();
+}
+
+void FileWatcher::dispatch(const std::vector<std::string>& changed)
+{
+    for (const std::string& absolute : changed)
+    {
+        std::filesystem::path path;
+        {
+            const std::scoped_lock lock(mutex_);
+            const auto it = files_.find(absolute);
+            if (it == files_.end())
+            {
+                continue;
+            }
+            path = it->second.path;
+        }
+        callback_(path);
+    }
+}
+
+void FileWatcher::pollLoop()
+{
+    std::vector<std::string> changed;
+    std::unique_lock lock(mutex_);
+    while (!wake_.wait_for(lock, kPollInterval, [this] { return quit_.load(); }))
+    {
+        changed.clear();
+        for (auto& [absolute, file] : files_)
+        {
+            std::error_code error;
+            const auto modified = std::filesystem::last_write_time(file.path, error);
+            if (!error && modified != file.modified)
+            {
+                file.modified = modified;
+                changed.push_back(absolute);
+            }
+        }
+
+        lock.unlock();
+        dispatch(changed);
+        lock.lock();
+    }
+}
+
+#ifdef __linux__
+void FileWatcher::openInotify()
+{
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (inotifyFd_ < 0 || wakeFd_ < 0)
+    {
+        spdlog::warn("inotify unavailable ({}); polling for file changes instead",
+                     std::error_code(errno, std::generic_category()).message());
+        if (inotifyFd_ >= 0)
+        {
+            close(inotifyFd_);
+        }
+        if (wakeFd_ >= 0)
+        {
+            close(wakeFd_);
+        }
+        inotifyFd_ = -1;
+        wakeFd_ = -1;
+    }
+    else
+    {
+        const std::scoped_lock lock(mutex_);
+        for (const auto& [absolute, file] : files_)
+        {
+            addDirectoryWatch(std::filesystem::path(absolute).parent_path());
+        }
+    }
+}
+
+void FileWatcher::addDirectoryWatch(const std::filesystem::path& directory)
+{
+    // Watching the directory also catches saves that replace the file by renaming
+    const int descriptor =
+        inotify_add_watch(inotifyFd_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (descriptor < 0)
+    {
+        spdlog::warn("Cannot watch {}: {}", directory.string(),
+                     std::error_code(errno, std::generic_category()).message());
+        return;
+    }
+    directoryWatches_[descriptor] = directory;
+}
+
+void FileWatcher::inotifyLoop()
+{
+    std::array<pollfd, 2> descriptors = {{{.fd = inotifyFd_, .events = POLLIN, .revents = 0},
+                                          {.fd = wakeFd_, .events = POLLIN, .revents = 0}}};
+    alignas(inotify_event) std::array<char, 4096> buffer{};
+    std::vector<std::string> changed;
+
+    while (!quit_)
+    {
+        // Block until something happens; once a change is pending, wait for the burst
+        // of events (truncate, write, close, rename) to settle before reporting it
+        const int timeout = changed.empty() ? -1 : static_cast<int>(kSettleTime.count());
+        const int ready = ::poll(descriptors.data(), descriptors.size(), timeout);
+        if (ready < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            spdlog::error("File watcher stopped: {}",
+                          std::error_code(errno, std::generic_category()).message());
+            return;
+        }
+        if (quit_)
+        {
+            return;
+        }
+        if (ready == 0)
+        {
+            dispatch(changed);
+            changed.clear();
+            continue;
+        }
+
+        ssize_t length = 0;
+        while ((length = read(inotifyFd_, buffer.data(), buffer.size())) > 0)
+        {
+            const std::scoped_lock lock(mutex_);
+            for (std::size_t offset = 0; offset < static_cast<std::size_t>(length);)
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+                offset += sizeof(inotify_event) + event->len;
+
+                const auto directory = directoryWatches_.find(event->wd);
+                if (event->len == 0 || directory == directoryWatches_.end())
+                {
+                    continue;
+                }
+                std::string absolute = (directory->second / event->name).string();
+                if (files_.contains(absolute) &&
+                    std::find(changed.begin(), changed.end(), absolute) == changed.end())
+                {
+                    changed.push_back(std::move(absolute));
+                }
+            }
+        }
+    }
+}
+#endif
+
+} // namespace vibegl
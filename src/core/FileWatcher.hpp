@@ -0,0 +1,97 @@
+#pragma once
+
+/// @file
+/// Background file change notifications.
+///
+/// On Linux a watcher thread blocks on inotify, watching the directories that contain
+/// the registered files (editors often save by writing a new file and renaming it over
+/// the old one, which a watch on the file itself would miss). Other desktop platforms
+/// fall back to polling modification times. Bursts of events for the same file are
+/// coalesced, then the callback runs once per changed file on the watcher thread.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace vibegl {
+
+/// Watches individual files and reports changes from a background thread.
+class FileWatcher {
+public:
+    /// Called on the watcher thread with the changed file's path as registered.
+    using Callback = std::function<void(const std::filesystem::path&)>;
+
+    /// How the watcher thread detects changes.
+    enum class Backend {
+        Native,  ///< inotify on Linux, polling elsewhere
+        Polling  ///< Compare modification times every kPollInterval
+    };
+
+    /// Quiet period that ends a burst of events before the callback runs.
+    static constexpr std::chrono::milliseconds kSettleTime{50};
+
+    /// Interval between modification time checks where inotify is unavailable.
+    static constexpr std::chrono::milliseconds kPollInterval{500};
+
+    FileWatcher() = default;
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+    FileWatcher(FileWatcher&&) = delete;
+    FileWatcher& operator=(FileWatcher&&) = delete;
+
+    /// Check whether file watching works on this platform (false on the web).
+    static bool isSupported();
+
+    /// Start the watcher thread.
+    /// @param callback Invoked for each changed file; must be thread-safe
+    /// @param backend Change detection (Native falls back to polling if inotify fails)
+    /// @return true if the thread is running
+    bool start(Callback callback, Backend backend = Backend::Native);
+
+    /// Stop and join the watcher thread.
+    void stop();
+
+    /// Check whether the watcher thread is running.
+    bool isRunning() const { return thread_.joinable(); }
+
+    /// Report changes to a file from now on. Safe to call from any thread.
+    void watch(const std::filesystem::path& file);
+
+private:
+    struct WatchedFile {
+        std::filesystem::path path;  ///< Path as passed to watch()
+        std::filesystem::file_time_type modified{};
+    };
+
+    void threadMain();
+    void pollLoop();
+    void dispatch(const std::vector<std::string>& changed);
+#ifdef __linux__
+    void openInotify();
+    void inotifyLoop();
+    void addDirectoryWatch(const std::filesystem::path& directory);
+#endif
+
+    Callback callback_;
+    std::thread thread_;
+    std::atomic<bool> quit_{false};
+    std::mutex mutex_;  ///< Guards files_ and directoryWatches_
+    std::condition_variable wake_;  ///< Interrupts the polling fallback on stop()
+    std::unordered_map<std::string, WatchedFile> files_;  ///< Keyed by absolute path
+#ifdef __linux__
+    int inotifyFd_ = -1;
+    int wakeFd_ = -1;  ///< eventfd that interrupts poll() on stop()
+    std::unordered_map<int, std::filesystem::path> directoryWatches_;  ///< Watch descriptor
+#endif
+};
+
+} // namespace vibegl
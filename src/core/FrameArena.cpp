@@ -0,0 +1,105 @@
+#include "FrameArena.hpp"
+
+#include <algorithm>
+#include <new>
+
+#include "JobSystem.hpp"
+
+namespace vibegl
+{
+
+namespace
+{
+
+/// Heap fallbacks tracked per sub-arena before the list itself has to grow.
+constexpr std::size_t kReservedOverflowEntries = 64;
+
+} // namespace
+
+FrameArena::FrameArena(const JobSystem& jobs, std::size_t bytesPerThread)
+    : jobs_(jobs), capacity_(bytesPerThread), subArenas_(jobs.threadCount() + 1),
+      resource_(*this)
+{
+    for (SubArena& sub : subArenas_)
+    {
+        sub.memory = std::make_unique_for_overwrite<std::byte[]>(capacity_);
+        sub.overflow.reserve(kReservedOverflowEntries);
+    }
+    stats_.subArenas = subArenas_.size();
+    stats_.capacityPerThread = capacity_;
+}
+
+FrameArena::~FrameArena()
+{
+    reset();
+}
+
+void* FrameArena::allocate(std::size_t bytes, std::size_t alignment)
+{
+    const std::size_t worker = jobs_.currentWorkerIndex();
+    if (worker < subArenas_.size() - 1)
+    {
+        return allocateFrom(subArenas_[worker], bytes, alignment);
+    }
+
+    const std::scoped_lock lock(sharedMutex_);
+    return allocateFrom(subArenas_.back(), bytes, alignment);
+}
+
+void* FrameArena::allocateFrom(SubArena& sub, std::size_t bytes, std::size_t alignment)
+{
+    const std::size_t aligned = (sub.offset + alignment - 1) & ~(alignment - 1);
+    if (aligned + bytes <= capacity_)
+    {
+        sub.offset = aligned + bytes;
+        return sub.memory.get() + aligned;
+    }
+
+    // Out of space: spill to the heap until the next reset
+    void* pointer = ::operator new(bytes, std::align_val_t{alignment});
+    sub.overflow.emplace_back(pointer, alignment);
+    sub.overflowBytes += bytes;
+    ++sub.overflowCount;
+    return pointer;
+}
+
+void FrameArena::reset()
+{
+    stats_.lastFrameBytes = 0;
+    stats_.lastFrameOverflowBytes = 0;
+    for (SubArena& sub : subArenas_)
+    {
+        sub.peak = std::max(sub.peak, sub.offset + sub.overflowBytes);
+        stats_.highWaterBytes = std::max(stats_.highWaterBytes, sub.peak);
+        stats_.lastFrameBytes += sub.offset + sub.overflowBytes;
+        stats_.lastFrameOverflowBytes += sub.overflowBytes;
+        stats_.overflowAllocations += sub.overflowCount;
+
+        for (const auto& [pointer, alignment] : sub.overflow)
+        {
+            ::operator delete(pointer, std::align_val_t{alignment});
+        }
+        sub.overflow.clear();
+        sub.offset = 0;
+        sub.overflowBytes = 0;
+        sub.overflowCount = 0;
+    }
+}
+
+void* FrameArena::Resource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    return arena_.allocate(bytes, alignment);
+}
+
+void FrameArena::Resource::do_deallocate(void* /*pointer*/, std::size_t /*bytes*/,
+                                         std::size_t /*alignment*/)
+{
+    // Memory is reclaimed in bulk by reset()
+}
+
+bool FrameArena::Resource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+} // namespace vibegl
@@ -0,0 +1,101 @@
+#pragma once
+
+/// @file
+/// Per-frame linear (bump) allocator.
+///
+/// Scratch data that only lives for one frame (temporary arrays, matrices, UI strings)
+/// is carved out of preallocated blocks instead of the general heap. Each job worker
+/// has its own block, so allocation is a pointer bump without locks or atomics, and
+/// everything is released at once when the arena is reset at the start of the next
+/// frame. Allocations that do not fit fall back to the heap and are counted so the
+/// arena can be resized.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace vibegl {
+
+class JobSystem;
+
+/// Frame-scoped bump allocator with one sub-arena per job worker thread.
+class FrameArena {
+public:
+    /// Usage figures for sizing the arena.
+    struct Stats {
+        std::size_t subArenas = 0;              ///< Worker sub-arenas plus the shared one
+        std::size_t capacityPerThread = 0;      ///< Bytes reserved per sub-arena
+        std::size_t lastFrameBytes = 0;         ///< Bytes allocated during the last frame
+        std::size_t highWaterBytes = 0;         ///< Most bytes any one sub-arena ever held
+        std::size_t lastFrameOverflowBytes = 0;  ///< Last frame's bytes that spilled to the heap
+        std::uint64_t overflowAllocations = 0;  ///< Heap fallbacks since creation
+    };
+
+    /// Reserve `bytesPerThread` for every worker of `jobs` (which must be started) and
+    /// for one shared sub-arena used by other threads.
+    FrameArena(const JobSystem& jobs, std::size_t bytesPerThread);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+    FrameArena(FrameArena&&) = delete;
+    FrameArena& operator=(FrameArena&&) = delete;
+
+    /// Allocate from the calling thread's sub-arena. Valid until the next reset().
+    /// @param bytes Size in bytes
+    /// @param alignment Power-of-two alignment
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+    /// Allocate uninitialized storage for `count` objects of type T.
+    template<typename T>
+    T* allocateArray(std::size_t count)
+    {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /// Memory resource for std::pmr containers; allocates from whichever thread's
+    /// sub-arena grows the container and never frees individually.
+    std::pmr::memory_resource* resource() { return &resource_; }
+
+    /// Release every allocation. No thread may use arena memory across this call.
+    void reset();
+
+    /// Figures as of the last reset().
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct alignas(64) SubArena {
+        std::unique_ptr<std::byte[]> memory;
+        std::size_t offset = 0;
+        std::size_t peak = 0;
+        std::size_t overflowBytes = 0;
+        std::uint64_t overflowCount = 0;
+        std::vector<std::pair<void*, std::size_t>> overflow;  ///< Pointer and alignment
+    };
+
+    class Resource : public std::pmr::memory_resource {
+    public:
+        explicit Resource(FrameArena& arena) : arena_(arena) {}
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+        FrameArena& arena_;
+    };
+
+    void* allocateFrom(SubArena& sub, std::size_t bytes, std::size_t alignment);
+
+    const JobSystem& jobs_;
+    std::size_t capacity_;
+    std::vector<SubArena> subArenas_;  ///< One per worker, then the shared one
+    std::mutex sharedMutex_;           ///< Guards the shared sub-arena
+    Resource resource_;
+    Stats stats_;
+};
+
+} // namespace vibegl
@@ -0,0 +1,181 @@
+#include "FramePacket.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace vibegl
+{
+
+namespace
+{
+
+/// Copy an ImVector into another, reusing the destination's capacity.
+template<typename T>
+void copyInto(ImVector<T>& destination, const ImVector<T>& source)
+{
+    destination.resize(source.Size);
+    if (source.Size > 0)
+    {
+        std::memcpy(destination.Data, source.Data,
+                    sizeof(T) * static_cast<std::size_t>(source.Size));
+    }
+}
+
+} // namespace
+
+/// Textures with pending uploads, forwarded to the renderer backend (ImGui 1.92+).
+struct UiDrawSnapshot::TextureList {
+#if IMGUI_VERSION_NUM >= 19200
+    ImVector<ImTextureData*> textures;
+#endif
+};
+
+UiDrawSnapshot::UiDrawSnapshot() : data_(std::make_unique<ImDrawData>()) {}
+
+UiDrawSnapshot::~UiDrawSnapshot()
+{
+    for (ImDrawList* list : lists_)
+    {
+        IM_DELETE(list);
+    }
+}
+
+void UiDrawSnapshot::capture(const ImDrawData* source)
+{
+    valid_ = source != nullptr && source->Valid;
+    hasTextureUpdates_ = false;
+    if (!valid_)
+    {
+        return;
+    }
+
+    const auto listCount = static_cast<std::size_t>(source->CmdListsCount);
+    while (lists_.size() < listCount)
+    {
+        lists_.push_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+    }
+
+    // Field-by-field so CmdLists keeps its capacity (ImVector::operator= reallocates)
+    data_->Valid = source->Valid;
+    data_->CmdListsCount = source->CmdListsCount;
+    data_->TotalIdxCount = source->TotalIdxCount;
+    data_->TotalVtxCount = source->TotalVtxCount;
+    data_->DisplayPos = source->DisplayPos;
+    data_->DisplaySize = source->DisplaySize;
+    data_->FramebufferScale = source->FramebufferScale;
+    data_->OwnerViewport = source->OwnerViewport;
+    data_->CmdLists.resize(source->CmdListsCount);
+    for (std::size_t i = 0; i < listCount; ++i)
+    {
+        const ImDrawList& from = *source->CmdLists[static_cast<int>(i)];
+        ImDrawList& to = *lists_[i];
+        copyInto(to.CmdBuffer, from.CmdBuffer);
+        copyInto(to.IdxBuffer, from.IdxBuffer);
+        copyInto(to.VtxBuffer, from.VtxBuffer);
+        to.Flags = from.Flags;
+        data_->CmdLists[static_cast<int>(i)] = &to;
+    }
+
+#if IMGUI_VERSION_NUM >= 19200
+    // Forward only textures with pending updates so the backend never reads texture
+    // state that the next ImGui frame may be changing on the simulation thread
+    if (textureList_ == nullptr)
+    {
+        textureList_ = std::make_unique<TextureList>();
+    }
+    textureList_->textures.resize(0);
+    if (source->Textures != nullptr)
+    {
+        for (ImTextureData* texture : *source->Textures)
+        {
+            if (texture->Status != ImTextureStatus_OK)
+            {
+                textureList_->textures.push_back(texture);
+            }
+        }
+    }
+    hasTextureUpdates_ = !textureList_->textures.empty();
+    data_->Textures = hasTextureUpdates_ ? &textureList_->textures : nullptr;
+#endif
+}
+
+ImDrawData* UiDrawSnapshot::get() const
+{
+    return valid_ ? data_.get() : nullptr;
+}
+
+FramePacketQueue::FramePacketQueue(std::size_t packetCount)
+{
+    packetCount = std::max<std::size_t>(packetCount, 2);
+    free_.reserve(packetCount);
+    ready_.reserve(packetCount);
+    for (std::size_t i = 0; i < packetCount; ++i)
+    {
+        packets_.push_back(std::make_unique<FramePacket>());
+        free_.push_back(packets_.back().get());
+    }
+}
+
+FramePacket* FramePacketQueue::acquireForBuild()
+{
+    std::unique_lock lock(mutex_);
+    changed_.wait(lock, [this] { return closed_ || !free_.empty(); });
+    if (closed_)
+    {
+        return nullptr;
+    }
+    FramePacket* packet = free_.back();
+    free_.pop_back();
+    return packet;
+}
+
+void FramePacketQueue::publish(FramePacket* packet)
+{
+    {
+        const std::scoped_lock lock(mutex_);
+        ready_.push_back(packet);
+    }
+    changed_.notify_all();
+}
+
+FramePacket* FramePacketQueue::acquireForRender()
+{
+    std::unique_lock lock(mutex_);
+    changed_.wait(lock, [this] { return closed_ || !ready_.empty(); });
+    if (ready_.empty())
+    {
+        return nullptr;
+    }
+    FramePacket* packet = ready_.front();
+    ready_.erase(ready_.begin());
+    return packet;
+}
+
+void FramePacketQueue::release(FramePacket* packet)
+{
+    {
+        const std::scoped_lock lock(mutex_);
+        lastRendered_ = std::max(lastRendered_, packet->frameIndex);
+        free_.push_back(packet);
+    }
+    changed_.notify_all();
+}
+
+void FramePacketQueue::waitForRendered(std::uint64_t frameIndex)
+{
+    std::unique_lock lock(mutex_);
+    changed_.wait(lock, [&] { return closed_ || lastRendered_ >= frameIndex; });
+}
+
+void FramePacketQueue::close()
+{
+    {
+        const std::scoped_lock lock(mutex_);
+        closed_ = true;
+    }
+    changed_.notify_all();
+}
+
+} // namespace vibegl
@@ -0,0 +1,114 @@
+#pragma once
+
+/// @file
+/// Frame packets exchanged between the simulation and render threads.
+///
+/// The simulation side fills a FramePacket with everything the render side needs
+/// (transforms, draw list, UI draw data) so that the render thread never reads
+/// application state that the next update may be modifying.
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct ImDrawData;
+struct ImDrawList;
+
+namespace vibegl {
+
+/// One draw in a frame packet. Mesh and material IDs are defined by the application.
+struct DrawCommand {
+    std::array<float, 16> transform{};  ///< Column-major model-view-projection matrix
+    std::array<float, 4> color{};       ///< Per-draw tint
+    std::uint32_t mesh = 0;             ///< Application-defined mesh ID
+    std::uint32_t material = 0;         ///< Application-defined material ID
+};
+
+/// Deep copy of ImGui draw data that stays valid after the next ImGui::NewFrame().
+///
+/// Draw lists are recycled between frames so capturing does not allocate once the
+/// buffers have grown to the UI's steady-state size.
+class UiDrawSnapshot {
+public:
+    UiDrawSnapshot();
+    ~UiDrawSnapshot();
+
+    UiDrawSnapshot(const UiDrawSnapshot&) = delete;
+    UiDrawSnapshot& operator=(const UiDrawSnapshot&) = delete;
+    UiDrawSnapshot(UiDrawSnapshot&&) = delete;
+    UiDrawSnapshot& operator=(UiDrawSnapshot&&) = delete;
+
+    /// Copy the given draw data (call on the thread that owns the ImGui context).
+    /// @param source Result of ImGui::GetDrawData() after ImGui::Render()
+    void capture(const ImDrawData* source);
+
+    /// Copied draw data, or nullptr if nothing was captured.
+    ImDrawData* get() const;
+
+    /// Check whether the captured frame carries font/texture updates for the renderer.
+    /// The owning thread must not start a new ImGui frame until those are applied.
+    bool hasTextureUpdates() const { return hasTextureUpdates_; }
+
+private:
+    struct TextureList;
+
+    std::unique_ptr<ImDrawData> data_;
+    std::vector<ImDrawList*> lists_;
+    std::unique_ptr<TextureList> textureList_;
+    bool valid_ = false;
+    bool hasTextureUpdates_ = false;
+};
+
+/// Everything the render thread needs to draw one frame.
+struct FramePacket {
+    std::uint64_t frameIndex = 0;      ///< Frame counter at build time
+    float deltaTime = 0.0f;            ///< Frame delta time in seconds
+    double interpolationAlpha = 0.0;   ///< Fixed-step interpolation factor at build time
+    int framebufferWidth = 0;          ///< Framebuffer size at build time
+    int framebufferHeight = 0;         ///< Framebuffer size at build time
+    std::vector<DrawCommand> draws;    ///< Scene draws in submission order
+    UiDrawSnapshot ui;                 ///< ImGui draw data (threaded rendering only)
+    ImDrawData* uiDrawData = nullptr;  ///< ImGui draw data to render this frame
+};
+
+/// Bounded FIFO of frame packets shared by one producer and one consumer thread.
+///
+/// With N packets the producer can run up to N - 1 frames ahead of the consumer.
+class FramePacketQueue {
+public:
+    /// Create a queue owning the given number of packets (at least 2).
+    explicit FramePacketQueue(std::size_t packetCount);
+
+    /// Wait for a free packet to fill. Returns nullptr once the queue is closed.
+    FramePacket* acquireForBuild();
+
+    /// Hand a filled packet to the consumer.
+    void publish(FramePacket* packet);
+
+    /// Wait for the oldest published packet. Returns nullptr once closed and drained.
+    FramePacket* acquireForRender();
+
+    /// Return a rendered packet to the free list.
+    void release(FramePacket* packet);
+
+    /// Block until the packet with the given frame index has been released.
+    void waitForRendered(std::uint64_t frameIndex);
+
+    /// Wake all waiters; subsequent acquires fail once no work remains.
+    void close();
+
+private:
+    std::vector<std::unique_ptr<FramePacket>> packets_;
+    std::vector<FramePacket*> free_;
+    std::vector<FramePacket*> ready_;
+    std::uint64_t lastRendered_ = 0;
+    bool closed_ = false;
+    std::mutex mutex_;
+    std::condition_variable changed_;
+};
+
+} // namespace vibegl
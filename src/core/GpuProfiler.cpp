@@ -0,0 +1,237 @@
+#include "GpuProfiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <mutex>
+
+#include "GLIncludes.hpp"
+
+namespace vibegl
+{
+
+namespace
+{
+
+constexpr std::size_t kNoZone = GpuProfiler::kMaxZonesPerFrame;
+
+/// How often the GPU clock is re-aligned with the profiler clock.
+constexpr std::int64_t kCalibrationIntervalNs = 1'000'000'000;
+
+/// Zones and queries written during one frame.
+struct FrameSlot {
+    std::array<GLuint, GpuProfiler::kMaxZonesPerFrame * 2> queries{};
+    std::array<const char*, GpuProfiler::kMaxZonesPerFrame> names{};
+    std::array<std::uint32_t, GpuProfiler::kMaxZonesPerFrame> depths{};
+    std::size_t zoneCount = 0;
+    std::size_t openZones = 0;
+    std::size_t lastQuery = 0;  ///< Index of the most recently issued query
+};
+
+struct State {
+    std::array<FrameSlot, GpuProfiler::kFrameLatency> slots;
+    std::size_t current = 0;
+    bool initialized = false;
+    std::int64_t gpuToCpuOffsetNs = 0;
+    std::int64_t lastCalibrationNs = 0;
+    Profiler::TrackId track = 0;
+    std::mutex resultsMutex;  ///< Guards results read by the overlay on another thread
+    std::vector<Profiler::ZoneTiming> lastZones;
+    double lastFrameMs = 0.0;
+    std::uint64_t droppedFrames = 0;
+};
+
+State& state()
+{
+    static State instance;
+    return instance;
+}
+
+#ifndef __EMSCRIPTEN__
+void calibrate(State& s)
+{
+    GLint64 gpuNow = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    s.lastCalibrationNs = Profiler::now();
+    s.gpuToCpuOffsetNs = s.lastCalibrationNs - gpuNow;
+}
+
+/// Read back a finished slot. Returns false if its results are not available yet.
+bool resolve(State& s, const FrameSlot& slot)
+{
+    // Queries complete in submission order, so the last one issued gates the whole frame.
+    // With nested zones that is an outer zone's end, not the last zone's.
+    GLint available = 0;
+    glGetQueryObjectiv(slot.queries[slot.lastQuery], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == 0)
+    {
+        return false;
+    }
+
+    const std::scoped_lock lock(s.resultsMutex);
+    s.lastZones.clear();
+    s.lastFrameMs = 0.0;
+    for (std::size_t i = 0; i < slot.zoneCount; ++i)
+    {
+        GLuint64 begin = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(slot.queries[i * 2], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(slot.queries[(i * 2) + 1], GL_QUERY_RESULT, &end);
+
+        const double ms = static_cast<double>(end - begin) * 1e-6;
+        if (slot.depths[i] == 0)
+        {
+            s.lastFrameMs += ms;
+        }
+
+        auto it = std::ranges::find_if(s.lastZones, [&](const Profiler::ZoneTiming& zone)
+                                       { return std::strcmp(zone.name, slot.names[i]) == 0; });
+        if (it == s.lastZones.end())
+        {
+            s.lastZones.push_back(
+                Profiler::ZoneTiming{.name = slot.names[i], .depth = slot.depths[i]});
+            it = s.lastZones.end() - 1;
+        }
+        it->milliseconds += ms;
+        ++it->calls;
+
+        Profiler::recordOnTrack(s.track, slot.names[i],
+                                static_cast<std::int64_t>(begin) + s.gpuToCpuOffsetNs,
+                                static_cast<std::int64_t>(end) + s.gpuToCpuOffsetNs,
+                                slot.depths[i]);
+    }
+    return true;
+}
+#endif
+
+} // namespace
+
+bool GpuProfiler::init()
+{
+#ifdef __EMSCRIPTEN__
+    return false;
+#else
+    State& s = state();
+    if (s.initialized)
+    {
+        return true;
+    }
+
+    for (FrameSlot& slot : s.slots)
+    {
+        glGenQueries(static_cast<GLsizei>(slot.queries.size()), slot.queries.data());
+    }
+    s.track = Profiler::createTrack("GPU");
+    calibrate(s);
+    s.initialized = true;
+    return true;
+#endif
+}
+
+void GpuProfiler::shutdown()
+{
+    State& s = state();
+    if (!s.initialized)
+    {
+        return;
+    }
+
+    for (FrameSlot& slot : s.slots)
+    {
+        glDeleteQueries(static_cast<GLsizei>(slot.queries.size()), slot.queries.data());
+        slot = FrameSlot{};
+    }
+    s.initialized = false;
+}
+
+bool GpuProfiler::isSupported()
+{
+    return state().initialized;
+}
+
+void GpuProfiler::beginFrame()
+{
+#ifndef __EMSCRIPTEN__
+    State& s = state();
+    if (!s.initialized)
+    {
+        return;
+    }
+
+    s.current = (s.current + 1) % kFrameLatency;
+    FrameSlot& slot = s.slots[s.current];
+    if (slot.zoneCount > 0 && !resolve(s, slot))
+    {
+        // Never wait: drop this frame's results and reuse the queries
+        const std::scoped_lock lock(s.resultsMutex);
+        ++s.droppedFrames;
+    }
+    slot.zoneCount = 0;
+    slot.openZones = 0;
+    slot.lastQuery = 0;
+
+    if (Profiler::now() - s.lastCalibrationNs > kCalibrationIntervalNs)
+    {
+        calibrate(s);
+    }
+#endif
+}
+
+Profiler::ZoneList GpuProfiler::lastFrameZones(std::pmr::memory_resource* memory)
+{
+    State& s = state();
+    const std::scoped_lock lock(s.resultsMutex);
+    return {s.lastZones.begin(), s.lastZones.end(), memory};
+}
+
+double GpuProfiler::lastFrameMilliseconds()
+{
+    State& s = state();
+    const std::scoped_lock lock(s.resultsMutex);
+    return s.lastFrameMs;
+}
+
+std::uint64_t GpuProfiler::droppedFrames()
+{
+    State& s = state();
+    const std::scoped_lock lock(s.resultsMutex);
+    return s.droppedFrames;
+}
+
+GpuProfiler::Scope::Scope(const char* name) : zone_(kNoZone)
+{
+#ifndef __EMSCRIPTEN__
+    State& s = state();
+    FrameSlot& slot = s.slots[s.current];
+    if (!s.initialized || slot.zoneCount == kMaxZonesPerFrame)
+    {
+        return;
+    }
+
+    zone_ = slot.zoneCount++;
+    slot.names[zone_] = name;
+    slot.depths[zone_] = static_cast<std::uint32_t>(slot.openZones++);
+    slot.lastQuery = zone_ * 2;
+    glQueryCounter(slot.queries[slot.lastQuery], GL_TIMESTAMP);
+#else
+    static_cast<void>(name);
+#endif
+}
+
+GpuProfiler::Scope::~Scope()
+{
+#ifndef __EMSCRIPTEN__
+    if (zone_ == kNoZone)
+    {
+        return;
+    }
+
+    State& s = state();
+    FrameSlot& slot = s.slots[s.current];
+    --slot.openZones;
+    slot.lastQuery = (zone_ * 2) + 1;
+    glQueryCounter(slot.queries[slot.lastQuery], GL_TIMESTAMP);
+#endif
+}
+
+} // namespace vibegl
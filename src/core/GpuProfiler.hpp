@@ -0,0 +1,80 @@
+#pragma once
+
+/// @file
+/// Non-stalling GPU zone timing built on timestamp queries.
+///
+/// Each frame writes `GL_TIMESTAMP` queries at zone boundaries into one slot of a
+/// ring that is kFrameLatency frames deep. A slot is only read back when the ring
+/// comes around to it again and its results are already available, so the CPU never
+/// waits on the GPU. Resolved zones feed the profiler overlay and appear on a "GPU"
+/// track in exported Chrome traces.
+///
+/// Timer queries are not available in WebGL 2.0, where every call is a no-op.
+
+#include "Profiler.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vibegl {
+
+/// Process-wide GPU zone profiler. Must be used from the thread owning the GL context;
+/// the result accessors may be called from any thread.
+class GpuProfiler {
+public:
+    /// Number of frames in flight before a slot's queries are read back.
+    static constexpr std::size_t kFrameLatency = 4;
+
+    /// Maximum zones recorded per frame; extra zones are ignored.
+    static constexpr std::size_t kMaxZonesPerFrame = 32;
+
+    /// Create query objects. Requires a current OpenGL context.
+    /// @return true if GPU timing is supported and was initialized
+    static bool init();
+
+    /// Delete query objects. Requires the same context to be current.
+    static void shutdown();
+
+    /// Check whether GPU timing is active.
+    static bool isSupported();
+
+    /// Advance the ring and collect any results that are ready. Call once per frame
+    /// before the first GPU zone.
+    static void beginFrame();
+
+    /// GPU zones of the most recently resolved frame.
+    /// @param memory Allocator for the result (e.g. a FrameArena resource)
+    static Profiler::ZoneList lastFrameZones(
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /// Sum of top-level GPU zone times of the most recently resolved frame.
+    static double lastFrameMilliseconds();
+
+    /// Number of frames whose results were discarded because they were not ready in time.
+    static std::uint64_t droppedFrames();
+
+    /// RAII helper that brackets GPU commands with timestamp queries.
+    class Scope {
+    public:
+        explicit Scope(const char* name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+        Scope& operator=(Scope&&) = delete;
+
+    private:
+        std::size_t zone_;
+    };
+};
+
+} // namespace vibegl
+
+#ifdef VIBEGL_ENABLE_PROFILER
+/// Time the GPU work submitted in the enclosing scope under the given name.
+#define VIBEGL_GPU_PROFILE_SCOPE(name)                                                             \
+    const ::vibegl::GpuProfiler::Scope VIBEGL_PROFILE_CONCAT(vibeglGpuProfileScope, __LINE__)(name)
+#else
+#define VIBEGL_GPU_PROFILE_SCOPE(name) static_cast<void>(0)
+#endif
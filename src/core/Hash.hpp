@@ -0,0 +1,52 @@
+#pragma once
+
+/// @file
+/// Compile-time capable FNV-1a hashing for cache keys and string IDs.
+
+#include <compare>
+#include <cstdint>
+#include <string_view>
+
+namespace vibegl {
+
+/// FNV-1a 64-bit offset basis; pass as seed to start a new hash.
+inline constexpr std::uint64_t kFnv1aSeed = 14695981039346656037ULL;
+
+/// Hash bytes with 64-bit FNV-1a, continuing from `seed` so several inputs can be chained.
+constexpr std::uint64_t fnv1a64(std::string_view data, std::uint64_t seed = kFnv1aSeed)
+{
+    constexpr std::uint64_t kPrime = 1099511628211ULL;
+    std::uint64_t hash = seed;
+    for (const char c : data)
+    {
+        hash ^= static_cast<std::uint8_t>(c);
+        hash *= kPrime;
+    }
+    return hash;
+}
+
+/// Hashed identifier such as a uniform name.
+///
+/// Constructing from a string literal is consteval, so `NameHash("uMVP")` costs nothing at
+/// run time; use fromString() for names only known at run time.
+struct NameHash {
+    std::uint64_t value = 0;
+
+    constexpr NameHash() = default;
+
+    /// Hash a literal at compile time (implicit so literals can be passed directly).
+    // NOLINTNEXTLINE(google-explicit-constructor, hicpp-explicit-conversions)
+    consteval NameHash(const char* name) : value(fnv1a64(name)) {}
+
+    /// Hash a run-time string.
+    static constexpr NameHash fromString(std::string_view name)
+    {
+        NameHash hash;
+        hash.value = fnv1a64(name);
+        return hash;
+    }
+
+    constexpr auto operator<=>(const NameHash&) const = default;
+};
+
+} // namespace vibegl
@@ -0,0 +1,373 @@
+#include "JobSystem.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include "Profiler.hpp"
+
+namespace vibegl
+{
+
+namespace
+{
+
+/// Profiler thread names need static storage.
+constexpr std::array<const char*, 16> kWorkerNames = {
+    "Main",      "Worker 1",  "Worker 2",  "Worker 3",  "Worker 4",  "Worker 5",
+    "Worker 6",  "Worker 7",  "Worker 8",  "Worker 9",  "Worker 10", "Worker 11",
+    "Worker 12", "Worker 13", "Worker 14", "Worker 15"};
+
+/// Failed searches before an idle worker goes to sleep.
+constexpr int kSpinsBeforeSleep = 64;
+
+std::uint32_t nextRandom(std::uint32_t& state)
+{
+    // xorshift32: cheap victim selection, quality does not matter here
+    state ^= state << 13U;
+    state ^= state >> 17U;
+    state ^= state << 5U;
+    return state;
+}
+
+} // namespace
+
+thread_local const JobSystem* JobSystem::currentSystem_ = nullptr;
+thread_local JobSystem::Worker* JobSystem::currentWorker_ = nullptr;
+
+bool JobSystem::WorkDeque::push(Job* job)
+{
+    const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    const std::int64_t top = top_.load(std::memory_order_acquire);
+    if (bottom - top >= static_cast<std::int64_t>(kDequeCapacity))
+    {
+        return false;
+    }
+    buffer_[static_cast<std::size_t>(bottom) % kDequeCapacity].store(job,
+                                                                      std::memory_order_relaxed);
+    // Release store (rather than a fence) publishes the job to thieves' acquire loads
+    bottom_.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+JobSystem::Job* JobSystem::WorkDeque::pop()
+{
+    const std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t top = top_.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        // Empty: restore the canonical state
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job* job = buffer_[static_cast<std::size_t>(bottom) % kDequeCapacity].load(
+        std::memory_order_relaxed);
+    if (top == bottom)
+    {
+        // Last job: race thieves for it
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed))
+        {
+            job = nullptr;
+        }
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+JobSystem::Job* JobSystem::WorkDeque::steal()
+{
+    std::int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom)
+    {
+        return nullptr;
+    }
+
+    Job* job =
+        buffer_[static_cast<std::size_t>(top) % kDequeCapacity].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed))
+    {
+        return nullptr;
+    }
+    return job;
+}
+
+JobSystem::JobSystem() = default;
+
+JobSystem::~JobSystem()
+{
+    stop();
+}
+
+void JobSystem::start(int workerThreads)
+{
+    if (running_)
+    {
+        return;
+    }
+
+    std::size_t spawned = 0;
+    if (workerThreads < 0)
+    {
+        const unsigned int cores = std::thread::hardware_concurrency();
+        spawned = cores > 1 ? cores - 1 : 0;
+    }
+    else
+    {
+        spawned = static_cast<std::size_t>(workerThreads);
+    }
+
+    // Create every deque before any thread can try to steal from it
+    quit_.store(false, std::memory_order_relaxed);
+    for (std::size_t i = 0; i <= spawned; ++i)
+    {
+        workers_.push_back(std::make_unique<Worker>());
+        workers_.back()->stealSeed = static_cast<std::uint32_t>(i * 2654435761U) | 1U;
+        workers_.back()->index = i;
+    }
+    currentSystem_ = this;
+    currentWorker_ = workers_.front().get();
+    running_ = true;
+
+    for (std::size_t i = 1; i <= spawned; ++i)
+    {
+        workers_[i]->thread = std::thread(&JobSystem::workerMain, this, i);
+    }
+}
+
+void JobSystem::stop()
+{
+    if (!running_)
+    {
+        return;
+    }
+
+    drain();
+    quit_.store(true, std::memory_order_seq_cst);
+    {
+        const std::scoped_lock lock(sleepMutex_);
+        wake_.notify_all();
+    }
+    for (auto& worker : workers_)
+    {
+        if (worker->thread.joinable())
+        {
+            worker->thread.join();
+        }
+    }
+    workers_.clear();
+    if (currentSystem_ == this)
+    {
+        currentSystem_ = nullptr;
+        currentWorker_ = nullptr;
+    }
+    running_ = false;
+}
+
+void JobSystem::wait(const JobCounter& counter)
+{
+    if (counter.isDone())
+    {
+        return;
+    }
+
+    VIBEGL_PROFILE_SCOPE("JobSystem::wait");
+    Worker* self = currentWorker();
+    while (!counter.isDone())
+    {
+        if (Job* job = findJob(self))
+        {
+            execute(job);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::drain()
+{
+    Worker* self = currentWorker();
+    while (unfinishedJobs_.load(std::memory_order_acquire) > 0)
+    {
+        if (Job* job = findJob(self))
+        {
+            execute(job);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+JobSystem::Job* JobSystem::allocateJob()
+{
+    Worker* self = currentWorker();
+    if (self != nullptr)
+    {
+        // Slots are recycled round-robin; one still in flight means the pool wrapped
+        Job& job = self->pool[self->nextPoolSlot];
+        if (!job.inUse.load(std::memory_order_acquire))
+        {
+            self->nextPoolSlot = (self->nextPoolSlot + 1) % kDequeCapacity;
+            job.inUse.store(true, std::memory_order_relaxed);
+            job.pooled = true;
+            return &job;
+        }
+    }
+
+    auto* job = new Job();  // NOLINT(cppcoreguidelines-owning-memory)
+    job->inUse.store(true, std::memory_order_relaxed);
+    return job;
+}
+
+void JobSystem::enqueue(Job* job)
+{
+    unfinishedJobs_.fetch_add(1, std::memory_order_relaxed);
+
+    Worker* self = currentWorker();
+    if (!running_ || (self != nullptr && !self->deque.push(job)))
+    {
+        // Not started or deque full: run it right here
+        execute(job);
+        return;
+    }
+    if (self == nullptr)
+    {
+        const std::scoped_lock lock(injectMutex_);
+        injected_.push_back(job);
+    }
+
+    queuedJobs_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) > 0)
+    {
+        const std::scoped_lock lock(sleepMutex_);
+        wake_.notify_one();
+    }
+}
+
+JobSystem::Job* JobSystem::findJob(Worker* self)
+{
+    Job* job = self != nullptr ? self->deque.pop() : nullptr;
+
+    if (job == nullptr)
+    {
+        const std::unique_lock lock(injectMutex_, std::try_to_lock);
+        if (lock.owns_lock() && !injected_.empty())
+        {
+            job = injected_.front();
+            injected_.pop_front();
+        }
+    }
+
+    if (job == nullptr && !workers_.empty())
+    {
+        static thread_local std::uint32_t foreignSeed = 0x9E3779B9U;
+        std::uint32_t& seed = self != nullptr ? self->stealSeed : foreignSeed;
+        const std::size_t first = nextRandom(seed) % workers_.size();
+        for (std::size_t i = 0; i < workers_.size() && job == nullptr; ++i)
+        {
+            Worker& victim = *workers_[(first + i) % workers_.size()];
+            if (&victim != self)
+            {
+                job = victim.deque.steal();
+            }
+        }
+    }
+
+    if (job != nullptr)
+    {
+        queuedJobs_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+void JobSystem::execute(Job* job)
+{
+    if (job->dependency != nullptr)
+    {
+        wait(*job->dependency);
+    }
+
+    job->invoke(*job);
+    job->destroy(*job);
+
+    JobCounter* counter = job->counter;
+    if (job->pooled)
+    {
+        job->inUse.store(false, std::memory_order_release);
+    }
+    else
+    {
+        delete job;  // NOLINT(cppcoreguidelines-owning-memory)
+    }
+    if (counter != nullptr)
+    {
+        counter->pending_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+    unfinishedJobs_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void JobSystem::workerMain(std::size_t index)
+{
+    Profiler::setThreadName(kWorkerNames[std::min(index, kWorkerNames.size() - 1)]);
+    currentSystem_ = this;
+    currentWorker_ = workers_[index].get();
+    Worker* self = currentWorker_;
+
+    int idleSpins = 0;
+    while (true)
+    {
+        if (Job* job = findJob(self))
+        {
+            execute(job);
+            idleSpins = 0;
+            continue;
+        }
+        if (quit_.load(std::memory_order_acquire) &&
+            queuedJobs_.load(std::memory_order_acquire) <= 0)
+        {
+            break;
+        }
+        if (++idleSpins < kSpinsBeforeSleep)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock lock(sleepMutex_);
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        wake_.wait(lock,
+                   [this]
+                   {
+                       return quit_.load(std::memory_order_seq_cst) ||
+                              queuedJobs_.load(std::memory_order_seq_cst) > 0;
+                   });
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        idleSpins = 0;
+    }
+
+    currentSystem_ = nullptr;
+    currentWorker_ = nullptr;
+}
+
+JobSystem::Worker* JobSystem::currentWorker() const
+{
+    return currentSystem_ == this ? currentWorker_ : nullptr;
+}
+
+std::size_t JobSystem::currentWorkerIndex() const
+{
+    const Worker* self = currentWorker();
+    return self != nullptr ? self->index : kNotAWorker;
+}
+
+} // namespace vibegl
@@ -0,0 +1,204 @@
+#pragma once
+
+/// @file
+/// Work-stealing job scheduler.
+///
+/// Every worker thread owns a Chase-Lev deque: it pushes and pops jobs at the bottom
+/// while idle workers steal from the top, so fan-out work spreads across cores without
+/// a shared lock. The thread that starts the system (the main thread) is worker 0 and
+/// runs jobs whenever it waits on a counter. Threads that are not workers (such as the
+/// render thread) submit through a mutex-protected injection queue.
+///
+/// Jobs are small callables stored inline in pooled job objects, so submitting does not
+/// allocate in steady state. Completion is tracked with JobCounter: each submitted job
+/// increments its counter and decrements it when finished.
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vibegl {
+
+/// Number of unfinished jobs in a group. Wait on it with JobSystem::wait().
+class JobCounter {
+public:
+    /// Check whether every job added to this counter has finished.
+    bool isDone() const { return pending_.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    std::atomic<std::uint32_t> pending_{0};
+};
+
+/// Work-stealing job scheduler with a fixed set of worker threads.
+class JobSystem {
+public:
+    /// Maximum size of a job's captured state in bytes.
+    static constexpr std::size_t kJobStorageSize = 64;
+
+    /// Jobs per worker deque; pushing onto a full deque runs the job inline.
+    static constexpr std::size_t kDequeCapacity = 4096;
+
+    JobSystem();
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    JobSystem(JobSystem&&) = delete;
+    JobSystem& operator=(JobSystem&&) = delete;
+
+    /// Start worker threads. The calling thread becomes worker 0.
+    /// @param workerThreads Threads to spawn; negative = one per core minus one, 0 = run
+    ///                      all jobs on the calling thread while it waits
+    void start(int workerThreads);
+
+    /// Finish all queued jobs and join the worker threads.
+    void stop();
+
+    /// Check whether start() has been called without a matching stop().
+    bool isRunning() const { return running_; }
+
+    /// Number of threads executing jobs, including the calling thread.
+    std::size_t threadCount() const { return workers_.size(); }
+
+    /// Returned by currentWorkerIndex() on threads that are not workers.
+    static constexpr std::size_t kNotAWorker = static_cast<std::size_t>(-1);
+
+    /// Index in [0, threadCount()) of the calling worker (0 = thread that called start()),
+    /// or kNotAWorker.
+    std::size_t currentWorkerIndex() const;
+
+    /// Queue a job. Safe to call from any thread, including from inside another job.
+    /// @param job Callable `void()`, at most kJobStorageSize bytes; must not throw
+    /// @param counter Optional counter incremented now and decremented when the job ends
+    /// @param dependency Optional counter the job waits on (helping) before it runs
+    template<typename F>
+    void submit(F&& job, JobCounter* counter = nullptr, const JobCounter* dependency = nullptr);
+
+    /// Run `body(begin, end)` over [0, count) split into chunks of `grainSize` items, and
+    /// wait for all chunks. The calling thread executes chunks too.
+    template<typename F>
+    void parallelFor(std::size_t count, std::size_t grainSize, F&& body);
+
+    /// Block until the counter reaches zero, executing other jobs meanwhile.
+    void wait(const JobCounter& counter);
+
+    /// Run queued jobs until none are left anywhere (call from the starting thread).
+    void drain();
+
+private:
+    struct Job {
+        void (*invoke)(Job&) = nullptr;
+        void (*destroy)(Job&) = nullptr;
+        JobCounter* counter = nullptr;
+        const JobCounter* dependency = nullptr;
+        std::atomic<bool> inUse{false};
+        bool pooled = false;
+        alignas(std::max_align_t) std::array<std::byte, kJobStorageSize> storage;
+    };
+
+    /// Chase-Lev work-stealing deque (Lê et al., "Correct and Efficient Work-Stealing
+    /// for Weak Memory Models", 2013) with a fixed capacity.
+    class WorkDeque {
+    public:
+        /// Owner only. Returns false if the deque is full.
+        bool push(Job* job);
+        /// Owner only. Takes the most recently pushed job.
+        Job* pop();
+        /// Any thread. Takes the oldest job, or nullptr if empty or lost a race.
+        Job* steal();
+
+    private:
+        alignas(64) std::atomic<std::int64_t> top_{0};
+        alignas(64) std::atomic<std::int64_t> bottom_{0};
+        std::unique_ptr<std::atomic<Job*>[]> buffer_ =
+            std::make_unique<std::atomic<Job*>[]>(kDequeCapacity);
+    };
+
+    struct Worker {
+        WorkDeque deque;
+        std::unique_ptr<Job[]> pool = std::make_unique<Job[]>(kDequeCapacity);
+        std::size_t nextPoolSlot = 0;
+        std::thread thread;
+        std::uint32_t stealSeed = 0;
+        std::size_t index = 0;
+    };
+
+    Job* allocateJob();
+    void enqueue(Job* job);
+    Job* findJob(Worker* self);
+    void execute(Job* job);
+    void workerMain(std::size_t index);
+    Worker* currentWorker() const;
+
+    static thread_local const JobSystem* currentSystem_;
+    static thread_local Worker* currentWorker_;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex injectMutex_;
+    std::deque<Job*> injected_;
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::atomic<std::uint32_t> sleepers_{0};
+    std::atomic<std::int64_t> queuedJobs_{0};      ///< Jobs waiting in any queue
+    std::atomic<std::int64_t> unfinishedJobs_{0};  ///< Jobs submitted but not finished
+    std::atomic<bool> quit_{false};
+    bool running_ = false;
+};
+
+template<typename F>
+void JobSystem::submit(F&& job, JobCounter* counter, const JobCounter* dependency)
+{
+    using Callable = std::decay_t<F>;
+    static_assert(sizeof(Callable) <= kJobStorageSize, "Job captures too much state");
+    static_assert(alignof(Callable) <= alignof(std::max_align_t), "Job is over-aligned");
+
+    Job* slot = allocateJob();
+    ::new (static_cast<void*>(slot->storage.data())) Callable(std::forward<F>(job));
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    slot->invoke = [](Job& self)
+    { (*std::launder(reinterpret_cast<Callable*>(self.storage.data())))(); };
+    slot->destroy = [](Job& self)
+    { std::launder(reinterpret_cast<Callable*>(self.storage.data()))->~Callable(); };
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    slot->counter = counter;
+    slot->dependency = dependency;
+    if (counter != nullptr)
+    {
+        counter->pending_.fetch_add(1, std::memory_order_relaxed);
+    }
+    enqueue(slot);
+}
+
+template<typename F>
+void JobSystem::parallelFor(std::size_t count, std::size_t grainSize, F&& body)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    grainSize = grainSize == 0 ? 1 : grainSize;
+
+    JobCounter counter;
+    auto* bodyPtr = &body;
+    // Keep the first chunk for the calling thread
+    for (std::size_t begin = grainSize; begin < count; begin += grainSize)
+    {
+        const std::size_t end = begin + grainSize < count ? begin + grainSize : count;
+        submit([bodyPtr, begin, end] { (*bodyPtr)(begin, end); }, &counter);
+    }
+    body(std::size_t{0}, grainSize < count ? grainSize : count);
+    wait(counter);
+}
+
+} // namespace vibegl
@@ -0,0 +1,197 @@
+#include "MappedFile.hpp"
+
+// The web's virtual file system would copy into a mapping anyway
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#define VIBEGL_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+#include <fstream>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+namespace vibegl
+{
+
+namespace
+{
+
+Error openError(const std::filesystem::path& path, int err)
+{
+    return Error{.message = "Failed to read file",
+                 .context = path.string() + " (errno: " + std::to_string(err) + " - " +
+                            std::error_code(err, std::generic_category()).message() + ")"};
+}
+
+} // namespace
+
+MappedFile::~MappedFile()
+{
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      mapping_(std::exchange(other.mapping_, nullptr)),
+      buffer_(std::move(other.buffer_))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapping_ = std::exchange(other.mapping_, nullptr);
+        buffer_ = std::move(other.buffer_);
+    }
+    return *this;
+}
+
+void MappedFile::release()
+{
+#ifdef VIBEGL_HAS_MMAP
+    if (mapping_ != nullptr)
+    {
+        munmap(mapping_, size_);
+    }
+#endif
+    mapping_ = nullptr;
+    data_ = nullptr;
+    size_ = 0;
+    buffer_.clear();
+}
+
+Result<MappedFile> MappedFile::open(const std::filesystem::path& path)
+{
+    MappedFile file;
+
+#ifdef VIBEGL_HAS_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return std::unexpected(openError(path, errno));
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0)
+    {
+        const int err = errno;
+        close(fd);
+        return std::unexpected(openError(path, err));
+    }
+    const auto size = static_cast<std::size_t>(info.st_size);
+
+    if (size >= kMapThreshold)
+    {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+        {
+            close(fd);
+            // Loaders parse front to back: read ahead aggressively and start now
+            madvise(mapping, size, MADV_SEQUENTIAL);
+            madvise(mapping, size, MADV_WILLNEED);
+            file.mapping_ = mapping;
+            file.data_ = static_cast<const std::byte*>(mapping);
+            file.size_ = size;
+            return file;
+        }
+        // Not mappable (e.g. some network or virtual file systems): read it instead
+    }
+
+    file.buffer_.resize(size);
+    std::size_t done = 0;
+    while (done < size)
+    {
+        const ssize_t count = ::read(fd, file.buffer_.data() + done, size - done);
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count <= 0)
+        {
+            // Error, or the file shrank since fstat()
+            const int err = count < 0 ? errno : EIO;
+            close(fd);
+            return std::unexpected(openError(path, err));
+        }
+        done += static_cast<std::size_t>(count);
+    }
+    close(fd);
+#else
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if (!stream.is_open())
+    {
+        return std::unexpected(openError(path, errno));
+    }
+    const auto size = static_cast<std::size_t>(stream.tellg());
+    file.buffer_.resize(size);
+    stream.seekg(0);
+    if (!stream.read(reinterpret_cast<char*>(file.buffer_.data()),
+                     static_cast<std::streamsize>(size)))
+    {
+        return std::unexpected(openError(path, EIO));
+    }
+#endif
+
+    file.data_ = file.buffer_.data();
+    file.size_ = file.buffer_.size();
+    return file;
+}
+
+MappedFile MappedFile::fromBuffer(std::vector<std::byte> contents)
+{
+    MappedFile file;
+    file.buffer_ = std::move(contents);
+    file.data_ = file.buffer_.data();
+    file.size_ = file.buffer_.size();
+    return file;
+}
+
+Result<void> writeFileAtomically(const std::filesystem::path& path,
+                                 std::span<const std::byte> contents)
+{
+    std::error_code error;
+    if (path.has_parent_path())
+    {
+        std::filesystem::create_directories(path.parent_path(), error);
+    }
+
+    std::filesystem::path temporary = path;
+    temporary += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) +
+                 ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(contents.data()),
+                   static_cast<std::streamsize>(contents.size()));
+        file.close();
+        if (!file)
+        {
+            std::filesystem::remove(temporary, error);
+            return std::unexpected(
+                Error{.message = "Failed to write file", .context = temporary.string()});
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error)
+    {
+        const std::string reason = error.message();
+        std::filesystem::remove(temporary, error);
+        return std::unexpected(Error{.message = "Failed to write file",
+                                     .context = path.string() + " (" + reason + ")"});
+    }
+    return {};
+}
+
+} // namespace vibegl
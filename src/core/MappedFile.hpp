@@ -0,0 +1,86 @@
+#pragma once
+
+/// @file
+/// Read-only file contents backed by a memory mapping or a single read(), and the
+/// matching atomic write used by the caches.
+
+#include "Result.hpp"
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace vibegl {
+
+/// Read-only view of a whole file, shared by the asset loaders.
+///
+/// On desktop POSIX systems files of at least kMapThreshold bytes are mapped with mmap() and
+/// advised MADV_SEQUENTIAL and MADV_WILLNEED, so the kernel reads ahead and decoders work
+/// straight from the page cache with no heap copy. Smaller files (where a mapping costs
+/// more than it saves) and other platforms use one read into an owned buffer.
+///
+/// A mapped file must not be truncated while the view is alive (the access would raise
+/// SIGBUS); editors that save by rename, as the hot reload path expects, are fine.
+///
+/// Example:
+/// ```cpp
+/// auto file = MappedFile::open("data/textures/sample.png");
+/// if (file) { decode(file->bytes()); }
+/// ```
+class MappedFile {
+public:
+    /// Files at least this large are mapped instead of read.
+    static constexpr std::size_t kMapThreshold = 64 * 1024;
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /// Open a file and make its contents available.
+    /// @param path File to read
+    /// @return View on success, or Error with the path and errno description
+    static Result<MappedFile> open(const std::filesystem::path& path);
+
+    /// Wrap contents already in memory (e.g. a file just written) so they can be handed to
+    /// the same parsers as an opened file.
+    static MappedFile fromBuffer(std::vector<std::byte> contents);
+
+    /// File contents.
+    std::span<const std::byte> bytes() const { return {data_, size_}; }
+
+    /// File contents as text.
+    std::string_view text() const { return {reinterpret_cast<const char*>(data_), size_}; }
+
+    /// File size in bytes.
+    std::size_t size() const { return size_; }
+
+    /// Check whether the contents are a memory mapping rather than a heap copy.
+    bool isMapped() const { return mapping_ != nullptr; }
+
+private:
+    void release();
+
+    const std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+    void* mapping_ = nullptr;        ///< mmap() result, or nullptr when buffered
+    std::vector<std::byte> buffer_;  ///< Contents of small files
+};
+
+/// Replace a file's contents so that readers (and a crash) never see it half written.
+///
+/// The bytes go to a temporary file next to `path`, named per thread so concurrent writers
+/// of the same file do not interleave, which is then renamed over `path`. Missing parent
+/// directories are created. On failure the temporary file is removed and `path` is left
+/// as it was.
+/// @param path File to create or replace
+/// @param contents New contents
+/// @return Success, or Error with the path and reason
+Result<void> writeFileAtomically(const std::filesystem::path& path,
+                                 std::span<const std::byte> contents);
+
+} // namespace vibegl
@@ -0,0 +1,475 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <string_view>
+
+namespace vibegl
+{
+
+namespace
+{
+
+/// One ring buffer entry. Readers copy slots while the owner may be overwriting them, so
+/// every field is atomic and `sequence` acts as a per-slot seqlock: it is odd while the
+/// slot is being written and `2 * (index + 1)` once event `index` is complete.
+struct EventSlot {
+    std::atomic<std::size_t> sequence{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<std::int64_t> startNs{0};
+    std::atomic<std::int64_t> endNs{0};
+    std::atomic<std::uint32_t> depth{0};
+};
+
+/// Ring buffer owned by a single recording thread (or a track).
+struct ThreadBuffer {
+    explicit ThreadBuffer(std::size_t capacity) : events(capacity) {}
+
+    std::vector<EventSlot> events;  ///< Power-of-two sized
+    std::atomic<std::size_t> writeIndex{0};
+    std::atomic<const char*> name{nullptr};
+    std::uint32_t threadId = 0;
+    bool retired = false;  ///< Owning thread exited (guarded by the registry mutex)
+
+    std::size_t capacity() const { return events.size(); }
+    std::size_t firstRetained(std::size_t end) const
+    {
+        return end > capacity() ? end - capacity() : 0;
+    }
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;  ///< Never freed; index = threadId - 1
+    std::vector<ThreadBuffer*> retired;                  ///< Buffers of exited threads
+    std::size_t eventsPerThread = Profiler::kDefaultEventsPerThread;
+};
+
+Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+std::atomic<bool> gEnabled{true};
+std::atomic<std::int64_t> gFrameStartNs{0};
+std::atomic<std::int64_t> gPrevFrameStartNs{0};
+
+/// Hands the calling thread's buffer back to the registry when the thread exits.
+struct BufferOwner {
+    ThreadBuffer* buffer = nullptr;
+
+    BufferOwner() = default;
+    ~BufferOwner();
+    BufferOwner(const BufferOwner&) = delete;
+    BufferOwner& operator=(const BufferOwner&) = delete;
+    BufferOwner(BufferOwner&&) = delete;
+    BufferOwner& operator=(BufferOwner&&) = delete;
+};
+
+thread_local ThreadBuffer* tThreadBuffer = nullptr;
+thread_local const char* tThreadName = nullptr;
+thread_local BufferOwner tBufferOwner;  // Only touched when the buffer is created
+thread_local std::uint32_t tDepth = 0;
+
+/// Append a new buffer. Call with the registry mutex held.
+ThreadBuffer* addBuffer(Registry& reg, std::size_t capacity, const char* name)
+{
+    auto buffer = std::make_unique<ThreadBuffer>(capacity);
+    buffer->threadId = static_cast<std::uint32_t>(reg.buffers.size()) + 1;
+    buffer->name.store(name, std::memory_order_relaxed);
+    reg.buffers.push_back(std::move(buffer));
+    return reg.buffers.back().get();
+}
+
+/// Give the calling thread a buffer, reusing one left by an exited thread when one of the
+/// current size is free. Buffers are never freed, so readers outside the lock stay valid.
+ThreadBuffer* acquireBuffer(const char* name)
+{
+    Registry& reg = registry();
+    const std::scoped_lock lock(reg.mutex);
+    // Most recently exited first, so long-gone threads are the ones kept in traces
+    const auto free = std::ranges::find(reg.retired | std::views::reverse, reg.eventsPerThread,
+                                        &ThreadBuffer::capacity);
+    if (free.base() == reg.retired.begin())
+    {
+        return addBuffer(reg, reg.eventsPerThread, name);
+    }
+
+    // The exited thread's history leaves the trace from here on; readers that still hold
+    // old indices see slots fail the sequence check or read complete events
+    ThreadBuffer* buffer = *free;
+    reg.retired.erase(std::prev(free.base()));
+    buffer->retired = false;
+    buffer->writeIndex.store(0, std::memory_order_release);
+    buffer->name.store(name, std::memory_order_release);
+    return buffer;
+}
+
+BufferOwner::~BufferOwner()
+{
+    if (buffer != nullptr)
+    {
+        Registry& reg = registry();
+        const std::scoped_lock lock(reg.mutex);
+        buffer->retired = true;
+        reg.retired.push_back(buffer);
+    }
+}
+
+ThreadBuffer& threadBuffer()
+{
+    if (tThreadBuffer == nullptr)
+    {
+        tThreadBuffer = acquireBuffer(tThreadName);
+        tBufferOwner.buffer = tThreadBuffer;
+    }
+    return *tThreadBuffer;
+}
+
+void push(ThreadBuffer& buffer, const Profiler::Event& event)
+{
+    const std::size_t index = buffer.writeIndex.load(std::memory_order_relaxed);
+    EventSlot& slot = buffer.events[index & (buffer.capacity() - 1)];
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(event.name, std::memory_order_relaxed);
+    slot.startNs.store(event.startNs, std::memory_order_relaxed);
+    slot.endNs.store(event.endNs, std::memory_order_relaxed);
+    slot.depth.store(event.depth, std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+    buffer.writeIndex.store(index + 1, std::memory_order_release);
+}
+
+/// Copy event `index` out of a buffer.
+/// @return False if the slot no longer (or not yet) holds that event in full
+bool readEvent(const ThreadBuffer& buffer, std::size_t index, Profiler::Event& out)
+{
+    const EventSlot& slot = buffer.events[index & (buffer.capacity() - 1)];
+    const std::size_t expected = 2 * index + 2;
+    if (slot.sequence.load(std::memory_order_acquire) != expected)
+    {
+        return false;
+    }
+    out = Profiler::Event{.name = slot.name.load(std::memory_order_relaxed),
+                          .startNs = slot.startNs.load(std::memory_order_relaxed),
+                          .endNs = slot.endNs.load(std::memory_order_relaxed),
+                          .depth = slot.depth.load(std::memory_order_relaxed)};
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == expected;
+}
+
+/// Copy the retained events of a buffer, dropping any slot overwritten during the copy.
+std::vector<Profiler::Event> snapshot(const ThreadBuffer& buffer)
+{
+    const std::size_t end = buffer.writeIndex.load(std::memory_order_acquire);
+    const std::size_t begin = buffer.firstRetained(end);
+
+    // The owning thread keeps writing while we copy; slots it lapped fail the sequence check
+    std::vector<Profiler::Event> events;
+    events.reserve(end - begin);
+    Profiler::Event event;
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        if (readEvent(buffer, i, event))
+        {
+            events.push_back(event);
+        }
+    }
+    return events;
+}
+
+/// Aggregate a buffer's events that fall inside the last completed frame.
+Profiler::ZoneList collectFrameZones(const ThreadBuffer& buffer,
+                                     std::pmr::memory_resource* memory)
+{
+    const std::int64_t frameBegin = gPrevFrameStartNs.load(std::memory_order_relaxed);
+    const std::int64_t frameEnd = gFrameStartNs.load(std::memory_order_relaxed);
+
+    std::pmr::vector<Profiler::Event> frameEvents(memory);
+    if (frameBegin != 0)
+    {
+        // Events are stored in completion order, so walk back until we leave the frame
+        const std::size_t end = buffer.writeIndex.load(std::memory_order_acquire);
+        const std::size_t begin = buffer.firstRetained(end);
+        Profiler::Event event;
+        for (std::size_t i = end; i > begin; --i)
+        {
+            // Another thread's buffer may have been lapped while we read it
+            if (!readEvent(buffer, i - 1, event))
+            {
+                frameEvents.clear();
+                break;
+            }
+            if (event.endNs < frameBegin)
+            {
+                break;
+            }
+            if (event.startNs >= frameBegin && event.endNs <= frameEnd)
+            {
+                frameEvents.push_back(event);
+            }
+        }
+    }
+
+    std::ranges::sort(frameEvents, {}, &Profiler::Event::startNs);
+
+    Profiler::ZoneList zones(memory);
+    for (const Profiler::Event& event : frameEvents)
+    {
+        auto it = std::ranges::find_if(zones, [&](const Profiler::ZoneTiming& zone)
+                                       { return std::strcmp(zone.name, event.name) == 0; });
+        if (it == zones.end())
+        {
+            zones.push_back(Profiler::ZoneTiming{.name = event.name, .depth = event.depth});
+            it = zones.end() - 1;
+        }
+        it->milliseconds += static_cast<double>(event.endNs - event.startNs) * 1e-6;
+        ++it->calls;
+    }
+    return zones;
+}
+
+void writeJsonString(std::ostream& out, const char* text)
+{
+    out << '"';
+    for (const char* c = text; *c != '\0'; ++c)
+    {
+        const auto byte = static_cast<unsigned char>(*c);
+        if (*c == '"' || *c == '\\')
+        {
+            out << '\\' << *c;
+        }
+        else if (byte < 0x20)
+        {
+            // Control characters are not allowed raw inside JSON strings
+            constexpr std::string_view kHex = "0123456789abcdef";
+            out << "\\u00" << kHex[byte >> 4U] << kHex[byte & 0xFU];
+        }
+        else
+        {
+            out << *c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+std::int64_t Profiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void Profiler::record(const char* name, std::int64_t startNs, std::int64_t endNs,
+                      std::uint32_t depth)
+{
+    if (!gEnabled.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    push(threadBuffer(), Event{.name = name, .startNs = startNs, .endNs = endNs, .depth = depth});
+}
+
+void Profiler::setEventsPerThread(std::size_t count)
+{
+    Registry& reg = registry();
+    const std::scoped_lock lock(reg.mutex);
+    reg.eventsPerThread = std::bit_ceil(std::max<std::size_t>(count, 2));
+}
+
+std::size_t Profiler::eventsPerThread()
+{
+    Registry& reg = registry();
+    const std::scoped_lock lock(reg.mutex);
+    return reg.eventsPerThread;
+}
+
+Profiler::TrackId Profiler::createTrack(const char* name)
+{
+    Registry& reg = registry();
+    const std::scoped_lock lock(reg.mutex);
+    return addBuffer(reg, reg.eventsPerThread, name)->threadId;
+}
+
+void Profiler::recordOnTrack(TrackId track, const char* name, std::int64_t startNs,
+                             std::int64_t endNs, std::uint32_t depth)
+{
+    if (!gEnabled.load(std::memory_order_relaxed) || track == 0)
+    {
+        return;
+    }
+
+    // Tracks are written a handful of times per frame, so a locked lookup is fine here
+    ThreadBuffer* buffer = nullptr;
+    {
+        Registry& reg = registry();
+        const std::scoped_lock lock(reg.mutex);
+        if (track <= reg.buffers.size())
+        {
+            buffer = reg.buffers[track - 1].get();
+        }
+    }
+    if (buffer != nullptr)
+    {
+        push(*buffer, Event{.name = name, .startNs = startNs, .endNs = endNs, .depth = depth});
+    }
+}
+
+void Profiler::setThreadName(const char* name)
+{
+    // Threads that never record (or not yet) get no buffer; the name is applied on creation
+    tThreadName = name;
+    if (tThreadBuffer != nullptr)
+    {
+        tThreadBuffer->name.store(name, std::memory_order_release);
+    }
+}
+
+void Profiler::markFrame()
+{
+    const std::int64_t timestamp = now();
+    gPrevFrameStartNs.store(gFrameStartNs.load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+    gFrameStartNs.store(timestamp, std::memory_order_relaxed);
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+    gEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::isEnabled()
+{
+    return gEnabled.load(std::memory_order_relaxed);
+}
+
+Profiler::ZoneList Profiler::lastFrameZones(std::pmr::memory_resource* memory)
+{
+    return tThreadBuffer != nullptr ? collectFrameZones(*tThreadBuffer, memory)
+                                    : ZoneList(memory);
+}
+
+Profiler::ZoneList Profiler::lastFrameZones(const char* threadName,
+                                            std::pmr::memory_resource* memory)
+{
+    const ThreadBuffer* found = nullptr;
+    {
+        Registry& reg = registry();
+        const std::scoped_lock lock(reg.mutex);
+        // A name can be reused by a restarted thread; exited threads record nothing more
+        for (const auto& buffer : reg.buffers | std::views::reverse)
+        {
+            const char* name = buffer->name.load(std::memory_order_acquire);
+            if (!buffer->retired && name != nullptr && std::strcmp(name, threadName) == 0)
+            {
+                found = buffer.get();
+                break;
+            }
+        }
+    }
+    return found != nullptr ? collectFrameZones(*found, memory) : ZoneList(memory);
+}
+
+double Profiler::lastFrameMilliseconds()
+{
+    const std::int64_t frameBegin = gPrevFrameStartNs.load(std::memory_order_relaxed);
+    const std::int64_t frameEnd = gFrameStartNs.load(std::memory_order_relaxed);
+    if (frameBegin == 0)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(frameEnd - frameBegin) * 1e-6;
+}
+
+Result<void> Profiler::writeChromeTrace(const std::string& path)
+{
+    struct ThreadEvents {
+        std::uint32_t threadId;
+        const char* name;
+        std::vector<Event> events;
+    };
+
+    std::vector<ThreadEvents> threads;
+    {
+        Registry& reg = registry();
+        const std::scoped_lock lock(reg.mutex);
+        for (const auto& buffer : reg.buffers)
+        {
+            threads.push_back(ThreadEvents{.threadId = buffer->threadId,
+                                           .name = buffer->name.load(std::memory_order_acquire),
+                                           .events = snapshot(*buffer)});
+        }
+    }
+
+    std::int64_t originNs = 0;
+    for (const ThreadEvents& thread : threads)
+    {
+        for (const Event& event : thread.events)
+        {
+            if (originNs == 0 || event.startNs < originNs)
+            {
+                originNs = event.startNs;
+            }
+        }
+    }
+
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        return std::unexpected(Error{.message = "Failed to open trace file", .context = path});
+    }
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const ThreadEvents& thread : threads)
+    {
+        if (thread.name != nullptr)
+        {
+            file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                 << "\"tid\":" << thread.threadId << ",\"args\":{\"name\":";
+            writeJsonString(file, thread.name);
+            file << "}}";
+            first = false;
+        }
+        for (const Event& event : thread.events)
+        {
+            file << (first ? "" : ",") << "\n{\"name\":";
+            writeJsonString(file, event.name);
+            file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.threadId
+                 << ",\"ts\":" << static_cast<double>(event.startNs - originNs) * 1e-3
+                 << ",\"dur\":" << static_cast<double>(event.endNs - event.startNs) * 1e-3 << "}";
+            first = false;
+        }
+    }
+    file << "\n]}\n";
+
+    if (!file)
+    {
+        return std::unexpected(Error{.message = "Failed to write trace file", .context = path});
+    }
+    return {};
+}
+
+Profiler::Scope::Scope(const char* name) : name_(name), startNs_(now()), depth_(tDepth++) {}
+
+Profiler::Scope::~Scope()
+{
+    --tDepth;
+    record(name_, startNs_, now(), depth_);
+}
+
+} // namespace vibegl
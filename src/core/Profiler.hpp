@@ -0,0 +1,167 @@
+#pragma once
+
+/// @file
+/// Scoped CPU zone profiler with Chrome trace export.
+///
+/// Zones are recorded into per-thread ring buffers (single writer, no locks on the
+/// hot path) with nanosecond `steady_clock` timestamps. The buffers hold the most
+/// recent history of every thread and can be dumped at any time as a Chrome
+/// `about:tracing` / Perfetto JSON file. A thread gets its buffer with its first event;
+/// when the thread exits the buffer stays in traces until a new thread takes it over, so
+/// restarting worker threads does not grow memory.
+///
+/// Example:
+/// ```cpp
+/// void MyApp::renderScene() {
+///     VIBEGL_PROFILE_SCOPE("renderScene");
+///     // ...
+/// }
+///
+/// Profiler::writeChromeTrace("trace.json");  // open in ui.perfetto.dev
+/// ```
+
+#include "Result.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace vibegl {
+
+/// Process-wide CPU zone profiler.
+///
+/// All methods are thread-safe. Recording only touches the calling thread's buffer;
+/// the registry mutex is taken twice per thread (on its first event and when it exits), on
+/// export, and for the low-frequency track writes made by the GPU profiler.
+class Profiler {
+public:
+    /// A completed zone as stored in a thread buffer.
+    struct Event {
+        const char* name = nullptr;  ///< Zone name (must have static storage duration)
+        std::int64_t startNs = 0;    ///< Start timestamp in nanoseconds
+        std::int64_t endNs = 0;      ///< End timestamp in nanoseconds
+        std::uint32_t depth = 0;     ///< Nesting depth on the recording thread
+    };
+
+    /// Aggregated timing of one zone over the last completed frame.
+    struct ZoneTiming {
+        const char* name = nullptr;  ///< Zone name
+        double milliseconds = 0.0;   ///< Total time spent in the zone
+        std::uint32_t calls = 0;     ///< Number of times the zone was entered
+        std::uint32_t depth = 0;     ///< Nesting depth of the first occurrence
+    };
+
+    /// Aggregated zones of one frame.
+    using ZoneList = std::pmr::vector<ZoneTiming>;
+
+    /// Identifies a named timeline that is not tied to a CPU thread (e.g. the GPU).
+    using TrackId = std::uint32_t;
+
+    /// Events retained per thread before the oldest are overwritten, unless changed with
+    /// setEventsPerThread().
+    static constexpr std::size_t kDefaultEventsPerThread = std::size_t{1} << 16;
+
+    /// Set the ring buffer size of threads that start recording from now on.
+    /// @param count Events per thread, rounded up to a power of two (at least 2)
+    static void setEventsPerThread(std::size_t count);
+
+    /// Ring buffer size given to threads that start recording from now on.
+    static std::size_t eventsPerThread();
+
+    /// Current timestamp in nanoseconds on the profiler clock (`steady_clock`).
+    static std::int64_t now();
+
+    /// Record a completed zone on the calling thread.
+    /// @param name Zone name (string literal or other static storage)
+    /// @param startNs Start timestamp from now()
+    /// @param endNs End timestamp from now()
+    /// @param depth Nesting depth of the zone
+    static void record(const char* name, std::int64_t startNs, std::int64_t endNs,
+                       std::uint32_t depth = 0);
+
+    /// Create a named track for events recorded on behalf of another timeline.
+    /// @param name Track name shown in exported traces (static storage)
+    /// @return Track identifier for recordOnTrack()
+    static TrackId createTrack(const char* name);
+
+    /// Record a completed zone on a track created with createTrack().
+    /// Each track must only be written from one thread at a time.
+    /// @param track Track identifier
+    /// @param name Zone name (static storage)
+    /// @param startNs Start timestamp on the profiler clock
+    /// @param endNs End timestamp on the profiler clock
+    /// @param depth Nesting depth of the zone
+    static void recordOnTrack(TrackId track, const char* name, std::int64_t startNs,
+                              std::int64_t endNs, std::uint32_t depth = 0);
+
+    /// Name the calling thread in exported traces. Does not allocate the thread's buffer.
+    /// @param name Thread name (string literal or other static storage)
+    static void setThreadName(const char* name);
+
+    /// Mark a frame boundary. Call once per frame from the main loop.
+    static void markFrame();
+
+    /// Enable or disable recording globally (enabled by default).
+    static void setEnabled(bool enabled);
+
+    /// Check whether recording is enabled.
+    static bool isEnabled();
+
+    /// Collect zone timings of the last completed frame recorded on the calling thread.
+    /// @param memory Allocator for the result (e.g. a FrameArena resource)
+    /// @return Zones in the order they were entered, aggregated by name
+    static ZoneList lastFrameZones(
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /// Collect zone timings of the last completed frame recorded on a named thread.
+    /// @param threadName Name given to setThreadName() on that thread
+    /// @param memory Allocator for the result (e.g. a FrameArena resource)
+    /// @return Zones in the order they were entered, or empty if no running thread with
+    ///         that name has recorded anything. If several running threads use the name,
+    ///         the most recently registered one wins.
+    static ZoneList lastFrameZones(
+        const char* threadName,
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /// Duration of the last completed frame in milliseconds.
+    static double lastFrameMilliseconds();
+
+    /// Write all buffered events as Chrome trace JSON.
+    /// @param path Output file path
+    /// @return Success, or Error if the file could not be written
+    static Result<void> writeChromeTrace(const std::string& path);
+
+    /// RAII helper that records a zone for the lifetime of the object.
+    class Scope {
+    public:
+        explicit Scope(const char* name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+        Scope& operator=(Scope&&) = delete;
+
+    private:
+        const char* name_;
+        std::int64_t startNs_;
+        std::uint32_t depth_;
+    };
+};
+
+} // namespace vibegl
+
+#define VIBEGL_PROFILE_CONCAT_INNER(a, b) a##b
+#define VIBEGL_PROFILE_CONCAT(a, b) VIBEGL_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef VIBEGL_ENABLE_PROFILER
+/// Profile the enclosing scope under the given name.
+#define VIBEGL_PROFILE_SCOPE(name)                                                                 \
+    const ::vibegl::Profiler::Scope VIBEGL_PROFILE_CONCAT(vibeglProfileScope, __LINE__)(name)
+/// Profile the enclosing function under its own name.
+#define VIBEGL_PROFILE_FUNCTION() VIBEGL_PROFILE_SCOPE(__func__)
+#else
+#define VIBEGL_PROFILE_SCOPE(name) static_cast<void>(0)
+#define VIBEGL_PROFILE_FUNCTION() static_cast<void>(0)
+#endif
@@ -0,0 +1,125 @@
+#include "ProfilerOverlay.hpp"
+
+#include <imgui.h>
+
+#include <spdlog/spdlog.h>
+
+#include <memory_resource>
+
+#include "FrameArena.hpp"
+#include "GpuProfiler.hpp"
+#include "Profiler.hpp"
+
+namespace vibegl
+{
+
+namespace
+{
+
+void drawZoneTable(const char* id, const char* header,
+                   const Profiler::ZoneList& zones)
+{
+    if (!ImGui::BeginTable(id, 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp))
+    {
+        return;
+    }
+
+    ImGui::TableSetupColumn(header);
+    ImGui::TableSetupColumn("ms");
+    ImGui::TableSetupColumn("calls");
+    ImGui::TableHeadersRow();
+    for (const Profiler::ZoneTiming& zone : zones)
+    {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+        ImGui::Text("%*s%s", static_cast<int>(zone.depth * 2), "", zone.name);
+        ImGui::TableNextColumn();
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+        ImGui::Text("%.3f", zone.milliseconds);
+        ImGui::TableNextColumn();
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+        ImGui::Text("%u", zone.calls);
+    }
+    ImGui::EndTable();
+}
+
+void drawArenaStats(const FrameArena::Stats& stats)
+{
+    constexpr double kKiB = 1.0 / 1024.0;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    ImGui::Text("Frame arena: %.1f KiB (high water %.1f / %.1f KiB per thread)",
+                static_cast<double>(stats.lastFrameBytes) * kKiB,
+                static_cast<double>(stats.highWaterBytes) * kKiB,
+                static_cast<double>(stats.capacityPerThread) * kKiB);
+    if (stats.overflowAllocations > 0)
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+        ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f),
+                           "Overflow: %.1f KiB last frame, %llu heap fallbacks",
+                           static_cast<double>(stats.lastFrameOverflowBytes) * kKiB,
+                           static_cast<unsigned long long>(stats.overflowAllocations));
+    }
+}
+
+} // namespace
+
+void drawProfilerOverlay(FrameArena* arena)
+{
+    std::pmr::memory_resource* memory =
+        arena != nullptr ? arena->resource() : std::pmr::get_default_resource();
+
+    ImGui::SetNextWindowPos(ImVec2(20.0f, 20.0f), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(340.0f, 240.0f), ImGuiCond_FirstUseEver);
+    ImGui::Begin("Profiler");
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    ImGui::Text("Frame: %.3f ms", Profiler::lastFrameMilliseconds());
+
+    bool enabled = Profiler::isEnabled();
+    if (ImGui::Checkbox("Record", &enabled))
+    {
+        Profiler::setEnabled(enabled);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Save Trace (F12)"))
+    {
+        auto result = Profiler::writeChromeTrace(kDefaultTracePath);
+        if (!result)
+        {
+            spdlog::error("{} - {}", result.error().message, result.error().context);
+        }
+        else
+        {
+            spdlog::info("Wrote Chrome trace: {}", kDefaultTracePath);
+        }
+    }
+    if (arena != nullptr)
+    {
+        drawArenaStats(arena->stats());
+    }
+    ImGui::Separator();
+
+    drawZoneTable("cpu_zones", "CPU zone", Profiler::lastFrameZones(memory));
+
+    const Profiler::ZoneList renderZones = Profiler::lastFrameZones("Render", memory);
+    if (!renderZones.empty())
+    {
+        ImGui::Separator();
+        drawZoneTable("render_zones", "Render thread zone", renderZones);
+    }
+
+    if (GpuProfiler::isSupported())
+    {
+        ImGui::Separator();
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+        ImGui::Text("GPU: %.3f ms (%zu frames behind, %llu dropped)",
+                    GpuProfiler::lastFrameMilliseconds(), GpuProfiler::kFrameLatency,
+                    static_cast<unsigned long long>(GpuProfiler::droppedFrames()));
+        drawZoneTable("gpu_zones", "GPU zone", GpuProfiler::lastFrameZones(memory));
+    }
+
+    ImGui::End();
+}
+
+} // namespace vibegl
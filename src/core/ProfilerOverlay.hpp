@@ -0,0 +1,22 @@
+#pragma once
+
+/// @file
+/// ImGui window displaying per-frame CPU and GPU profiler zone timings.
+
+namespace vibegl {
+
+class FrameArena;
+
+/// Draw the profiler overlay window.
+///
+/// Shows the last completed frame's CPU zones recorded on the calling thread and on the
+/// render thread (if any), the most recently resolved GPU zones, and a button that dumps
+/// the buffered history as a Chrome trace. Call between ImGui::NewFrame() and
+/// ImGui::Render().
+/// @param arena Optional frame arena whose usage is shown and which backs the zone lists
+void drawProfilerOverlay(FrameArena* arena = nullptr);
+
+/// File name used when a Chrome trace is requested from the overlay or the F12 key.
+inline constexpr const char* kDefaultTracePath = "vibegl_trace.json";
+
+} // namespace vibegl
@@ -0,0 +1,43 @@
+#include "Simd.hpp"
+
+#include <atomic>
+
+namespace vibegl
+{
+
+namespace
+{
+
+std::atomic<bool>& simdSwitch()
+{
+    static std::atomic<bool> enabled{true};
+    return enabled;
+}
+
+} // namespace
+
+bool Simd::available()
+{
+#ifdef VIBEGL_SSE2
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Simd::setEnabled(bool enabled)
+{
+    simdSwitch().store(enabled);
+}
+
+bool Simd::enabled()
+{
+    return simdSwitch().load();
+}
+
+bool Simd::active()
+{
+    return available() && enabled();
+}
+
+} // namespace vibegl
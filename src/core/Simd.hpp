@@ -0,0 +1,32 @@
+#pragma once
+
+/// @file
+/// SSE2 detection and the process-wide switch shared by the SIMD kernels.
+///
+/// Kernels test `VIBEGL_SSE2` at compile time to include their intrinsics, and
+/// Simd::active() at run time to choose between them and the scalar fallback.
+/// Both paths produce identical output.
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define VIBEGL_SSE2 1
+#endif
+
+namespace vibegl {
+
+/// Run-time selection of the SSE2 kernels (MipGenerator, BlockEncoder).
+class Simd {
+public:
+    /// Check whether this build has the SSE2 kernels.
+    static bool available();
+
+    /// Use the SSE2 kernels when available (default) or force the scalar ones, e.g. to
+    /// benchmark them against each other.
+    static void setEnabled(bool enabled);
+    static bool enabled();
+
+    /// Check whether kernels should take their SSE2 path (available and enabled).
+    static bool active();
+};
+
+} // namespace vibegl
@@ -3,18 +3,209 @@
 
 #include <spdlog/spdlog.h>
 
+#include <charconv>
+#include <cstdint>
 #include <exception>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
 
 #include "VibeGLApp.hpp"
+#include "rendering/ShaderManager.hpp"
+#include "rendering/TextureLoader.hpp"
 
-int main()
+/// Parse a whole string as a number.
+/// @return The value, or nullopt if the text is empty, malformed or has trailing characters
+template <typename T>
+static std::optional<T> parseNumber(std::string_view text)
+{
+    T value{};
+    const char* end = text.data() + text.size();
+    const auto [ptr, ec] = std::from_chars(text.data(), end, value);
+    if (ec != std::errc{} || ptr != end)
+    {
+        return std::nullopt;
+    }
+    return value;
+}
+
+/// Parse command line options into a window configuration.
+///
+/// Supported options:
+/// - `--headless`: render offscreen without a window (for display-less machines)
+/// - `--readback`: read every headless frame back to CPU memory
+/// - `--frames N`: exit after N frames
+/// - `--size WxH`: window or offscreen target size
+/// - `--threaded`: render on a dedicated thread
+/// - `--on-demand`: only render on input or when the app requests a redraw
+/// - `--present vsync|adaptive|immediate`: swap interval policy
+/// - `--frames-in-flight N`: GPU queue depth (1 = lowest latency, 3 = highest throughput)
+/// - `--shaders-from-disk`: read shaders from data/shaders instead of the embedded copies
+///   (enables hot reload in builds with embedded shaders)
+/// - `--gl-mipmaps`: build texture mip chains with glGenerateMipmap() instead of on workers
+/// - `--compress-textures auto|bc1|bc3|bc7`: encode images without a KTX2 counterpart to
+///   BCn at load time and cache the result (auto: BC1 if opaque, else BC3)
+/// - `--compress-quality fast|normal|high`: encoder effort for `--compress-textures`
+static vibegl::WindowConfig parseArguments(std::span<char*> args)
+{
+    vibegl::WindowConfig config;
+    for (std::size_t i = 1; i < args.size(); ++i)
+    {
+        const std::string_view arg = args[i];
+        const bool hasValue = i + 1 < args.size();
+        if (arg == "--headless")
+        {
+            config.headless = true;
+        }
+        else if (arg == "--readback")
+        {
+            config.headlessReadback = true;
+        }
+        else if (arg == "--threaded")
+        {
+            config.threadedRendering = true;
+        }
+        else if (arg == "--on-demand")
+        {
+            config.renderMode = vibegl::RenderMode::OnDemand;
+        }
+        else if (arg == "--shaders-from-disk")
+        {
+            vibegl::ShaderManager::setEmbeddedShadersEnabled(false);
+        }
+        else if (arg == "--gl-mipmaps")
+        {
+            vibegl::TextureLoader::setCpuMipmapsEnabled(false);
+        }
+        else if (arg == "--compress-textures" && hasValue)
+        {
+            const std::string_view value = args[++i];
+            vibegl::TextureCompression compression = vibegl::TextureLoader::compression();
+            compression.enabled = true;
+            if (value == "bc1")
+            {
+                compression.format = vibegl::BlockFormat::BC1;
+            }
+            else if (value == "bc3")
+            {
+                compression.format = vibegl::BlockFormat::BC3;
+            }
+            else if (value == "bc7")
+            {
+                compression.format = vibegl::BlockFormat::BC7;
+            }
+            else
+            {
+                if (value != "auto")
+                {
+                    spdlog::warn("Unknown --compress-textures value '{}', using auto", value);
+                }
+                compression.format = std::nullopt;
+            }
+            vibegl::TextureLoader::setCompression(std::move(compression));
+        }
+        else if (arg == "--compress-quality" && hasValue)
+        {
+            const std::string_view value = args[++i];
+            vibegl::TextureCompression compression = vibegl::TextureLoader::compression();
+            if (value == "fast")
+            {
+                compression.quality = vibegl::BlockQuality::Fast;
+            }
+            else if (value == "high")
+            {
+                compression.quality = vibegl::BlockQuality::High;
+            }
+            else
+            {
+                if (value != "normal")
+                {
+                    spdlog::warn("Unknown --compress-quality value '{}', using normal", value);
+                }
+                compression.quality = vibegl::BlockQuality::Normal;
+            }
+            vibegl::TextureLoader::setCompression(std::move(compression));
+        }
+        else if (arg == "--present" && hasValue)
+        {
+            const std::string_view value = args[++i];
+            if (value == "adaptive")
+            {
+                config.presentMode = vibegl::PresentMode::Adaptive;
+            }
+            else if (value == "immediate")
+            {
+                config.presentMode = vibegl::PresentMode::Immediate;
+            }
+            else
+            {
+                if (value != "vsync")
+                {
+                    spdlog::warn("Unknown --present value '{}', using vsync", value);
+                }
+                config.presentMode = vibegl::PresentMode::Vsync;
+            }
+        }
+        else if (arg == "--frames-in-flight" && hasValue)
+        {
+            const std::string_view value = args[++i];
+            const auto frames = parseNumber<int>(value);
+            if (frames && *frames >= 1 && *frames <= 3)
+            {
+                config.maxFramesInFlight = *frames;
+            }
+            else
+            {
+                spdlog::warn("Ignoring invalid --frames-in-flight value (expected 1-3): {}", value);
+            }
+        }
+        else if (arg == "--frames" && hasValue)
+        {
+            const std::string_view value = args[++i];
+            if (const auto frames = parseNumber<std::uint64_t>(value))
+            {
+                config.maxFrames = *frames;
+            }
+            else
+            {
+                spdlog::warn("Ignoring malformed --frames value: {}", value);
+            }
+        }
+        else if (arg == "--size" && hasValue)
+        {
+            const std::string_view value = args[++i];
+            const auto x = value.find('x');
+            const auto width =
+                x != std::string_view::npos ? parseNumber<int>(value.substr(0, x)) : std::nullopt;
+            const auto height =
+                x != std::string_view::npos ? parseNumber<int>(value.substr(x + 1)) : std::nullopt;
+            if (width && height && *width > 0 && *height > 0)
+            {
+                config.width = *width;
+                config.height = *height;
+            }
+            else
+            {
+                spdlog::warn("Ignoring malformed --size value (expected WxH): {}", value);
+            }
+        }
+        else
+        {
+            spdlog::warn("Ignoring unknown argument: {}", arg);
+        }
+    }
+    return config;
+}
+
+int main(int argc, char* argv[])
 {
     spdlog::set_level(spdlog::level::info);
     spdlog::info("Starting VibeGL...");
 
     try
     {
-        vibegl::VibeGLApp app;
+        vibegl::VibeGLApp app(parseArguments(std::span(argv, static_cast<std::size_t>(argc))));
         app.run();
     }
     catch (const std::exception& e)
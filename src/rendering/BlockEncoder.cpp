@@ -0,0 +1,674 @@
+#include "BlockEncoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "../core/JobSystem.hpp"
+#include "../core/Profiler.hpp"
+#include "../core/Simd.hpp"
+
+namespace vibegl
+{
+
+namespace
+{
+
+constexpr int kBlockSize = 4;
+constexpr std::size_t kTexels = 16;
+
+/// Images with fewer blocks are not worth splitting across workers.
+constexpr std::size_t kParallelBlocks = 256;
+
+/// Blocks per parallelFor chunk.
+constexpr std::size_t kBlocksPerChunk = 64;
+
+/// BC7 mode 6 interpolation weights (out of 64) for 4-bit indices.
+constexpr std::array<int, 16> kBc7Weights = {0,  4,  9,  13, 17, 21, 26, 30,
+                                             34, 38, 43, 47, 51, 55, 60, 64};
+
+using Color = std::array<float, 4>;
+
+/// One 4x4 block of texels, channels 0-255.
+struct Block {
+    std::array<Color, kTexels> texels{};
+};
+
+/// Palette in structure-of-arrays form so four entries can be compared at once.
+struct Palette {
+    static constexpr std::size_t kMaxEntries = 16;
+    alignas(16) std::array<std::array<float, kMaxEntries>, 4> channels{};
+    std::size_t count = 0;
+};
+
+/// Texel indices into a palette and the squared error they leave.
+struct IndexFit {
+    std::array<std::uint8_t, kTexels> indices{};
+    float error = std::numeric_limits<float>::max();
+};
+
+struct Endpoints {
+    Color e0{};
+    Color e1{};
+};
+
+/// Distances from one texel to every palette entry over channels [first, first + count).
+void distancesScalar(const Palette& palette, const Color& texel, std::size_t first,
+                     std::size_t count, float* distances)
+{
+    for (std::size_t entry = 0; entry < palette.count; ++entry)
+    {
+        float distance = 0.0f;
+        for (std::size_t c = first; c < first + count; ++c)
+        {
+            const float diff = palette.channels[c - first][entry] - texel[c];
+            distance += diff * diff;
+        }
+        distances[entry] = distance;
+    }
+}
+
+#ifdef VIBEGL_SSE2
+/// Same sums as distancesScalar() in the same order, four entries per step.
+void distancesSse2(const Palette& palette, const Color& texel, std::size_t first,
+                   std::size_t count, float* distances)
+{
+    for (std::size_t entry = 0; entry < palette.count; entry += 4)
+    {
+        __m128 distance = _mm_setzero_ps();
+        for (std::size_t c = first; c < first + count; ++c)
+        {
+            const __m128 diff = _mm_sub_ps(_mm_load_ps(&palette.channels[c - first][entry]),
+                                           _mm_set1_ps(texel[c]));
+            distance = _mm_add_ps(distance, _mm_mul_ps(diff, diff));
+        }
+        _mm_storeu_ps(distances + entry, distance);
+    }
+}
+#endif
+
+/// Nearest palette entry for every texel of a block.
+IndexFit selectIndices(const Block& block, const Palette& palette, std::size_t first,
+                       std::size_t count, bool simd)
+{
+    IndexFit fit;
+    fit.error = 0.0f;
+    // Padded to whole SSE vectors
+    std::array<float, Palette::kMaxEntries> distances{};
+    for (std::size_t t = 0; t < kTexels; ++t)
+    {
+#ifdef VIBEGL_SSE2
+        if (simd)
+        {
+            distancesSse2(palette, block.texels[t], first, count, distances.data());
+        }
+        else
+        {
+            distancesScalar(palette, block.texels[t], first, count, distances.data());
+        }
+#else
+        static_cast<void>(simd);
+        distancesScalar(palette, block.texels[t], first, count, distances.data());
+#endif
+        std::size_t best = 0;
+        for (std::size_t entry = 1; entry < palette.count; ++entry)
+        {
+            if (distances[entry] < distances[best])
+            {
+                best = entry;
+            }
+        }
+        fit.indices[t] = static_cast<std::uint8_t>(best);
+        fit.error += distances[best];
+    }
+    return fit;
+}
+
+float clampChannel(float value)
+{
+    return std::clamp(value, 0.0f, 255.0f);
+}
+
+Endpoints boundingBox(const Block& block, std::size_t first, std::size_t count)
+{
+    Endpoints ends;
+    for (std::size_t c = first; c < first + count; ++c)
+    {
+        ends.e0[c] = 0.0f;
+        ends.e1[c] = 255.0f;
+        for (const Color& texel : block.texels)
+        {
+            ends.e0[c] = std::max(ends.e0[c], texel[c]);
+            ends.e1[c] = std::min(ends.e1[c], texel[c]);
+        }
+    }
+    return ends;
+}
+
+/// Endpoints spanning the block's texels along their principal axis.
+Endpoints principalAxis(const Block& block, std::size_t first, std::size_t count)
+{
+    Color mean{};
+    for (const Color& texel : block.texels)
+    {
+        for (std::size_t c = first; c < first + count; ++c)
+        {
+            mean[c] += texel[c];
+        }
+    }
+    for (float& value : mean)
+    {
+        value /= static_cast<float>(kTexels);
+    }
+
+    std::array<Color, 4> covariance{};
+    for (const Color& texel : block.texels)
+    {
+        for (std::size_t i = first; i < first + count; ++i)
+        {
+            for (std::size_t j = first; j < first + count; ++j)
+            {
+                covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+            }
+        }
+    }
+
+    // Power iteration from the bounding-box diagonal
+    const Endpoints box = boundingBox(block, first, count);
+    Color axis{};
+    for (std::size_t c = first; c < first + count; ++c)
+    {
+        axis[c] = box.e0[c] - box.e1[c];
+    }
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+        Color next{};
+        float length = 0.0f;
+        for (std::size_t i = first; i < first + count; ++i)
+        {
+            for (std::size_t j = first; j < first + count; ++j)
+            {
+                next[i] += covariance[i][j] * axis[j];
+            }
+            length += next[i] * next[i];
+        }
+        if (length <= std::numeric_limits<float>::epsilon())
+        {
+            break;
+        }
+        const float scale = 1.0f / std::sqrt(length);
+        for (std::size_t c = first; c < first + count; ++c)
+        {
+            axis[c] = next[c] * scale;
+        }
+    }
+
+    float axisLength = 0.0f;
+    for (std::size_t c = first; c < first + count; ++c)
+    {
+        axisLength += axis[c] * axis[c];
+    }
+    if (axisLength <= std::numeric_limits<float>::epsilon())
+    {
+        // Flat block
+        return Endpoints{.e0 = mean, .e1 = mean};
+    }
+
+    float low = std::numeric_limits<float>::max();
+    float high = std::numeric_limits<float>::lowest();
+    for (const Color& texel : block.texels)
+    {
+        float projection = 0.0f;
+        for (std::size_t c = first; c < first + count; ++c)
+        {
+            projection += (texel[c] - mean[c]) * axis[c];
+        }
+        low = std::min(low, projection);
+        high = std::max(high, projection);
+    }
+    Endpoints ends;
+    for (std::size_t c = first; c < first + count; ++c)
+    {
+        ends.e0[c] = clampChannel(mean[c] + (axis[c] * high / axisLength));
+        ends.e1[c] = clampChannel(mean[c] + (axis[c] * low / axisLength));
+    }
+    return ends;
+}
+
+/// Least-squares endpoints for fixed indices; `weights[i]` is index i's share of e0.
+/// @return false if the system is singular (all texels on one index)
+bool refineEndpoints(const Block& block, const IndexFit& fit, std::span<const float> weights,
+                     std::size_t first, std::size_t count, Endpoints& ends)
+{
+    float aa = 0.0f;
+    float ab = 0.0f;
+    float bb = 0.0f;
+    Color x0{};
+    Color x1{};
+    for (std::size_t t = 0; t < kTexels; ++t)
+    {
+        const float w = weights[fit.indices[t]];
+        aa += w * w;
+        ab += w * (1.0f - w);
+        bb += (1.0f - w) * (1.0f - w);
+        for (std::size_t c = first; c < first + count; ++c)
+        {
+            x0[c] += w * block.texels[t][c];
+            x1[c] += (1.0f - w) * block.texels[t][c];
+        }
+    }
+    const float determinant = (aa * bb) - (ab * ab);
+    if (std::abs(determinant) < 1e-6f)
+    {
+        return false;
+    }
+    for (std::size_t c = first; c < first + count; ++c)
+    {
+        ends.e0[c] = clampChannel(((bb * x0[c]) - (ab * x1[c])) / determinant);
+        ends.e1[c] = clampChannel(((aa * x1[c]) - (ab * x0[c])) / determinant);
+    }
+    return true;
+}
+
+int refinementPasses(BlockQuality quality)
+{
+    switch (quality)
+    {
+    case BlockQuality::Fast:
+        return 0;
+    case BlockQuality::Normal:
+        return 1;
+    case BlockQuality::High:
+        return 3;
+    }
+    return 0;
+}
+
+Endpoints initialEndpoints(const Block& block, BlockQuality quality, std::size_t count)
+{
+    return quality == BlockQuality::Fast ? boundingBox(block, 0, count)
+                                         : principalAxis(block, 0, count);
+}
+
+// --- BC1 colour -------------------------------------------------------------------------
+
+std::uint16_t pack565(const Color& color)
+{
+    const auto quantize = [](float value, float levels) {
+        return static_cast<unsigned>((value * levels / 255.0f) + 0.5f);
+    };
+    return static_cast<std::uint16_t>((quantize(color[0], 31.0f) << 11U) |
+                                      (quantize(color[1], 63.0f) << 5U) |
+                                      quantize(color[2], 31.0f));
+}
+
+Color expand565(std::uint16_t packed)
+{
+    const unsigned r = (packed >> 11U) & 0x1FU;
+    const unsigned g = (packed >> 5U) & 0x3FU;
+    const unsigned b = packed & 0x1FU;
+    return Color{static_cast<float>((r << 3U) | (r >> 2U)),
+                 static_cast<float>((g << 2U) | (g >> 4U)),
+                 static_cast<float>((b << 3U) | (b >> 2U)), 255.0f};
+}
+
+/// Share of colour0 in BC1 palette entries 0-3.
+constexpr std::array<float, 4> kBc1Weights = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+
+/// Four-colour BC1 block (also the colour half of BC3).
+void encodeColor(const Block& block, BlockQuality quality, bool simd, std::byte* out)
+{
+    Endpoints ends = initialEndpoints(block, quality, 3);
+    std::uint16_t bestColor0 = 0;
+    std::uint16_t bestColor1 = 0;
+    IndexFit best;
+
+    const int passes = refinementPasses(quality);
+    for (int pass = 0; pass <= passes; ++pass)
+    {
+        std::uint16_t color0 = pack565(ends.e0);
+        std::uint16_t color1 = pack565(ends.e1);
+        // colour0 > colour1 selects four-colour mode
+        if (color0 < color1)
+        {
+            std::swap(color0, color1);
+        }
+
+        const Color p0 = expand565(color0);
+        const Color p1 = expand565(color1);
+        Palette palette;
+        palette.count = color0 == color1 ? 1 : 4;
+        for (std::size_t c = 0; c < 3; ++c)
+        {
+            palette.channels[c][0] = p0[c];
+            palette.channels[c][1] = p1[c];
+            palette.channels[c][2] = ((2.0f * p0[c]) + p1[c]) / 3.0f;
+            palette.channels[c][3] = (p0[c] + (2.0f * p1[c])) / 3.0f;
+        }
+        const IndexFit fit = selectIndices(block, palette, 0, 3, simd);
+        if (fit.error < best.error)
+        {
+            best = fit;
+            bestColor0 = color0;
+            bestColor1 = color1;
+        }
+        if (pass == passes || palette.count == 1 ||
+            !refineEndpoints(block, fit, kBc1Weights, 0, 3, ends))
+        {
+            break;
+        }
+    }
+
+    std::uint32_t indices = 0;
+    for (std::size_t t = 0; t < kTexels; ++t)
+    {
+        indices |= static_cast<std::uint32_t>(best.indices[t]) << (2 * t);
+    }
+    out[0] = static_cast<std::byte>(bestColor0 & 0xFFU);
+    out[1] = static_cast<std::byte>(bestColor0 >> 8U);
+    out[2] = static_cast<std::byte>(bestColor1 & 0xFFU);
+    out[3] = static_cast<std::byte>(bestColor1 >> 8U);
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        out[4 + i] = static_cast<std::byte>((indices >> (8 * i)) & 0xFFU);
+    }
+}
+
+// --- BC3 alpha --------------------------------------------------------------------------
+
+/// Eight-value interpolated alpha block: alpha0 > alpha1, entries 2-7 between them.
+void encodeAlpha(const Block& block, bool simd, std::byte* out)
+{
+    float high = 0.0f;
+    float low = 255.0f;
+    for (const Color& texel : block.texels)
+    {
+        high = std::max(high, texel[3]);
+        low = std::min(low, texel[3]);
+    }
+    const auto alpha0 = static_cast<unsigned>(high + 0.5f);
+    const auto alpha1 = static_cast<unsigned>(low + 0.5f);
+
+    Palette palette;
+    palette.count = alpha0 == alpha1 ? 1 : 8;
+    palette.channels[0][0] = static_cast<float>(alpha0);
+    palette.channels[0][1] = static_cast<float>(alpha1);
+    for (unsigned i = 1; i < 7; ++i)
+    {
+        palette.channels[0][i + 1] =
+            static_cast<float>(((7 - i) * alpha0) + (i * alpha1)) / 7.0f;
+    }
+    const IndexFit fit = selectIndices(block, palette, 3, 1, simd);
+
+    std::uint64_t indices = 0;
+    for (std::size_t t = 0; t < kTexels; ++t)
+    {
+        indices |= static_cast<std::uint64_t>(fit.indices[t]) << (3 * t);
+    }
+    out[0] = static_cast<std::byte>(alpha0);
+    out[1] = static_cast<std::byte>(alpha1);
+    for (std::size_t i = 0; i < 6; ++i)
+    {
+        out[2 + i] = static_cast<std::byte>((indices >> (8 * i)) & 0xFFU);
+    }
+}
+
+// --- BC7 mode 6 -------------------------------------------------------------------------
+
+/// Share of endpoint 0 for each 4-bit index.
+constexpr std::array<float, 16> kBc7EndpointWeights = [] {
+    std::array<float, 16> weights{};
+    for (std::size_t i = 0; i < weights.size(); ++i)
+    {
+        weights[i] = static_cast<float>(64 - kBc7Weights[i]) / 64.0f;
+    }
+    return weights;
+}();
+
+/// RGBA endpoint stored as 7 bits per channel plus a shared p-bit.
+struct Bc7Endpoint {
+    std::array<unsigned, 4> values{};  ///< 7-bit
+    unsigned pbit = 0;
+
+    unsigned expanded(std::size_t c) const { return (values[c] << 1U) | pbit; }
+};
+
+Bc7Endpoint quantizeBc7(const Color& color, unsigned pbit)
+{
+    Bc7Endpoint endpoint{.values = {}, .pbit = pbit};
+    for (std::size_t c = 0; c < 4; ++c)
+    {
+        const float value = ((color[c] - static_cast<float>(pbit)) / 2.0f) + 0.5f;
+        endpoint.values[c] = static_cast<unsigned>(std::clamp(value, 0.0f, 127.0f));
+    }
+    return endpoint;
+}
+
+/// Quantize with whichever p-bit reproduces the colour more closely.
+Bc7Endpoint quantizeBc7(const Color& color)
+{
+    Bc7Endpoint best;
+    float bestError = std::numeric_limits<float>::max();
+    for (unsigned pbit = 0; pbit < 2; ++pbit)
+    {
+        const Bc7Endpoint candidate = quantizeBc7(color, pbit);
+        float error = 0.0f;
+        for (std::size_t c = 0; c < 4; ++c)
+        {
+            const float diff = static_cast<float>(candidate.expanded(c)) - color[c];
+            error += diff * diff;
+        }
+        if (error < bestError)
+        {
+            best = candidate;
+            bestError = error;
+        }
+    }
+    return best;
+}
+
+IndexFit fitBc7(const Block& block, const Bc7Endpoint& e0, const Bc7Endpoint& e1, bool simd)
+{
+    Palette palette;
+    palette.count = 16;
+    for (std::size_t i = 0; i < palette.count; ++i)
+    {
+        const auto weight = static_cast<unsigned>(kBc7Weights[i]);
+        for (std::size_t c = 0; c < 4; ++c)
+        {
+            palette.channels[c][i] = static_cast<float>(
+                (((64 - weight) * e0.expanded(c)) + (weight * e1.expanded(c)) + 32) >> 6U);
+        }
+    }
+    return selectIndices(block, palette, 0, 4, simd);
+}
+
+/// Little-endian bit packer for 128-bit blocks.
+class BitWriter {
+public:
+    explicit BitWriter(std::byte* out) : out_(out) { std::fill_n(out_, 16, std::byte{0}); }
+
+    void write(unsigned value, unsigned bits)
+    {
+        for (unsigned i = 0; i < bits; ++i, ++position_)
+        {
+            const auto bit = static_cast<unsigned char>(((value >> i) & 1U) << (position_ % 8));
+            out_[position_ / 8] |= static_cast<std::byte>(bit);
+        }
+    }
+
+private:
+    std::byte* out_;
+    unsigned position_ = 0;
+};
+
+void encodeBc7(const Block& block, BlockQuality quality, bool simd, std::byte* out)
+{
+    Endpoints ends = initialEndpoints(block, quality, 4);
+    Bc7Endpoint best0;
+    Bc7Endpoint best1;
+    IndexFit best;
+
+    const int passes = refinementPasses(quality);
+    for (int pass = 0; pass <= passes; ++pass)
+    {
+        IndexFit fit;
+        if (quality == BlockQuality::High)
+        {
+            for (unsigned pbits = 0; pbits < 4; ++pbits)
+            {
+                const Bc7Endpoint e0 = quantizeBc7(ends.e0, pbits & 1U);
+                const Bc7Endpoint e1 = quantizeBc7(ends.e1, pbits >> 1U);
+                const IndexFit candidate = fitBc7(block, e0, e1, simd);
+                if (candidate.error < fit.error)
+                {
+                    fit = candidate;
+                }
+                if (candidate.error < best.error)
+                {
+                    best = candidate;
+                    best0 = e0;
+                    best1 = e1;
+                }
+            }
+        }
+        else
+        {
+            const Bc7Endpoint e0 = quantizeBc7(ends.e0);
+            const Bc7Endpoint e1 = quantizeBc7(ends.e1);
+            fit = fitBc7(block, e0, e1, simd);
+            if (fit.error < best.error)
+            {
+                best = fit;
+                best0 = e0;
+                best1 = e1;
+            }
+        }
+        if (pass == passes || !refineEndpoints(block, fit, kBc7EndpointWeights, 0, 4, ends))
+        {
+            break;
+        }
+    }
+
+    // The anchor (texel 0) index is stored without its top bit, so it must be below 8
+    if (best.indices[0] >= 8)
+    {
+        std::swap(best0, best1);
+        for (std::uint8_t& index : best.indices)
+        {
+            index = static_cast<std::uint8_t>(15 - index);
+        }
+    }
+
+    BitWriter writer(out);
+    writer.write(1U << 6U, 7);  // Mode 6
+    for (std::size_t c = 0; c < 4; ++c)
+    {
+        writer.write(best0.values[c], 7);
+        writer.write(best1.values[c], 7);
+    }
+    writer.write(best0.pbit, 1);
+    writer.write(best1.pbit, 1);
+    for (std::size_t t = 0; t < kTexels; ++t)
+    {
+        writer.write(best.indices[t], t == 0 ? 3 : 4);
+    }
+}
+
+// --- Image ------------------------------------------------------------------------------
+
+/// Gather a block, repeating the last row and column past the image edge.
+void loadBlock(const unsigned char* rgba, int width, int height, int blockX, int blockY,
+               Block& block)
+{
+    for (int y = 0; y < kBlockSize; ++y)
+    {
+        const int row = std::min((blockY * kBlockSize) + y, height - 1);
+        for (int x = 0; x < kBlockSize; ++x)
+        {
+            const int column = std::min((blockX * kBlockSize) + x, width - 1);
+            const unsigned char* texel =
+                rgba + (((static_cast<std::size_t>(row) * static_cast<std::size_t>(width)) +
+                         static_cast<std::size_t>(column)) *
+                        4);
+            Color& color = block.texels[static_cast<std::size_t>((y * kBlockSize) + x)];
+            for (std::size_t c = 0; c < 4; ++c)
+            {
+                color[c] = static_cast<float>(texel[c]);
+            }
+        }
+    }
+}
+
+} // namespace
+
+std::size_t BlockEncoder::blockBytes(BlockFormat format)
+{
+    return format == BlockFormat::BC1 ? 8 : 16;
+}
+
+std::size_t BlockEncoder::encodedSize(BlockFormat format, int width, int height)
+{
+    const auto blocksWide = static_cast<std::size_t>((std::max(width, 1) + 3) / kBlockSize);
+    const auto blocksHigh = static_cast<std::size_t>((std::max(height, 1) + 3) / kBlockSize);
+    return blocksWide * blocksHigh * blockBytes(format);
+}
+
+void BlockEncoder::encode(const unsigned char* rgba, int width, int height, BlockFormat format,
+                          BlockQuality quality, std::span<std::byte> out, JobSystem* jobs)
+{
+    VIBEGL_PROFILE_FUNCTION();
+    if (rgba == nullptr || width <= 0 || height <= 0 ||
+        out.size() < encodedSize(format, width, height))
+    {
+        return;
+    }
+
+    const bool simd = Simd::active();
+    const int blocksWide = (width + 3) / kBlockSize;
+    const int blocksHigh = (height + 3) / kBlockSize;
+    const std::size_t bytes = blockBytes(format);
+    auto body = [&](std::size_t begin, std::size_t end) {
+        Block block;
+        for (auto blockY = static_cast<int>(begin); blockY < static_cast<int>(end); ++blockY)
+        {
+            for (int blockX = 0; blockX < blocksWide; ++blockX)
+            {
+                loadBlock(rgba, width, height, blockX, blockY, block);
+                std::byte* target =
+                    out.data() +
+                    (static_cast<std::size_t>((blockY * blocksWide) + blockX) * bytes);
+                switch (format)
+                {
+                case BlockFormat::BC1:
+                    encodeColor(block, quality, simd, target);
+                    break;
+                case BlockFormat::BC3:
+                    encodeAlpha(block, simd, target);
+                    encodeColor(block, quality, simd, target + 8);
+                    break;
+                case BlockFormat::BC7:
+                    encodeBc7(block, quality, simd, target);
+                    break;
+                }
+            }
+        }
+    };
+
+    const auto rows = static_cast<std::size_t>(blocksHigh);
+    const auto blocks = rows * static_cast<std::size_t>(blocksWide);
+    if (jobs != nullptr && blocks >= kParallelBlocks)
+    {
+        const std::size_t grain =
+            std::max<std::size_t>(1, kBlocksPerChunk / static_cast<std::size_t>(blocksWide));
+        jobs->parallelFor(rows, grain, body);
+    }
+    else
+    {
+        body(0, rows);
+    }
+}
+
+} // namespace vibegl
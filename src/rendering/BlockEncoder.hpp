@@ -0,0 +1,53 @@
+#pragma once
+
+/// @file
+/// CPU encoder from RGBA8 to BC1, BC3 and BC7 (mode 6) texture blocks.
+
+#include <cstddef>
+#include <span>
+
+namespace vibegl {
+
+class JobSystem;
+
+/// GPU block format produced by BlockEncoder.
+enum class BlockFormat {
+    BC1,  ///< Opaque RGB, 8 bytes per 4x4 block
+    BC3,  ///< RGBA with interpolated alpha, 16 bytes per block
+    BC7   ///< RGBA, single-subset mode 6, 16 bytes per block
+};
+
+/// Encoder effort: endpoint search and refinement per block.
+enum class BlockQuality {
+    Fast,    ///< Bounding-box endpoints, one index pass
+    Normal,  ///< Principal-axis endpoints plus one least-squares refinement
+    High     ///< Normal plus more refinement passes (and every BC7 p-bit pair)
+};
+
+/// Compresses RGBA8 images to BCn blocks at run time.
+///
+/// Every block is fitted independently: endpoints along the block's principal colour axis
+/// (or its bounding box for Fast), quantized to the format's precision, then each texel
+/// takes the nearest palette entry. Refinement re-solves the endpoints by least squares
+/// for the chosen indices and keeps the result only if the error drops. When
+/// Simd::active() the nearest-entry search compares four palette entries at once; the
+/// scalar path picks the same indices.
+///
+/// Thread-safe; with a JobSystem, block rows are split across workers.
+class BlockEncoder {
+public:
+    /// Bytes per 4x4 block.
+    static std::size_t blockBytes(BlockFormat format);
+
+    /// Bytes of blocks covering a width x height image (partial blocks round up).
+    static std::size_t encodedSize(BlockFormat format, int width, int height);
+
+    /// Encode an RGBA8 image. Edge blocks repeat the last row and column.
+    /// @param rgba width * height * 4 bytes
+    /// @param out encodedSize() bytes, row-major blocks
+    /// @param jobs Optional scheduler to split block rows across; the calling thread helps
+    static void encode(const unsigned char* rgba, int width, int height, BlockFormat format,
+                       BlockQuality quality, std::span<std::byte> out, JobSystem* jobs = nullptr);
+};
+
+} // namespace vibegl
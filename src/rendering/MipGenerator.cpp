@@ -0,0 +1,238 @@
+#include "MipGenerator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+#include "../core/JobSystem.hpp"
+#include "../core/Profiler.hpp"
+#include "../core/Simd.hpp"
+
+namespace vibegl
+{
+
+namespace
+{
+
+constexpr std::size_t kChannels = 4;
+
+/// Resolution of the linear -> sRGB table; fine enough that every 8-bit code is reachable.
+constexpr std::size_t kEncodeSize = 4096;
+
+/// Levels with fewer texels are not worth splitting across workers.
+constexpr std::size_t kParallelTexels = 64 * 1024;
+
+/// Output texels per parallelFor chunk.
+constexpr std::size_t kTexelsPerChunk = 16 * 1024;
+
+struct SrgbTables {
+    std::array<float, 256> toLinear{};                 ///< sRGB byte -> linear [0, 1]
+    std::array<unsigned char, kEncodeSize> toSrgb{};  ///< Linear * (kEncodeSize - 1) -> byte
+};
+
+const SrgbTables& srgbTables()
+{
+    static const SrgbTables tables = [] {
+        SrgbTables result;
+        for (std::size_t i = 0; i < result.toLinear.size(); ++i)
+        {
+            const double c = static_cast<double>(i) / 255.0;
+            result.toLinear[i] = static_cast<float>(
+                c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+        }
+        for (std::size_t i = 0; i < kEncodeSize; ++i)
+        {
+            const double l = static_cast<double>(i) / static_cast<double>(kEncodeSize - 1);
+            const double s = l <= 0.0031308 ? l * 12.92 : (1.055 * std::pow(l, 1.0 / 2.4)) - 0.055;
+            result.toSrgb[i] = static_cast<unsigned char>(std::lround(s * 255.0));
+        }
+        return result;
+    }();
+    return tables;
+}
+
+/// Scale from a sum of four texels to the encode table index (colour) or byte (alpha).
+constexpr float kColorScale = 0.25f * static_cast<float>(kEncodeSize - 1);
+constexpr float kAlphaScale = 0.25f;
+
+/// Source rows and columns averaged into one output texel.
+struct Footprint {
+    const unsigned char* p00;
+    const unsigned char* p01;
+    const unsigned char* p10;
+    const unsigned char* p11;
+};
+
+void averageScalar(const SrgbTables& tables, const Footprint& f, unsigned char* out)
+{
+    for (std::size_t c = 0; c < 3; ++c)
+    {
+        const float sum = (tables.toLinear[f.p00[c]] + tables.toLinear[f.p01[c]]) +
+                          (tables.toLinear[f.p10[c]] + tables.toLinear[f.p11[c]]);
+        out[c] = tables.toSrgb[static_cast<std::size_t>((sum * kColorScale) + 0.5f)];
+    }
+    const float alpha = (static_cast<float>(f.p00[3]) + static_cast<float>(f.p01[3])) +
+                        (static_cast<float>(f.p10[3]) + static_cast<float>(f.p11[3]));
+    out[3] = static_cast<unsigned char>((alpha * kAlphaScale) + 0.5f);
+}
+
+#ifdef VIBEGL_SSE2
+/// Linear value of channel `c` of four texels 8 bytes apart (every other source texel).
+__m128 gatherLinear(const SrgbTables& tables, const unsigned char* p, std::size_t c)
+{
+    return _mm_set_ps(tables.toLinear[p[24 + c]], tables.toLinear[p[16 + c]],
+                      tables.toLinear[p[8 + c]], tables.toLinear[p[c]]);
+}
+
+/// Alpha bytes of four consecutive texels as 32-bit lanes.
+__m128i loadAlpha(const unsigned char* p)
+{
+    return _mm_srli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), 24);
+}
+
+/// Four output texels from two full source rows of eight texels each. Same sums in the
+/// same order as averageScalar(); alpha uses (sum + 2) >> 2, which is what the scalar
+/// float rounding computes for byte sums.
+void averageSse2(const SrgbTables& tables, const unsigned char* row0, const unsigned char* row1,
+                 unsigned char* out)
+{
+    const __m128 scale = _mm_set1_ps(kColorScale);
+    const __m128 half = _mm_set1_ps(0.5f);
+    alignas(16) std::array<std::array<std::int32_t, 4>, kChannels> values{};
+    for (std::size_t c = 0; c < 3; ++c)
+    {
+        const __m128 sum = _mm_add_ps(
+            _mm_add_ps(gatherLinear(tables, row0, c), gatherLinear(tables, row0 + 4, c)),
+            _mm_add_ps(gatherLinear(tables, row1, c), gatherLinear(tables, row1 + 4, c)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(values[c].data()),
+                        _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(sum, scale), half)));
+    }
+
+    // Column sums of source texels 0-3 and 4-7, then adjacent pairs into lanes 0 and 2
+    const __m128i low = _mm_add_epi32(loadAlpha(row0), loadAlpha(row1));
+    const __m128i high = _mm_add_epi32(loadAlpha(row0 + 16), loadAlpha(row1 + 16));
+    const __m128i lowPairs = _mm_add_epi32(low, _mm_srli_epi64(low, 32));
+    const __m128i highPairs = _mm_add_epi32(high, _mm_srli_epi64(high, 32));
+    const __m128i sums =
+        _mm_unpacklo_epi64(_mm_shuffle_epi32(lowPairs, _MM_SHUFFLE(2, 0, 2, 0)),
+                           _mm_shuffle_epi32(highPairs, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_store_si128(reinterpret_cast<__m128i*>(values[3].data()),
+                    _mm_srli_epi32(_mm_add_epi32(sums, _mm_set1_epi32(2)), 2));
+
+    for (std::size_t i = 0; i < 4; ++i, out += kChannels)
+    {
+        out[0] = tables.toSrgb[static_cast<std::size_t>(values[0][i])];
+        out[1] = tables.toSrgb[static_cast<std::size_t>(values[1][i])];
+        out[2] = tables.toSrgb[static_cast<std::size_t>(values[2][i])];
+        out[3] = static_cast<unsigned char>(values[3][i]);
+    }
+}
+#endif
+
+/// Filter output rows [rowBegin, rowEnd) of a level from the level above.
+void downsampleRows(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst,
+                    int dstWidth, std::size_t rowBegin, std::size_t rowEnd, bool simd)
+{
+    const SrgbTables& tables = srgbTables();
+    const auto srcStride = static_cast<std::size_t>(srcWidth) * kChannels;
+    const auto lastColumn = static_cast<std::size_t>(srcWidth - 1);
+    const auto lastRow = static_cast<std::size_t>(srcHeight - 1);
+    const auto width = static_cast<std::size_t>(dstWidth);
+    // Output texels whose 2x2 footprint needs no edge clamping
+    const std::size_t interior = std::min(width, static_cast<std::size_t>(srcWidth) / 2);
+
+    for (std::size_t y = rowBegin; y < rowEnd; ++y)
+    {
+        const unsigned char* row0 = src + (std::min(2 * y, lastRow) * srcStride);
+        const unsigned char* row1 = src + (std::min((2 * y) + 1, lastRow) * srcStride);
+        unsigned char* out = dst + (y * width * kChannels);
+
+        std::size_t x = 0;
+#ifdef VIBEGL_SSE2
+        if (simd)
+        {
+            for (; x + 4 <= interior; x += 4, out += 4 * kChannels)
+            {
+                averageSse2(tables, row0 + (2 * x * kChannels), row1 + (2 * x * kChannels), out);
+            }
+        }
+#else
+        static_cast<void>(simd);
+        static_cast<void>(interior);
+#endif
+        for (; x < width; ++x, out += kChannels)
+        {
+            const std::size_t x0 = std::min(2 * x, lastColumn) * kChannels;
+            const std::size_t x1 = std::min((2 * x) + 1, lastColumn) * kChannels;
+            const Footprint footprint{
+                .p00 = row0 + x0, .p01 = row0 + x1, .p10 = row1 + x0, .p11 = row1 + x1};
+            averageScalar(tables, footprint, out);
+        }
+    }
+}
+
+} // namespace
+
+int MipGenerator::levelCount(int width, int height)
+{
+    const auto largest = static_cast<unsigned>(std::max({width, height, 1}));
+    return static_cast<int>(std::bit_width(largest));
+}
+
+MipChain MipGenerator::generate(const unsigned char* rgba, int width, int height, JobSystem* jobs)
+{
+    VIBEGL_PROFILE_FUNCTION();
+    MipChain chain;
+    const int levels = levelCount(width, height);
+    if (rgba == nullptr || width <= 0 || height <= 0 || levels <= 1)
+    {
+        return chain;
+    }
+
+    std::size_t total = 0;
+    int levelWidth = width;
+    int levelHeight = height;
+    for (int level = 1; level < levels; ++level)
+    {
+        levelWidth = std::max(1, levelWidth / 2);
+        levelHeight = std::max(1, levelHeight / 2);
+        chain.levels.push_back(
+            MipChain::Level{.width = levelWidth, .height = levelHeight, .offset = total});
+        total += static_cast<std::size_t>(levelWidth) * static_cast<std::size_t>(levelHeight) *
+                 kChannels;
+    }
+    chain.pixels = std::make_unique_for_overwrite<unsigned char[]>(total);
+
+    const bool simd = Simd::active();
+    const unsigned char* src = rgba;
+    int srcWidth = width;
+    int srcHeight = height;
+    for (const MipChain::Level& level : chain.levels)
+    {
+        unsigned char* dst = chain.pixels.get() + level.offset;
+        const auto rows = static_cast<std::size_t>(level.height);
+        const auto texels = static_cast<std::size_t>(level.width) * rows;
+        auto body = [=](std::size_t begin, std::size_t end) {
+            downsampleRows(src, srcWidth, srcHeight, dst, level.width, begin, end, simd);
+        };
+        if (jobs != nullptr && texels >= kParallelTexels)
+        {
+            const std::size_t grain =
+                std::max<std::size_t>(1, kTexelsPerChunk / static_cast<std::size_t>(level.width));
+            jobs->parallelFor(rows, grain, body);
+        }
+        else
+        {
+            body(0, rows);
+        }
+        src = dst;
+        srcWidth = level.width;
+        srcHeight = level.height;
+    }
+    return chain;
+}
+
+} // namespace vibegl
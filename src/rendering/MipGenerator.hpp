@@ -0,0 +1,53 @@
+#pragma once
+
+/// @file
+/// CPU mip chain generation for RGBA8 sRGB images.
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace vibegl {
+
+class JobSystem;
+
+/// Mip levels below a base image, packed in one allocation.
+struct MipChain {
+    struct Level {
+        int width = 0;
+        int height = 0;
+        std::size_t offset = 0;  ///< Byte offset of the level in `pixels`
+    };
+
+    std::vector<Level> levels;  ///< levels[i] is mip level i + 1
+    std::unique_ptr<unsigned char[]> pixels;
+
+    /// RGBA8 pixels of levels[i].
+    const unsigned char* data(std::size_t i) const { return pixels.get() + levels[i].offset; }
+};
+
+/// Builds mip chains on the CPU so they can be uploaded instead of glGenerateMipmap().
+///
+/// Each level is a 2x2 box filter of the one above (odd edges reuse the last row or
+/// column). Colour channels are averaged in linear light: texels are decoded through a
+/// 256-entry sRGB table and re-encoded through a 4096-entry one, so mips do not darken
+/// the way averaging gamma-encoded values (what glGenerateMipmap() does for GL_RGBA8)
+/// does. Alpha is averaged as is. When Simd::active() four output texels are averaged
+/// and rounded per step (the table lookups stay scalar, so the gain is modest); the
+/// scalar path produces identical bytes.
+///
+/// Thread-safe; with a JobSystem, the rows of each large level are split across workers.
+class MipGenerator {
+public:
+    /// Number of levels of a full chain down to 1x1, including the base level.
+    static int levelCount(int width, int height);
+
+    /// Build levels 1..levelCount()-1 of an RGBA8 image.
+    /// @param rgba Base level, width * height * 4 bytes
+    /// @param jobs Optional scheduler to split large levels across; the calling thread
+    ///             helps, so it may be a job itself
+    static MipChain generate(const unsigned char* rgba, int width, int height,
+                             JobSystem* jobs = nullptr);
+};
+
+} // namespace vibegl
@@ -0,0 +1,309 @@
+#include "PipelineWarmup.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <functional>
+#include <span>
+#include <sstream>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+#include "../core/MappedFile.hpp"
+#include "../core/Profiler.hpp"
+
+namespace vibegl
+{
+
+namespace
+{
+
+constexpr std::string_view kManifestHeader = "# VibeGL pipeline manifest v1";
+
+/// Parse a whole field as an unsigned decimal number (no sign, no trailing characters).
+template<typename T>
+bool parseNumber(std::string_view text, T& value)
+{
+    const char* end = text.data() + text.size();
+    const auto [next, error] = std::from_chars(text.data(), end, value);
+    return error == std::errc{} && next == end;
+}
+
+} // namespace
+
+std::size_t PipelineWarmup::KeyHash::operator()(const PipelineKey& key) const
+{
+    std::uint64_t packed = (std::uint64_t{key.shader.index} << 32U) | key.features;
+    packed = (packed * 0x9E3779B97F4A7C15ULL) ^ ((std::uint64_t{key.layout} << 32U) | key.state);
+    return std::hash<std::uint64_t>{}(packed);
+}
+
+std::uint32_t PipelineWarmup::addLayout(std::string name, VertexLayout layout)
+{
+    layouts_.push_back(NamedLayout{.name = std::move(name), .layout = std::move(layout)});
+    return static_cast<std::uint32_t>(layouts_.size() - 1);
+}
+
+void PipelineWarmup::record(const PipelineKey& key)
+{
+    keys_.insert(key);
+}
+
+Result<std::size_t> PipelineWarmup::loadManifest(const std::filesystem::path& path)
+{
+    auto file = MappedFile::open(path);
+    if (!file)
+    {
+        return std::unexpected(
+            Error{.message = "Failed to read pipeline manifest", .context = file.error().context});
+    }
+
+    std::istringstream lines{std::string(file->text())};
+    std::string line;
+    std::getline(lines, line);
+    if (line.ends_with('\r'))
+    {
+        line.pop_back();
+    }
+    if (line != kManifestHeader)
+    {
+        // Another format version or not a manifest at all
+        return std::unexpected(Error{.message = "Unsupported pipeline manifest",
+                                     .context = path.string() + ": first line '" + line + "'"});
+    }
+
+    std::size_t count = 0;
+    std::size_t skipped = 0;
+    while (std::getline(lines, line))
+    {
+        std::istringstream fields(line);
+        std::string features;
+        std::string state;
+        std::string extra;
+        ManifestEntry entry;
+        if (!(fields >> entry.shader) || entry.shader.starts_with('#'))
+        {
+            continue;  // Blank line or comment
+        }
+        if (!(fields >> features >> entry.layout >> state) || (fields >> extra) ||
+            !parseNumber(features, entry.features) || !parseNumber(state, entry.state))
+        {
+            ++skipped;
+            continue;
+        }
+        manifest_.push_back(std::move(entry));
+        ++count;
+    }
+    if (skipped > 0)
+    {
+        spdlog::warn("{}: skipped {} malformed pipeline manifest line(s)", path.string(), skipped);
+    }
+    return count;
+}
+
+Result<void> PipelineWarmup::saveManifest(const std::filesystem::path& path)
+{
+    resolveManifest();
+
+    std::vector<std::string> lines;
+    lines.reserve(keys_.size() + manifest_.size());
+    const auto format = [](std::string_view shader, ShaderFeatures features,
+                           std::string_view layout, RenderState state) {
+        return std::string(shader) + ' ' + std::to_string(features) + ' ' + std::string(layout) +
+               ' ' + std::to_string(state);
+    };
+    for (const PipelineKey& key : keys_)
+    {
+        const std::string_view shader = library_.name(key.shader);
+        if (!shader.empty() && key.layout < layouts_.size())
+        {
+            lines.push_back(format(shader, key.features, layouts_[key.layout].name, key.state));
+        }
+    }
+    // Entries for shaders this run never loaded stay for the runs that do
+    for (const ManifestEntry& entry : manifest_)
+    {
+        lines.push_back(format(entry.shader, entry.features, entry.layout, entry.state));
+    }
+    std::ranges::sort(lines);
+    const auto duplicates = std::ranges::unique(lines);
+    lines.erase(duplicates.begin(), duplicates.end());
+
+    std::string contents(kManifestHeader);
+    contents += '\n';
+    for (const std::string& line : lines)
+    {
+        contents += line;
+        contents += '\n';
+    }
+    if (auto written = writeFileAtomically(path, std::as_bytes(std::span(contents))); !written)
+    {
+        return std::unexpected(Error{.message = "Failed to write pipeline manifest",
+                                     .context = written.error().context});
+    }
+    return {};
+}
+
+PipelineWarmup::Stats PipelineWarmup::warm()
+{
+    VIBEGL_PROFILE_SCOPE("PipelineWarmup::warm");
+    const auto start = std::chrono::steady_clock::now();
+    resolveManifest();
+
+    Stats stats;
+    if (keys_.empty())
+    {
+        return stats;
+    }
+
+    // Compile missing variants first, one parallel batch per shader
+    std::unordered_map<std::uint32_t, std::vector<ShaderFeatures>> variants;
+    for (const PipelineKey& key : keys_)
+    {
+        variants[key.shader.index].push_back(key.features);
+    }
+    for (const auto& [index, features] : variants)
+    {
+        library_.precompile(ShaderHandle{index}, features);
+    }
+
+    // Save what the draws change
+    GLint previousFramebuffer = 0;
+    GLint previousProgram = 0;
+    GLint previousVao = 0;
+    GLint previousArrayBuffer = 0;
+    std::array<GLint, 4> previousViewport{};
+    std::array<GLint, 4> previousBlend{};
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previousVao);
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &previousArrayBuffer);
+    glGetIntegerv(GL_VIEWPORT, previousViewport.data());
+    glGetIntegerv(GL_BLEND_SRC_RGB, &previousBlend[0]);
+    glGetIntegerv(GL_BLEND_DST_RGB, &previousBlend[1]);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &previousBlend[2]);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &previousBlend[3]);
+    const RenderState previousState = (glIsEnabled(GL_DEPTH_TEST) == GL_TRUE ? kDepthTest : 0U) |
+                                      (glIsEnabled(GL_BLEND) == GL_TRUE ? kBlend : 0U) |
+                                      (glIsEnabled(GL_CULL_FACE) == GL_TRUE ? kCullFace : 0U);
+
+    // Tiny color + depth target, so depth and blend state match real passes
+    std::array<GLuint, 2> renderbuffers{};
+    GLuint framebuffer = 0;
+    glGenRenderbuffers(2, renderbuffers.data());
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, kTargetSize, kTargetSize);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, kTargetSize, kTargetSize);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+                              renderbuffers[0]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER,
+                              renderbuffers[1]);
+    glViewport(0, 0, kTargetSize, kTargetSize);
+
+    // Three zeroed vertices (a degenerate triangle) in every layout
+    GLsizei maxStride = 16;
+    for (const NamedLayout& layout : layouts_)
+    {
+        maxStride = std::max(maxStride, layout.layout.stride);
+    }
+    const std::vector<std::byte> zeros(static_cast<std::size_t>(maxStride) * 3);
+    GLuint vertexBuffer = 0;
+    glGenBuffers(1, &vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(zeros.size()), zeros.data(),
+                 GL_STATIC_DRAW);
+    std::vector<GLuint> vertexArrays(layouts_.size());
+    glGenVertexArrays(static_cast<GLsizei>(vertexArrays.size()), vertexArrays.data());
+    for (std::size_t i = 0; i < layouts_.size(); ++i)
+    {
+        glBindVertexArray(vertexArrays[i]);
+        layouts_[i].layout.apply();
+    }
+
+    for (const PipelineKey& key : keys_)
+    {
+        const GLuint program = library_.program(key.shader, key.features);
+        if (program == 0 || key.layout >= layouts_.size())
+        {
+            ++stats.skipped;
+            continue;
+        }
+        applyState(key.state);
+        glUseProgram(program);
+        glBindVertexArray(vertexArrays[key.layout]);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        ++stats.draws;
+    }
+
+    // Block here, at load time, until the driver has really built everything
+    glFinish();
+
+    glBindVertexArray(static_cast<GLuint>(previousVao));
+    glBindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(previousArrayBuffer));
+    glUseProgram(static_cast<GLuint>(previousProgram));
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer));
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+    applyState(previousState);
+    glBlendFuncSeparate(static_cast<GLenum>(previousBlend[0]),
+                        static_cast<GLenum>(previousBlend[1]),
+                        static_cast<GLenum>(previousBlend[2]),
+                        static_cast<GLenum>(previousBlend[3]));
+    glDeleteVertexArrays(static_cast<GLsizei>(vertexArrays.size()), vertexArrays.data());
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(2, renderbuffers.data());
+
+    stats.milliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    spdlog::info("Pipeline warm-up: {} draw(s), {} skipped in {:.1f} ms", stats.draws,
+                 stats.skipped, stats.milliseconds);
+    return stats;
+}
+
+void PipelineWarmup::resolveManifest()
+{
+    std::erase_if(manifest_, [this](const ManifestEntry& entry) {
+        const ShaderHandle shader = library_.find(entry.shader);
+        const auto layout = std::ranges::find(layouts_, entry.layout, &NamedLayout::name);
+        if (!shader.isValid() || layout == layouts_.end())
+        {
+            return false;
+        }
+        keys_.insert(PipelineKey{.shader = shader,
+                                 .features = entry.features,
+                                 .layout = static_cast<std::uint32_t>(layout - layouts_.begin()),
+                                 .state = entry.state});
+        return true;
+    });
+}
+
+void PipelineWarmup::applyState(RenderState state)
+{
+    const auto set = [](GLenum capability, bool enabled) {
+        if (enabled)
+        {
+            glEnable(capability);
+        }
+        else
+        {
+            glDisable(capability);
+        }
+    };
+    set(GL_DEPTH_TEST, (state & kDepthTest) != 0);
+    set(GL_BLEND, (state & kBlend) != 0);
+    set(GL_CULL_FACE, (state & kCullFace) != 0);
+    if ((state & kBlend) != 0)
+    {
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+}
+
+} // namespace vibegl
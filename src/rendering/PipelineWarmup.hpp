@@ -0,0 +1,135 @@
+#pragma once
+
+/// @file
+/// Warm-up draws that make drivers finish deferred shader compilation before the first frame.
+
+#include "../core/GLIncludes.hpp"
+#include "../core/Result.hpp"
+#include "ShaderLibrary.hpp"
+#include "VertexLayout.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace vibegl {
+
+/// Fixed-function state bits that can change the code a driver generates for a program.
+using RenderState = std::uint32_t;
+
+/// A program variant drawn with a vertex layout and render state.
+struct PipelineKey {
+    ShaderHandle shader;
+    ShaderFeatures features = 0;
+    std::uint32_t layout = 0;  ///< Index returned by PipelineWarmup::addLayout()
+    RenderState state = 0;
+
+    bool operator==(const PipelineKey& other) const
+    {
+        return shader.index == other.shader.index && features == other.features &&
+               layout == other.layout && state == other.state;
+    }
+};
+
+/// Issues one tiny offscreen draw per known pipeline combination at load time.
+///
+/// Many drivers only finish compiling a program (and patch it for the vertex format
+/// and blend state) at its first draw, which turns the first appearance of a material
+/// into a multi-millisecond hitch. warm() moves that cost to startup: it compiles the
+/// variants (as parallel batches), then draws a degenerate triangle into a 4x4 target
+/// for every combination and waits for the GPU.
+///
+/// Combinations come from record(), called for the ones known up front and at each
+/// draw, and from a manifest that saveManifest() writes and loadManifest() reads on the next
+/// run, so later runs warm exactly what earlier runs drew. The manifest refers to
+/// shaders and layouts by name; names must not contain whitespace.
+///
+/// All methods are for the thread owning the GL context (or while no frame is rendering).
+///
+/// Example:
+/// ```cpp
+/// const std::uint32_t layout = warmup.addLayout("mesh", meshLayout);
+/// warmup.loadManifest("shader_cache/pipelines.txt");
+/// warmup.record({.shader = lit, .features = 0, .layout = layout, .state = kDepthTest});
+/// warmup.warm();  // in onWarmup()
+///
+/// // Each draw:
+/// warmup.record({.shader = lit, .features = features, .layout = layout, .state = state});
+/// // At shutdown:
+/// warmup.saveManifest("shader_cache/pipelines.txt");
+/// ```
+class PipelineWarmup {
+public:
+    static constexpr RenderState kDepthTest = 1U << 0;  ///< GL_DEPTH_TEST enabled
+    static constexpr RenderState kBlend = 1U << 1;      ///< Alpha blending enabled
+    static constexpr RenderState kCullFace = 1U << 2;   ///< Back-face culling enabled
+
+    /// Size of the offscreen warm-up target in pixels.
+    static constexpr GLsizei kTargetSize = 4;
+
+    /// Outcome of warm().
+    struct Stats {
+        std::size_t draws = 0;    ///< Combinations drawn
+        std::size_t skipped = 0;  ///< Combinations whose program or layout was unavailable
+        double milliseconds = 0.0;
+    };
+
+    explicit PipelineWarmup(ShaderLibrary& library) : library_(library) {}
+
+    /// Register a vertex layout under a stable name.
+    /// @return Index for PipelineKey::layout
+    std::uint32_t addLayout(std::string name, VertexLayout layout);
+
+    /// Note a combination to warm: at load time for the ones known up front, and at
+    /// each draw (a hash set lookup once it is known) so the manifest learns the rest.
+    void record(const PipelineKey& key);
+
+    /// Read combinations from an earlier run. Names are resolved in warm() and
+    /// saveManifest(), so the manifest may be loaded before shaders and layouts.
+    /// Malformed lines are skipped with a warning.
+    /// @return Number of entries read, or Error if the file cannot be read or does not
+    ///         start with the manifest header
+    Result<std::size_t> loadManifest(const std::filesystem::path& path);
+
+    /// Write every known combination, plus manifest entries this run did not resolve.
+    /// @return Error if the file cannot be written
+    Result<void> saveManifest(const std::filesystem::path& path);
+
+    /// Compile and draw every known combination, then wait for the GPU.
+    /// Restores the framebuffer, viewport, program, VAO, array buffer, blend function and
+    /// state bits it touches.
+    Stats warm();
+
+private:
+    struct KeyHash {
+        std::size_t operator()(const PipelineKey& key) const;
+    };
+
+    /// Manifest line, kept by name until the shader and layout exist.
+    struct ManifestEntry {
+        std::string shader;
+        ShaderFeatures features = 0;
+        std::string layout;
+        RenderState state = 0;
+    };
+
+    struct NamedLayout {
+        std::string name;
+        VertexLayout layout;
+    };
+
+    /// Move manifest entries whose names now resolve into keys_.
+    void resolveManifest();
+
+    /// Set the enables selected by a state mask.
+    static void applyState(RenderState state);
+
+    ShaderLibrary& library_;
+    std::vector<NamedLayout> layouts_;
+    std::unordered_set<PipelineKey, KeyHash> keys_;
+    std::vector<ManifestEntry> manifest_;  ///< Unresolved entries
+};
+
+} // namespace vibegl
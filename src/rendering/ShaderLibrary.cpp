@@ -0,0 +1,388 @@
+#include "ShaderLibrary.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+#include "../core/Platform.hpp"
+#include "../core/Profiler.hpp"
+#include "ShaderManager.hpp"
+
+namespace vibegl
+{
+
+ShaderLibrary::~ShaderLibrary()
+{
+    // Programs are deleted by clear(); the GL context may already be gone here
+    watcher_.stop();
+}
+
+Result<ShaderHandle> ShaderLibrary::load(const std::string& baseName, const std::string& directory,
+                                         std::vector<std::string> keywords)
+{
+    if (keywords.size() > kMaxKeywords)
+    {
+        return std::unexpected(Error{.message = "Too many shader keywords",
+                                     .context = baseName + " declares " +
+                                                std::to_string(keywords.size())});
+    }
+
+    Entry entry;
+    entry.baseName = baseName;
+    entry.directory = directory;
+    entry.vertPath = directory + baseName + kShaderSuffix + ".vert";
+    entry.fragPath = directory + baseName + kShaderSuffix + ".frag";
+    entry.keywords = std::move(keywords);
+
+    auto vertSource = ShaderManager::readSource(entry.vertPath);
+    if (!vertSource)
+    {
+        return std::unexpected(vertSource.error());
+    }
+    auto fragSource = ShaderManager::readSource(entry.fragPath);
+    if (!fragSource)
+    {
+        return std::unexpected(fragSource.error());
+    }
+    entry.vertSource = std::move(vertSource.value());
+    entry.fragSource = std::move(fragSource.value());
+
+    auto program = ShaderManager::loadProgramFromSource(entry.vertSource, entry.fragSource);
+    if (!program)
+    {
+        return std::unexpected(program.error());
+    }
+    entry.variants.emplace(ShaderFeatures{0}, program.value());
+
+    ShaderHandle handle;
+    {
+        const std::scoped_lock lock(pendingMutex_);
+        handle.index = static_cast<std::uint32_t>(entries_.size());
+        entries_.push_back(std::move(entry));
+    }
+    if (watcher_.isRunning())
+    {
+        watchFiles(entries_[handle.index]);
+    }
+    return handle;
+}
+
+ShaderFeatures ShaderLibrary::feature(ShaderHandle handle, std::string_view keyword) const
+{
+    if (handle.index >= entries_.size())
+    {
+        return 0;
+    }
+    const std::vector<std::string>& keywords = entries_[handle.index].keywords;
+    const auto it = std::find(keywords.begin(), keywords.end(), keyword);
+    return it == keywords.end() ? 0 : ShaderFeatures{1} << (it - keywords.begin());
+}
+
+GLuint ShaderLibrary::program(ShaderHandle handle, ShaderFeatures features)
+{
+    if (handle.index >= entries_.size())
+    {
+        return 0;
+    }
+
+    Entry& entry = entries_[handle.index];
+    if (const auto it = entry.variants.find(features); it != entry.variants.end())
+    {
+        return it->second;
+    }
+
+    // First use of this variant: compile it now (cached, including failures)
+    VIBEGL_PROFILE_SCOPE("ShaderLibrary::compileVariant");
+    auto program = ShaderManager::loadProgramFromSource(entry.vertSource, entry.fragSource,
+                                                        definesFor(entry, features));
+    if (!program)
+    {
+        spdlog::error("Shader variant {} (features {:#x}) failed: {} - {}", entry.baseName,
+                      features, program.error().message, program.error().context);
+    }
+    const GLuint result = program.value_or(0);
+    entry.variants.emplace(features, result);
+    return result;
+}
+
+std::size_t ShaderLibrary::precompile(ShaderHandle handle, std::span<const ShaderFeatures> variants)
+{
+    if (handle.index >= entries_.size())
+    {
+        return variants.size();
+    }
+
+    Entry& entry = entries_[handle.index];
+    std::vector<ShaderFeatures> missing;
+    std::vector<ProgramDesc> descs;
+    for (const ShaderFeatures features : variants)
+    {
+        if (!entry.variants.contains(features) &&
+            std::find(missing.begin(), missing.end(), features) == missing.end())
+        {
+            missing.push_back(features);
+            // Same sources as program(), so a failed reload cannot mix old and new variants
+            descs.push_back(ProgramDesc{.baseName = entry.baseName,
+                                        .directory = entry.directory,
+                                        .defines = definesFor(entry, features),
+                                        .vertSource = entry.vertSource,
+                                        .fragSource = entry.fragSource});
+        }
+    }
+    if (descs.empty())
+    {
+        return 0;
+    }
+
+    VIBEGL_PROFILE_SCOPE("ShaderLibrary::precompile");
+    ProgramBatch batch = ShaderManager::loadPrograms(descs);
+    batch.wait();
+
+    std::size_t failed = 0;
+    for (std::size_t i = 0; i < missing.size(); ++i)
+    {
+        const Result<GLuint>& result = batch.result(i);
+        if (!result)
+        {
+            spdlog::error("Shader variant {} (features {:#x}) failed: {} - {}", entry.baseName,
+                          missing[i], result.error().message, result.error().context);
+            ++failed;
+        }
+        entry.variants.emplace(missing[i], result.value_or(0));
+    }
+    return failed;
+}
+
+ShaderHandle ShaderLibrary::find(std::string_view baseName) const
+{
+    const auto it = std::find_if(entries_.begin(), entries_.end(), [baseName](const Entry& entry) {
+        return entry.baseName == baseName;
+    });
+    if (it == entries_.end())
+    {
+        return ShaderHandle{};
+    }
+    return ShaderHandle{static_cast<std::uint32_t>(it - entries_.begin())};
+}
+
+std::string_view ShaderLibrary::name(ShaderHandle handle) const
+{
+    return handle.index < entries_.size() ? std::string_view(entries_[handle.index].baseName)
+                                          : std::string_view();
+}
+
+std::uint32_t ShaderLibrary::version(ShaderHandle handle) const
+{
+    return handle.index < entries_.size() ? entries_[handle.index].version : 0;
+}
+
+std::string ShaderLibrary::definesFor(const Entry& entry, ShaderFeatures features)
+{
+    std::string defines;
+    for (std::size_t i = 0; i < entry.keywords.size(); ++i)
+    {
+        if ((features & (ShaderFeatures{1} << i)) != 0)
+        {
+            defines += "#define " + entry.keywords[i] + " 1\n";
+        }
+    }
+    return defines;
+}
+
+bool ShaderLibrary::enableHotReload(std::function<void()> onChange)
+{
+    if (watcher_.isRunning())
+    {
+        return true;
+    }
+
+    onChange_ = std::move(onChange);
+    if (!watcher_.start([this](const std::filesystem::path& path) { onFileChanged(path); }))
+    {
+        return false;
+    }
+
+    const std::scoped_lock lock(pendingMutex_);
+    for (const Entry& entry : entries_)
+    {
+        watchFiles(entry);
+    }
+    spdlog::info("Shader hot reload enabled");
+    return true;
+}
+
+void ShaderLibrary::watchFiles(const Entry& entry)
+{
+    for (const std::string& file : {entry.vertPath, entry.fragPath})
+    {
+        watcher_.watch(file);
+        for (const std::filesystem::path& include :
+             ShaderManager::preprocessor().dependencies(file))
+        {
+            watcher_.watch(include);
+        }
+    }
+}
+
+void ShaderLibrary::disableHotReload()
+{
+    watcher_.stop();
+}
+
+void ShaderLibrary::onFileChanged(const std::filesystem::path& path)
+{
+    // An edited include affects every shader that pulls it in, directly or not
+    const std::filesystem::path changed = path.lexically_normal();
+    std::vector<std::filesystem::path> files = ShaderManager::preprocessor().dependents(changed);
+    files.push_back(changed);
+    const auto isAffected = [&files](const std::string& file) {
+        return std::ranges::find(files, std::filesystem::path(file).lexically_normal()) !=
+               files.end();
+    };
+
+    // Collect the affected shaders first so file reads happen outside the lock
+    // (paths never change after load(), so copying them is enough)
+    struct Affected {
+        std::uint32_t index;
+        std::string vertPath;
+        std::string fragPath;
+    };
+    std::vector<Affected> affected;
+    {
+        const std::scoped_lock lock(pendingMutex_);
+        for (std::size_t i = 0; i < entries_.size(); ++i)
+        {
+            if (isAffected(entries_[i].vertPath) || isAffected(entries_[i].fragPath))
+            {
+                affected.push_back(Affected{.index = static_cast<std::uint32_t>(i),
+                                            .vertPath = entries_[i].vertPath,
+                                            .fragPath = entries_[i].fragPath});
+            }
+        }
+    }
+    if (affected.empty())
+    {
+        return;
+    }
+
+    for (const Affected& shader : affected)
+    {
+        const std::uint32_t index = shader.index;
+        PendingReload reload{.index = index,
+                             .vertSource = ShaderManager::readSource(shader.vertPath),
+                             .fragSource = ShaderManager::readSource(shader.fragPath)};
+
+        const std::scoped_lock lock(pendingMutex_);
+        // A newer read supersedes one the GL thread has not picked up yet
+        const auto previous =
+            std::find_if(pending_.begin(), pending_.end(),
+                         [&](const PendingReload& p) { return p.index == index; });
+        if (previous != pending_.end())
+        {
+            *previous = std::move(reload);
+        }
+        else
+        {
+            pending_.push_back(std::move(reload));
+        }
+    }
+
+    spdlog::info("Shader changed: {}", changed.string());
+    if (onChange_)
+    {
+        onChange_();
+    }
+}
+
+std::size_t ShaderLibrary::applyReloads()
+{
+    std::vector<PendingReload> reloads;
+    {
+        const std::scoped_lock lock(pendingMutex_);
+        if (pending_.empty())
+        {
+            return 0;
+        }
+        reloads.swap(pending_);
+    }
+
+    VIBEGL_PROFILE_SCOPE("ShaderLibrary::applyReloads");
+    std::size_t replaced = 0;
+    for (const PendingReload& reload : reloads)
+    {
+        Entry& entry = entries_[reload.index];
+        if (!reload.vertSource || !reload.fragSource)
+        {
+            const Error& error =
+                !reload.vertSource ? reload.vertSource.error() : reload.fragSource.error();
+            spdlog::error("Shader reload failed, keeping previous program: {} - {}",
+                          error.message, error.context);
+            continue;
+        }
+
+        // Rebuild every variant in use; swap only if all of them compile
+        std::unordered_map<ShaderFeatures, GLuint> rebuilt;
+        bool failed = false;
+        for (const auto& [features, oldProgram] : entry.variants)
+        {
+            auto program = ShaderManager::loadProgramFromSource(
+                reload.vertSource.value(), reload.fragSource.value(), definesFor(entry, features));
+            if (!program && oldProgram == 0)
+            {
+                rebuilt.emplace(features, 0);  // Was already broken; must not block the rest
+                continue;
+            }
+            if (!program)
+            {
+                spdlog::error("Shader reload failed, keeping previous program: {} - {}",
+                              program.error().message, program.error().context);
+                failed = true;
+                break;
+            }
+            rebuilt.emplace(features, program.value());
+        }
+        if (failed)
+        {
+            for (const auto& [features, program] : rebuilt)
+            {
+                ShaderManager::deleteProgram(program);
+            }
+            continue;
+        }
+
+        for (const auto& [features, program] : entry.variants)
+        {
+            ShaderManager::deleteProgram(program);
+        }
+        entry.variants = std::move(rebuilt);
+        entry.vertSource = reload.vertSource.value();
+        entry.fragSource = reload.fragSource.value();
+        ++entry.version;
+        ++replaced;
+        if (watcher_.isRunning())
+        {
+            watchFiles(entry);  // The edit may have added includes
+        }
+        spdlog::info("Reloaded shader {} ({} variant(s))", entry.baseName, entry.variants.size());
+    }
+    return replaced;
+}
+
+void ShaderLibrary::clear()
+{
+    watcher_.stop();
+    const std::scoped_lock lock(pendingMutex_);
+    for (const Entry& entry : entries_)
+    {
+        for (const auto& [features, program] : entry.variants)
+        {
+            ShaderManager::deleteProgram(program);
+        }
+    }
+    entries_.clear();
+    pending_.clear();
+}
+
+} // namespace vibegl
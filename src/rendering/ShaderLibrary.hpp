@@ -0,0 +1,155 @@
+#pragma once
+
+/// @file
+/// Shader programs behind stable handles, with permutations and optional hot reload.
+
+#include "../core/FileWatcher.hpp"
+#include "../core/GLIncludes.hpp"
+#include "../core/Result.hpp"
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace vibegl {
+
+/// Stable reference to a shader owned by a ShaderLibrary.
+struct ShaderHandle {
+    static constexpr std::uint32_t kInvalid = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t index = kInvalid;
+
+    /// Check whether the handle refers to a loaded shader.
+    bool isValid() const { return index != kInvalid; }
+};
+
+/// Feature bitmask selecting a shader variant: bit i enables the shader's keyword i.
+using ShaderFeatures = std::uint32_t;
+
+/// Owns shader programs and hands out handles that survive recompilation.
+///
+/// A shader may declare feature keywords. Each combination is a separate variant,
+/// built from the same files with `#define <KEYWORD> 1` inserted after the #version
+/// line for every enabled keyword. Variants are compiled lazily the first time
+/// program() asks for them and cached by feature mask; precompile() builds a known set
+/// up front (in parallel where the driver supports it) to avoid hitches later.
+///
+/// With hot reload enabled, a FileWatcher thread notices edited shader files (including
+/// files pulled in with `#include`) and re-reads the affected shaders off the render
+/// thread. applyReloads(), called at a frame boundary on the thread owning the GL
+/// context, rebuilds every cached variant and swaps them in. If any variant fails to
+/// compile, all of the shader's old programs stay.
+///
+/// Example:
+/// ```cpp
+/// ShaderHandle cube = library.load("cube", resolvePath("data/shaders/"), {"TEXTURED"}).value();
+/// const ShaderFeatures textured = library.feature(cube, "TEXTURED");
+/// library.enableHotReload([this] { requestRedraw(); });
+///
+/// // Each frame, before drawing:
+/// if (library.applyReloads() > 0) { /* re-query uniform locations */ }
+/// glUseProgram(library.program(cube, textured));
+/// ```
+class ShaderLibrary {
+public:
+    /// Maximum number of keywords per shader (bits in ShaderFeatures).
+    static constexpr std::size_t kMaxKeywords = 32;
+
+    ShaderLibrary() = default;
+    ~ShaderLibrary();
+
+    ShaderLibrary(const ShaderLibrary&) = delete;
+    ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+    ShaderLibrary(ShaderLibrary&&) = delete;
+    ShaderLibrary& operator=(ShaderLibrary&&) = delete;
+
+    /// Load a shader with automatic platform suffix (see ShaderManager::loadProgram())
+    /// and build its base variant (no features).
+    /// @param baseName Base name without suffix
+    /// @param directory Directory containing the shader files
+    /// @param keywords Feature keywords, at most kMaxKeywords; bit i of a feature mask
+    ///                 enables keywords[i]
+    /// @return Handle on success, or Error if the files cannot be read or the base
+    ///         variant fails to build
+    Result<ShaderHandle> load(const std::string& baseName, const std::string& directory,
+                              std::vector<std::string> keywords = {});
+
+    /// Feature bit of a keyword, or 0 if the shader does not declare it.
+    ShaderFeatures feature(ShaderHandle handle, std::string_view keyword) const;
+
+    /// GL program of a variant, compiled on first use (GL thread only).
+    /// @return Program ID, or 0 for an invalid handle or a variant that failed to build
+    GLuint program(ShaderHandle handle, ShaderFeatures features = 0);
+
+    /// Build variants ahead of use (GL thread only). Compiles run as one batch, from the
+    /// same sources program() uses (the last ones that built, after a failed reload).
+    /// @return Number of variants that failed to build
+    std::size_t precompile(ShaderHandle handle, std::span<const ShaderFeatures> variants);
+
+    /// Handle of a loaded shader by base name.
+    /// @return Handle, or an invalid handle if no shader of that name is loaded
+    ShaderHandle find(std::string_view baseName) const;
+
+    /// Base name of the shader behind a handle, or empty for an invalid handle.
+    std::string_view name(ShaderHandle handle) const;
+
+    /// Number of times the shader behind a handle has been reloaded.
+    std::uint32_t version(ShaderHandle handle) const;
+
+    /// Start watching the loaded shader files (desktop only).
+    /// @param onChange Called on the watcher thread after changed sources were read,
+    ///                 e.g. to request a redraw; must be thread-safe
+    /// @return true if changes are being watched
+    bool enableHotReload(std::function<void()> onChange = {});
+
+    /// Stop watching shader files. Pending reloads are still applied.
+    void disableHotReload();
+
+    /// Rebuild shaders whose sources changed and swap them in (GL thread only).
+    /// @return Number of shaders replaced
+    std::size_t applyReloads();
+
+    /// Delete every program (GL thread only). Handles become invalid.
+    void clear();
+
+private:
+    struct Entry {
+        std::string baseName;
+        std::string directory;
+        std::string vertPath;
+        std::string fragPath;
+        std::string vertSource;  ///< Source of the current programs, for lazy variants
+        std::string fragSource;
+        std::vector<std::string> keywords;
+        std::unordered_map<ShaderFeatures, GLuint> variants;  ///< 0 = failed to build
+        std::uint32_t version = 0;
+    };
+
+    /// Sources read by the watcher thread, waiting for the GL thread.
+    struct PendingReload {
+        std::uint32_t index = 0;
+        Result<std::string> vertSource;
+        Result<std::string> fragSource;
+    };
+
+    /// Preprocessor lines enabling the keywords selected by `features`.
+    static std::string definesFor(const Entry& entry, ShaderFeatures features);
+
+    /// Watch a shader's stage files and everything they include.
+    void watchFiles(const Entry& entry);
+
+    /// Watcher thread: read both stages of every shader using the changed file.
+    void onFileChanged(const std::filesystem::path& path);
+
+    std::vector<Entry> entries_;
+    FileWatcher watcher_;
+    std::function<void()> onChange_;
+    std::mutex pendingMutex_;  ///< Guards pending_ and entries_ growth
+    std::vector<PendingReload> pending_;
+};
+
+} // namespace vibegl
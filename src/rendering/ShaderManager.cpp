@@ -2,32 +2,271 @@
 
 #include <spdlog/spdlog.h>
 
-#include <cerrno>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <cstring>
-#include <fstream>
-#include <sstream>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "../core/Hash.hpp"
+#include "../core/MappedFile.hpp"
 #include "../core/Platform.hpp"
+#include "../core/Profiler.hpp"
+
+#ifdef VIBEGL_EMBEDDED_SHADERS
+#include <EmbeddedShaders.hpp>  // Generated by cmake/EmbedShaders.cmake
+#endif
 
 namespace vibegl
 {
 
-/// Get error message for errno. Cross-platform helper to avoid MSVC warnings about strerror.
-/// @param err errno value
-/// @return Error message string
-static std::string getErrorMessage(int err)
+namespace
 {
-#ifdef _WIN32
-    // MSVC: Use strerror_s for safer error message retrieval
-    char buffer[256] = {0};
-    strerror_s(buffer, sizeof(buffer), err);
-    return buffer;
+
+/// Header preceding the driver blob in a cache file.
+struct BinaryHeader {
+    std::array<char, 4> magic{};
+    std::uint32_t version = 0;
+    std::uint32_t format = 0;
+    std::uint32_t length = 0;
+};
+
+/// GL_COMPLETION_STATUS_KHR from GL_KHR_parallel_shader_compile (not in every GL header).
+constexpr GLenum kCompletionStatus = 0x91B1;
+
+constexpr std::array<char, 4> kBinaryMagic = {'V', 'G', 'L', 'B'};
+constexpr std::uint32_t kBinaryVersion = 1;
+
+struct BinaryCacheState {
+    bool enabled = false;
+    std::filesystem::path directory;
+    std::string driver;  ///< GL_RENDERER and GL_VERSION, part of every key
+    ShaderManager::BinaryCacheStats stats;
+};
+
+BinaryCacheState& binaryCache()
+{
+    static BinaryCacheState state;
+    return state;
+}
+
+#ifdef VIBEGL_EMBEDDED_SHADERS
+constexpr bool kHasEmbeddedShaders = true;
 #else
-    // POSIX: Use standard strerror
-    return std::strerror(err);
+constexpr bool kHasEmbeddedShaders = false;
 #endif
+
+/// Whether readSource() serves embedded files; read by the hot reload thread too.
+std::atomic<bool>& embeddedShaders()
+{
+    static std::atomic<bool> enabled{kHasEmbeddedShaders};
+    return enabled;
+}
+
+/// Separable stage programs and the pipelines combining them.
+struct SeparableState {
+    std::unordered_map<std::uint64_t, GLuint> stages;     ///< Keyed by stage type and source
+    std::unordered_map<std::uint64_t, GLuint> pipelines;  ///< Keyed by (vertex, fragment) stage
+    ShaderManager::SeparableStats stats;
+};
+
+SeparableState& separable()
+{
+    static SeparableState state;
+    return state;
+}
+
+/// Reflection of every live program built by ShaderManager.
+std::unordered_map<GLuint, ShaderReflection>& reflections()
+{
+    static std::unordered_map<GLuint, ShaderReflection> table;
+    return table;
+}
+
+/// Record a successfully linked program (replacing a stale entry for a reused ID).
+void reflectProgram(GLuint program)
+{
+    reflections().insert_or_assign(program, ShaderReflection::reflect(program));
+}
+
+/// Check for GL_KHR_parallel_shader_compile once; requires a current context.
+bool hasParallelCompile()
+{
+    // The driver's default compiler thread count is kept (MAX_SHADER_COMPILER_THREADS_KHR)
+    static const bool supported = [] {
+        const bool available =
+            glfwExtensionSupported("GL_KHR_parallel_shader_compile") == GLFW_TRUE;
+        spdlog::info("Parallel shader compilation: {}", available ? "available" : "unavailable");
+        return available;
+    }();
+    return supported;
+}
+
+/// Info log of a shader object.
+std::string shaderInfoLog(GLuint shader)
+{
+    GLint logLength = 0;
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
+    std::vector<char> errorLog(static_cast<size_t>(std::max(logLength, 1)));
+    glGetShaderInfoLog(shader, logLength, &logLength, errorLog.data());
+    return errorLog.data();
+}
+
+/// Info log of a program object.
+std::string programInfoLog(GLuint program)
+{
+    GLint logLength = 0;
+    glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logLength);
+    std::vector<char> errorLog(static_cast<size_t>(std::max(logLength, 1)));
+    glGetProgramInfoLog(program, logLength, &logLength, errorLog.data());
+    return errorLog.data();
+}
+
+/// Error for a shader whose GL_COMPILE_STATUS is false.
+/// Appends the preprocessor's source legend so "N:line" in the log can be traced to a file.
+Error compileError(GLenum type, GLuint shader)
+{
+    const char* typeName = (type == GL_VERTEX_SHADER) ? "vertex" : "fragment";
+    Error error{.message = std::string(typeName) + " shader compilation failed",
+                .context = shaderInfoLog(shader)};
+
+    GLint sourceLength = 0;
+    glGetShaderiv(shader, GL_SHADER_SOURCE_LENGTH, &sourceLength);
+    std::vector<char> source(static_cast<size_t>(std::max(sourceLength, 1)));
+    glGetShaderSource(shader, sourceLength, nullptr, source.data());
+    constexpr std::string_view kLegend = "// source ";
+    for (std::string_view rest(source.data()); !rest.empty();)
+    {
+        const std::size_t lineEnd = std::min(rest.find('\n'), rest.size());
+        const std::string_view line = rest.substr(0, lineEnd);
+        if (line.starts_with("#line"))
+        {
+            break;  // The legend precedes the first #line directive
+        }
+        if (line.starts_with(kLegend))
+        {
+            error.context += '\n';
+            error.context += line.substr(3);
+        }
+        rest.remove_prefix(std::min(lineEnd + 1, rest.size()));
+    }
+    return error;
+}
+
+/// Create a shader and submit its source for compilation without waiting for it.
+GLuint submitShader(GLenum type, const std::string& source)
+{
+    GLuint shader = glCreateShader(type);
+    const char* src = source.c_str();
+    glShaderSource(shader, 1, &src, nullptr);
+    glCompileShader(shader);
+    return shader;
+}
+
+/// Cache file for a program built from the given (define-injected) sources.
+std::filesystem::path binaryPath(const std::string& vertSource, const std::string& fragSource)
+{
+    const BinaryCacheState& cache = binaryCache();
+    std::uint64_t key = fnv1a64(cache.driver);
+    key = fnv1a64(vertSource, key);
+    key = fnv1a64(std::string_view("\0", 1), key);
+    key = fnv1a64(fragSource, key);
+
+    constexpr std::string_view kHexDigits = "0123456789abcdef";
+    std::string name(16, '0');
+    for (auto digit = name.rbegin(); digit != name.rend(); ++digit, key >>= 4U)
+    {
+        *digit = kHexDigits[key & 0xFU];
+    }
+    return cache.directory / (name + ".bin");
+}
+
+#ifndef __EMSCRIPTEN__
+/// Create a program from a cached binary. Returns 0 on a miss or if the driver rejects it.
+GLuint loadBinary(const std::filesystem::path& path, bool separable = false)
+{
+    BinaryCacheState& cache = binaryCache();
+    auto file = MappedFile::open(path);
+    BinaryHeader header;
+    if (!file || file->size() < sizeof(header))
+    {
+        ++cache.stats.misses;
+        return 0;
+    }
+    std::memcpy(&header, file->bytes().data(), sizeof(header));
+    if (header.magic != kBinaryMagic || header.version != kBinaryVersion ||
+        file->size() - sizeof(header) < header.length)
+    {
+        ++cache.stats.misses;
+        return 0;
+    }
+
+    // The driver reads the blob straight from the mapping
+    GLuint program = glCreateProgram();
+    if (separable)
+    {
+        glProgramParameteri(program, GL_PROGRAM_SEPARABLE, GL_TRUE);
+    }
+    glProgramBinary(program, header.format, file->bytes().subspan(sizeof(header)).data(),
+                    static_cast<GLsizei>(header.length));
+    file = MappedFile();  // Unmap before the file may be removed below
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (success == GL_FALSE)
+    {
+        // Stale binary (driver update, different GPU): drop it and recompile
+        glDeleteProgram(program);
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+        ++cache.stats.rejected;
+        spdlog::debug("Driver rejected cached program binary {}", path.string());
+        return 0;
+    }
+
+    ++cache.stats.hits;
+    reflectProgram(program);
+    return program;
+}
+
+/// Save a linked program's binary. Failures only cost a recompile next run.
+void storeBinary(GLuint program, const std::filesystem::path& path)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+    {
+        return;
+    }
+
+    // The blob goes straight into the file contents behind its header
+    std::vector<std::byte> contents(sizeof(BinaryHeader) + static_cast<std::size_t>(length));
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, contents.data() + sizeof(BinaryHeader));
+    contents.resize(sizeof(BinaryHeader) + static_cast<std::size_t>(length));
+
+    BinaryHeader header;
+    header.magic = kBinaryMagic;
+    header.version = kBinaryVersion;
+    header.format = format;
+    header.length = static_cast<std::uint32_t>(length);
+    std::memcpy(contents.data(), &header, sizeof(header));
+
+    if (auto written = writeFileAtomically(path, contents); !written)
+    {
+        spdlog::warn("Failed to store program binary: {}", written.error().context);
+        return;
+    }
+    ++binaryCache().stats.writes;
 }
+#endif
+
+} // namespace
 
 Result<GLuint> ShaderManager::loadProgram(const std::string& baseName, const std::string& directory)
 {
@@ -39,25 +278,466 @@ Result<GLuint> ShaderManager::loadProgram(const std::string& baseName, const std
 Result<GLuint> ShaderManager::loadProgramFromFiles(const std::string& vertPath,
                                                    const std::string& fragPath)
 {
-    auto vertSource = readFile(vertPath);
+    auto vertSource = readSource(vertPath);
     if (!vertSource)
     {
         return std::unexpected(vertSource.error());
     }
 
-    auto fragSource = readFile(fragPath);
+    auto fragSource = readSource(fragPath);
     if (!fragSource)
     {
         return std::unexpected(fragSource.error());
     }
 
-    auto vertShader = compileShader(GL_VERTEX_SHADER, vertSource.value());
+    return loadProgramFromSource(vertSource.value(), fragSource.value());
+}
+
+Result<GLuint> ShaderManager::loadProgramFromSource(const std::string& vertSource,
+                                                    const std::string& fragSource,
+                                                    const std::string& defines)
+{
+    const std::string vert = injectDefines(vertSource, defines);
+    const std::string frag = injectDefines(fragSource, defines);
+
+#ifndef __EMSCRIPTEN__
+    if (binaryCache().enabled)
+    {
+        const std::filesystem::path path = binaryPath(vert, frag);
+        if (GLuint cached = loadBinary(path); cached != 0)
+        {
+            return cached;
+        }
+
+        auto program = compileAndLink(vert, frag);
+        if (program)
+        {
+            storeBinary(program.value(), path);
+        }
+        return program;
+    }
+#endif
+
+    return compileAndLink(vert, frag);
+}
+
+ProgramBatch ShaderManager::loadPrograms(std::span<const ProgramDesc> programs)
+{
+    VIBEGL_PROFILE_SCOPE("ShaderManager::loadPrograms");
+    ProgramBatch batch;
+    batch.parallel_ = hasParallelCompile();
+    batch.entries_.resize(programs.size());
+
+    // Submit every compile first, then every link: querying any status in between
+    // would make the driver finish that work before the rest is even queued
+    for (std::size_t i = 0; i < programs.size(); ++i)
+    {
+        const ProgramDesc& desc = programs[i];
+        ProgramBatch::Entry& entry = batch.entries_[i];
+        const std::string base = desc.directory + desc.baseName + kShaderSuffix;
+
+        const bool hasSources = !desc.vertSource.empty() && !desc.fragSource.empty();
+        auto vertSource = hasSources ? Result<std::string>(desc.vertSource)
+                                     : readSource(base + ".vert");
+        auto fragSource = hasSources ? Result<std::string>(desc.fragSource)
+                                     : readSource(base + ".frag");
+        if (!vertSource || !fragSource)
+        {
+            entry.result = std::unexpected(!vertSource ? vertSource.error() : fragSource.error());
+            ++batch.completed_;
+            continue;
+        }
+
+        const std::string vert = injectDefines(vertSource.value(), desc.defines);
+        const std::string frag = injectDefines(fragSource.value(), desc.defines);
+#ifndef __EMSCRIPTEN__
+        if (binaryCache().enabled)
+        {
+            entry.cachePath = binaryPath(vert, frag);
+            if (GLuint cached = loadBinary(entry.cachePath); cached != 0)
+            {
+                entry.result = cached;
+                ++batch.completed_;
+                continue;
+            }
+        }
+#endif
+        entry.vertShader = submitShader(GL_VERTEX_SHADER, vert);
+        entry.fragShader = submitShader(GL_FRAGMENT_SHADER, frag);
+    }
+
+    for (ProgramBatch::Entry& entry : batch.entries_)
+    {
+        if (entry.result.has_value())
+        {
+            continue;
+        }
+        entry.program = glCreateProgram();
+        glAttachShader(entry.program, entry.vertShader);
+        glAttachShader(entry.program, entry.fragShader);
+#ifndef __EMSCRIPTEN__
+        if (!entry.cachePath.empty())
+        {
+            glProgramParameteri(entry.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+#endif
+        glLinkProgram(entry.program);
+    }
+
+    return batch;
+}
+
+ProgramBatch::~ProgramBatch()
+{
+    release();
+}
+
+ProgramBatch::ProgramBatch(ProgramBatch&& other) noexcept
+    : entries_(std::move(other.entries_)), completed_(std::exchange(other.completed_, 0)),
+      parallel_(other.parallel_)
+{
+    other.entries_.clear();
+}
+
+ProgramBatch& ProgramBatch::operator=(ProgramBatch&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        entries_ = std::move(other.entries_);
+        completed_ = std::exchange(other.completed_, 0);
+        parallel_ = other.parallel_;
+        other.entries_.clear();
+    }
+    return *this;
+}
+
+bool ProgramBatch::poll()
+{
+    for (Entry& entry : entries_)
+    {
+        if (entry.result.has_value())
+        {
+            continue;
+        }
+        if (parallel_)
+        {
+            GLint complete = GL_FALSE;
+            glGetProgramiv(entry.program, kCompletionStatus, &complete);
+            if (complete == GL_FALSE)
+            {
+                continue;
+            }
+            finish(entry);
+        }
+        else
+        {
+            // Without the extension any status query blocks, so finish one per call
+            finish(entry);
+            break;
+        }
+    }
+    return isDone();
+}
+
+void ProgramBatch::wait()
+{
+    for (Entry& entry : entries_)
+    {
+        if (!entry.result.has_value())
+        {
+            finish(entry);
+        }
+    }
+}
+
+void ProgramBatch::finish(Entry& entry)
+{
+    GLint linked = GL_FALSE;
+    glGetProgramiv(entry.program, GL_LINK_STATUS, &linked);
+    if (linked == GL_TRUE)
+    {
+        entry.result = entry.program;
+        reflectProgram(entry.program);
+#ifndef __EMSCRIPTEN__
+        if (!entry.cachePath.empty())
+        {
+            storeBinary(entry.program, entry.cachePath);
+        }
+#endif
+    }
+    else
+    {
+        // Report the stage that failed to compile, if any, rather than the link error
+        GLint compiled = GL_FALSE;
+        glGetShaderiv(entry.vertShader, GL_COMPILE_STATUS, &compiled);
+        if (compiled == GL_FALSE)
+        {
+            entry.result = std::unexpected(compileError(GL_VERTEX_SHADER, entry.vertShader));
+        }
+        else if (glGetShaderiv(entry.fragShader, GL_COMPILE_STATUS, &compiled);
+                 compiled == GL_FALSE)
+        {
+            entry.result = std::unexpected(compileError(GL_FRAGMENT_SHADER, entry.fragShader));
+        }
+        else
+        {
+            entry.result = std::unexpected(Error{.message = "Shader program linking failed",
+                                                 .context = programInfoLog(entry.program)});
+        }
+        glDeleteProgram(entry.program);
+    }
+
+    glDeleteShader(entry.vertShader);
+    glDeleteShader(entry.fragShader);
+    entry.vertShader = 0;
+    entry.fragShader = 0;
+    entry.program = 0;
+    ++completed_;
+}
+
+void ProgramBatch::release()
+{
+    for (Entry& entry : entries_)
+    {
+        if (!entry.result.has_value())
+        {
+            glDeleteShader(entry.vertShader);
+            glDeleteShader(entry.fragShader);
+            glDeleteProgram(entry.program);
+        }
+    }
+    entries_.clear();
+    completed_ = 0;
+}
+
+bool ShaderManager::enableBinaryCache(const std::string& directory)
+{
+#ifdef __EMSCRIPTEN__
+    static_cast<void>(directory);
+    return false;
+#else
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats == 0)
+    {
+        spdlog::info("Program binary cache disabled: driver reports no binary formats");
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error)
+    {
+        spdlog::warn("Program binary cache disabled: cannot create {}: {}", directory,
+                     error.message());
+        return false;
+    }
+
+    const auto* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    const auto* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    BinaryCacheState& cache = binaryCache();
+    cache.driver = std::string(renderer != nullptr ? renderer : "") + '\n' +
+                   (version != nullptr ? version : "");
+    cache.directory = directory;
+    cache.stats = {};
+    cache.enabled = true;
+    spdlog::info("Program binary cache: {}", directory);
+    return true;
+#endif
+}
+
+void ShaderManager::disableBinaryCache()
+{
+    binaryCache().enabled = false;
+}
+
+ShaderManager::BinaryCacheStats ShaderManager::binaryCacheStats()
+{
+    return binaryCache().stats;
+}
+
+bool ShaderManager::hasSeparateShaderObjects()
+{
+    // Desktop contexts are 4.6 core; ES 3.0 and WebGL 2 have no program pipelines
+    return kIsDesktop;
+}
+
+Result<GLuint> ShaderManager::loadStage(GLenum type, const std::string& path,
+                                        const std::string& defines)
+{
+    auto source = readSource(path);
+    if (!source)
+    {
+        return std::unexpected(source.error());
+    }
+    return loadStageFromSource(type, source.value(), defines);
+}
+
+Result<GLuint> ShaderManager::loadStageFromSource(GLenum type, const std::string& source,
+                                                  const std::string& defines)
+{
+#ifdef __EMSCRIPTEN__
+    static_cast<void>(type);
+    static_cast<void>(source);
+    static_cast<void>(defines);
+    return std::unexpected(Error{.message = "Separable shader programs are not supported",
+                                 .context = "WebGL 2 has no program pipelines"});
+#else
+    const std::string stageSource = injectDefines(source, defines);
+    const std::string_view tag =
+        type == GL_VERTEX_SHADER ? "separable vertex" : "separable fragment";
+    const std::uint64_t key = fnv1a64(stageSource, fnv1a64(tag));
+
+    SeparableState& state = separable();
+    if (const auto cached = state.stages.find(key); cached != state.stages.end())
+    {
+        ++state.stats.stageReuses;
+        return cached->second;
+    }
+
+    GLuint program = 0;
+    std::filesystem::path cachePath;
+    if (binaryCache().enabled)
+    {
+        // The tag stands in for the second stage of a full program's key
+        cachePath = binaryPath(stageSource, std::string(tag));
+        program = loadBinary(cachePath, true);
+    }
+    if (program == 0)
+    {
+        auto linked = linkStage(type, stageSource);
+        if (!linked)
+        {
+            return std::unexpected(linked.error());
+        }
+        program = linked.value();
+        if (!cachePath.empty())
+        {
+            storeBinary(program, cachePath);
+        }
+    }
+
+    state.stages.emplace(key, program);
+    ++state.stats.stagesBuilt;
+    return program;
+#endif
+}
+
+Result<GLuint> ShaderManager::pipeline(GLuint vertStage, GLuint fragStage)
+{
+#ifdef __EMSCRIPTEN__
+    static_cast<void>(vertStage);
+    static_cast<void>(fragStage);
+    return std::unexpected(Error{.message = "Separable shader programs are not supported",
+                                 .context = "WebGL 2 has no program pipelines"});
+#else
+    SeparableState& state = separable();
+    const std::uint64_t key = (std::uint64_t{vertStage} << 32U) | fragStage;
+    if (const auto cached = state.pipelines.find(key); cached != state.pipelines.end())
+    {
+        ++state.stats.pipelineReuses;
+        return cached->second;
+    }
+
+    const auto isStage = [&state](GLuint program) {
+        return std::ranges::any_of(state.stages, [program](const auto& stage) {
+            return stage.second == program;
+        });
+    };
+    if (!isStage(vertStage) || !isStage(fragStage))
+    {
+        return std::unexpected(Error{.message = "Not a separable stage",
+                                     .context = "Pipeline stages must come from loadStage()"});
+    }
+
+    GLuint pipeline = 0;
+    glGenProgramPipelines(1, &pipeline);
+    glUseProgramStages(pipeline, GL_VERTEX_SHADER_BIT, vertStage);
+    glUseProgramStages(pipeline, GL_FRAGMENT_SHADER_BIT, fragStage);
+
+    // Validation also depends on draw-time state (e.g. sampler units), so only warn
+    glValidateProgramPipeline(pipeline);
+    GLint valid = GL_FALSE;
+    glGetProgramPipelineiv(pipeline, GL_VALIDATE_STATUS, &valid);
+    if (valid == GL_FALSE)
+    {
+        GLint logLength = 0;
+        glGetProgramPipelineiv(pipeline, GL_INFO_LOG_LENGTH, &logLength);
+        std::vector<char> log(static_cast<size_t>(std::max(logLength, 1)));
+        glGetProgramPipelineInfoLog(pipeline, logLength, &logLength, log.data());
+        spdlog::warn("Program pipeline ({}, {}) failed validation: {}", vertStage, fragStage,
+                     log.data());
+    }
+
+    state.pipelines.emplace(key, pipeline);
+    ++state.stats.pipelinesBuilt;
+    return pipeline;
+#endif
+}
+
+void ShaderManager::clearStages()
+{
+    SeparableState& state = separable();
+#ifndef __EMSCRIPTEN__
+    for (const auto& [key, pipeline] : state.pipelines)
+    {
+        glDeleteProgramPipelines(1, &pipeline);
+    }
+#endif
+    for (const auto& [key, program] : state.stages)
+    {
+        deleteProgram(program);
+    }
+    state = SeparableState{};
+}
+
+ShaderManager::SeparableStats ShaderManager::separableStats()
+{
+    return separable().stats;
+}
+
+std::string ShaderManager::injectDefines(const std::string& source, const std::string& defines)
+{
+    if (defines.empty())
+    {
+        return source;
+    }
+
+    // #version must stay the first line, so defines go right after it
+    std::size_t insertAt = 0;
+    if (source.starts_with("#version"))
+    {
+        const std::size_t lineEnd = source.find('\n');
+        insertAt = lineEnd == std::string::npos ? source.size() : lineEnd + 1;
+    }
+
+    std::string result;
+    result.reserve(source.size() + defines.size() + 1);
+    result.append(source, 0, insertAt);
+    if (insertAt == source.size() && !source.empty() && source.back() != '\n')
+    {
+        result += '\n';
+    }
+    result += defines;
+    if (defines.back() != '\n')
+    {
+        result += '\n';
+    }
+    result.append(source, insertAt);
+    return result;
+}
+
+Result<GLuint> ShaderManager::compileAndLink(const std::string& vertSource,
+                                             const std::string& fragSource)
+{
+    auto vertShader = compileShader(GL_VERTEX_SHADER, vertSource);
     if (!vertShader)
     {
         return std::unexpected(vertShader.error());
     }
 
-    auto fragShader = compileShader(GL_FRAGMENT_SHADER, fragSource.value());
+    auto fragShader = compileShader(GL_FRAGMENT_SHADER, fragSource);
     if (!fragShader)
     {
         glDeleteShader(vertShader.value());
@@ -73,53 +753,132 @@ Result<GLuint> ShaderManager::loadProgramFromFiles(const std::string& vertPath,
     return program;
 }
 
+Result<GLuint> ShaderManager::linkStage(GLenum type, const std::string& source)
+{
+#ifdef __EMSCRIPTEN__
+    static_cast<void>(type);
+    static_cast<void>(source);
+    return std::unexpected(Error{.message = "Separable shader programs are not supported",
+                                 .context = "WebGL 2 has no program pipelines"});
+#else
+    auto shader = compileShader(type, source);
+    if (!shader)
+    {
+        return std::unexpected(shader.error());
+    }
+
+    GLuint program = glCreateProgram();
+    glProgramParameteri(program, GL_PROGRAM_SEPARABLE, GL_TRUE);
+    if (binaryCache().enabled)
+    {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glAttachShader(program, shader.value());
+    glLinkProgram(program);
+    glDetachShader(program, shader.value());
+    glDeleteShader(shader.value());
+
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (success == GL_FALSE)
+    {
+        Error error{.message = "Separable program linking failed",
+                    .context = programInfoLog(program)};
+        glDeleteProgram(program);
+        return std::unexpected(std::move(error));
+    }
+
+    reflectProgram(program);
+    return program;
+#endif
+}
+
 void ShaderManager::deleteProgram(GLuint program)
 {
     if (program != 0)
     {
+        reflections().erase(program);
         glDeleteProgram(program);
     }
 }
 
+ShaderReflection* ShaderManager::reflection(GLuint program)
+{
+    const auto it = reflections().find(program);
+    return it != reflections().end() ? &it->second : nullptr;
+}
+
 Result<std::string> ShaderManager::readFile(const std::string& path)
 {
-    std::ifstream file(path);
-    if (!file.is_open())
+    auto file = MappedFile::open(path);
+    if (!file)
+    {
+        return std::unexpected(
+            Error{.message = "Failed to open shader file", .context = file.error().context});
+    }
+    return std::string(file->text());
+}
+
+Result<std::string> ShaderManager::readSource(const std::string& path)
+{
+    return preprocessor().process(path);
+}
+
+ShaderPreprocessor& ShaderManager::preprocessor()
+{
+    static ShaderPreprocessor instance;
+    return instance;
+}
+
+void ShaderManager::setEmbeddedShadersEnabled(bool enabled)
+{
+    embeddedShaders().store(enabled && kHasEmbeddedShaders);
+}
+
+bool ShaderManager::embeddedShadersEnabled()
+{
+    return embeddedShaders().load();
+}
+
+std::optional<std::string_view> ShaderManager::embeddedFile(const std::filesystem::path& path)
+{
+#ifdef VIBEGL_EMBEDDED_SHADERS
+    if (!embeddedShaders().load())
     {
-        int err = errno;
-        return std::unexpected(Error{.message = "Failed to open shader file",
-                                     .context = path + " (errno: " + std::to_string(err) + " - " +
-                                                getErrorMessage(err) + ")"});
+        return std::nullopt;
     }
 
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
+    // A handful of files: a linear suffix match beats building an index
+    const std::string key = path.lexically_normal().generic_string();
+    for (const embedded::File& file : embedded::kFiles)
+    {
+        const bool matches =
+            key == file.path ||
+            (key.ends_with(file.path) && key[key.size() - file.path.size() - 1] == '/');
+        if (matches)
+        {
+            return std::string_view(reinterpret_cast<const char*>(file.contents.data()),
+                                    file.contents.size());
+        }
+    }
+#else
+    static_cast<void>(path);
+#endif
+    return std::nullopt;
 }
 
 Result<GLuint> ShaderManager::compileShader(GLenum type, const std::string& source)
 {
-    GLuint shader = glCreateShader(type);
-    const char* src = source.c_str();
-    glShaderSource(shader, 1, &src, nullptr);
-    glCompileShader(shader);
+    GLuint shader = submitShader(type, source);
 
     GLint success = 0;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
 
     if (success == GL_FALSE)
     {
-        GLint logLength = 0;
-        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
-        std::vector<char> errorLog(static_cast<size_t>(logLength));
-        glGetShaderInfoLog(shader, logLength, &logLength, errorLog.data());
-
-        const char* typeName = (type == GL_VERTEX_SHADER) ? "vertex" : "fragment";
-
+        Error error = compileError(type, shader);
         glDeleteShader(shader);
-        return std::unexpected(
-            Error{.message = std::string(typeName) + " shader compilation failed",
-                  .context = std::string(errorLog.data())});
+        return std::unexpected(std::move(error));
     }
 
     return shader;
@@ -130,6 +889,12 @@ Result<GLuint> ShaderManager::linkProgram(GLuint vertShader, GLuint fragShader)
     GLuint program = glCreateProgram();
     glAttachShader(program, vertShader);
     glAttachShader(program, fragShader);
+#ifndef __EMSCRIPTEN__
+    if (binaryCache().enabled)
+    {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+#endif
     glLinkProgram(program);
 
     GLint success = 0;
@@ -137,16 +902,13 @@ Result<GLuint> ShaderManager::linkProgram(GLuint vertShader, GLuint fragShader)
 
     if (success == GL_FALSE)
     {
-        GLint logLength = 0;
-        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logLength);
-        std::vector<char> errorLog(static_cast<size_t>(logLength));
-        glGetProgramInfoLog(program, logLength, &logLength, errorLog.data());
-
+        std::string log = programInfoLog(program);
         glDeleteProgram(program);
-        return std::unexpected(Error{.message = "Shader program linking failed",
-                                     .context = std::string(errorLog.data())});
+        return std::unexpected(
+            Error{.message = "Shader program linking failed", .context = std::move(log)});
     }
 
+    reflectProgram(program);
     return program;
 }
 
@@ -5,10 +5,89 @@
 
 #include "../core/GLIncludes.hpp"
 #include "../core/Result.hpp"
+#include "ShaderPreprocessor.hpp"
+#include "ShaderReflection.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace vibegl {
 
+/// Description of one program for ShaderManager::loadPrograms().
+struct ProgramDesc {
+    std::string baseName;               ///< Base name without suffix (e.g., "cube")
+    std::string directory = "shaders/"; ///< Directory containing the shader files
+    std::string defines;                ///< Preprocessor lines inserted after #version
+    std::string vertSource;  ///< Preprocessed vertex source; with fragSource, used instead
+    std::string fragSource;  ///< of reading the files (e.g. a shader's last good sources)
+};
+
+/// Programs compiling in the background, returned by ShaderManager::loadPrograms().
+///
+/// Call poll() once per frame on the thread owning the GL context until it returns
+/// true; a loading screen can show completedCount() / size() meanwhile. Successfully
+/// built programs belong to the caller; programs still compiling when the batch is
+/// destroyed are deleted.
+class ProgramBatch {
+public:
+    ProgramBatch() = default;
+    ~ProgramBatch();
+
+    ProgramBatch(const ProgramBatch&) = delete;
+    ProgramBatch& operator=(const ProgramBatch&) = delete;
+    ProgramBatch(ProgramBatch&& other) noexcept;
+    ProgramBatch& operator=(ProgramBatch&& other) noexcept;
+
+    /// Collect programs the driver has finished, without blocking when
+    /// GL_KHR_parallel_shader_compile is available (otherwise finishes one per call).
+    /// @return true once every program is finished
+    bool poll();
+
+    /// Block until every program is finished.
+    void wait();
+
+    /// Check whether every program is finished.
+    bool isDone() const { return completed_ == entries_.size(); }
+
+    /// Number of programs in the batch.
+    std::size_t size() const { return entries_.size(); }
+
+    /// Number of finished programs (successful or not).
+    std::size_t completedCount() const { return completed_; }
+
+    /// Check whether the program at `index` (order of the descriptions) is finished.
+    bool isReady(std::size_t index) const { return entries_[index].result.has_value(); }
+
+    /// Program ID or Error of a finished entry (see isReady()).
+    const Result<GLuint>& result(std::size_t index) const { return *entries_[index].result; }
+
+private:
+    friend class ShaderManager;
+
+    struct Entry {
+        GLuint vertShader = 0;
+        GLuint fragShader = 0;
+        GLuint program = 0;
+        std::filesystem::path cachePath;  ///< Binary cache file (empty if caching is off)
+        std::optional<Result<GLuint>> result;
+    };
+
+    /// Check link status and release the shaders of a submitted entry.
+    void finish(Entry& entry);
+
+    /// Delete GL objects of unfinished entries.
+    void release();
+
+    std::vector<Entry> entries_;
+    std::size_t completed_ = 0;
+    bool parallel_ = false;  ///< Completion can be queried without blocking
+};
+
 /// Utilities for loading and compiling OpenGL shaders.
 ///
 /// ShaderManager handles platform-specific shader variants automatically.
@@ -20,8 +99,29 @@ namespace vibegl {
 /// // Loads "shaders/cube_gl46.vert" on desktop, "shaders/cube_es3.vert" on web
 /// GLuint program = ShaderManager::loadProgram("cube");
 /// ```
+///
+/// With enableBinaryCache(), linked programs are saved via glGetProgramBinary and
+/// restored with glProgramBinary on later runs, skipping compilation entirely. Entries
+/// are keyed by the shader sources, defines and the GL_RENDERER/GL_VERSION strings, so
+/// a driver update or source edit simply misses. Not available on WebGL.
 class ShaderManager {
 public:
+    /// Program binary cache counters since enableBinaryCache().
+    struct BinaryCacheStats {
+        std::uint64_t hits = 0;      ///< Programs restored from a cached binary
+        std::uint64_t misses = 0;    ///< Programs compiled because no binary was cached
+        std::uint64_t rejected = 0;  ///< Cached binaries the driver refused (recompiled)
+        std::uint64_t writes = 0;    ///< Binaries written to the cache
+    };
+
+    /// Separable stage and pipeline counters since the last clearStages().
+    struct SeparableStats {
+        std::uint64_t stagesBuilt = 0;     ///< Stage programs linked or restored from the cache
+        std::uint64_t stageReuses = 0;     ///< loadStage() calls served by an existing stage
+        std::uint64_t pipelinesBuilt = 0;  ///< Program pipeline objects created
+        std::uint64_t pipelineReuses = 0;  ///< pipeline() calls served by an existing pipeline
+    };
+
     /// Load shader program with automatic platform suffix.
     /// @param baseName Base name without suffix (e.g., "cube" loads cube_gl46 or cube_es3)
     /// @param directory Directory containing shaders (default: "shaders/")
@@ -34,16 +134,111 @@ public:
     /// @return OpenGL program ID on success, or Error on failure
     static Result<GLuint> loadProgramFromFiles(const std::string& vertPath, const std::string& fragPath);
 
-    /// Delete a shader program.
+    /// Build a shader program from GLSL source strings.
+    /// @param vertSource Vertex shader source starting with a #version line
+    /// @param fragSource Fragment shader source starting with a #version line
+    /// @param defines Preprocessor lines (e.g. "#define FOO 1\n") inserted after #version
+    /// @return OpenGL program ID on success, or Error on failure
+    static Result<GLuint> loadProgramFromSource(const std::string& vertSource,
+                                                const std::string& fragSource,
+                                                const std::string& defines = {});
+
+    /// Start building several programs at once.
+    /// Every compile and link is submitted before any status is queried, so drivers
+    /// with GL_KHR_parallel_shader_compile build them on their own threads.
+    /// @param programs Programs to build (shader files not given as sources are read
+    ///                 synchronously)
+    /// @return Batch to poll for the results, in the order of `programs`
+    static ProgramBatch loadPrograms(std::span<const ProgramDesc> programs);
+
+    /// Store and reuse linked program binaries in a directory (created if missing).
+    /// Requires a current OpenGL context. No-op where program binaries are unsupported.
+    /// @param directory Cache directory
+    /// @return true if the cache is active
+    static bool enableBinaryCache(const std::string& directory);
+
+    /// Stop reading and writing program binaries.
+    static void disableBinaryCache();
+
+    /// Hit/miss counters of the binary cache.
+    static BinaryCacheStats binaryCacheStats();
+
+    /// Check whether separable programs and program pipelines are available
+    /// (GL_ARB_separate_shader_objects, core since desktop GL 4.1; not in WebGL 2).
+    static bool hasSeparateShaderObjects();
+
+    /// Build one shader stage as a separable program, for combining with pipeline().
+    /// Stages are cached by type and source (after defines), so materials that share a
+    /// vertex shader compile and link it once; the binary cache applies as well.
+    /// Desktop GLSL requires a stage feeding another to redeclare `out gl_PerVertex`.
+    /// @param type GL_VERTEX_SHADER or GL_FRAGMENT_SHADER
+    /// @param path Shader file (read with readSource())
+    /// @param defines Preprocessor lines inserted after #version
+    /// @return Stage program owned by ShaderManager (see clearStages()), or Error
+    static Result<GLuint> loadStage(GLenum type, const std::string& path,
+                                    const std::string& defines = {});
+
+    /// Build a separable stage from GLSL source (see loadStage()).
+    static Result<GLuint> loadStageFromSource(GLenum type, const std::string& source,
+                                              const std::string& defines = {});
+
+    /// Program pipeline object combining a vertex and a fragment stage.
+    /// Pipelines are cached per pair, so asking again is a hash lookup. Bind with
+    /// glUseProgram(0) followed by glBindProgramPipeline(); set uniforms after
+    /// glActiveShaderProgram(pipeline, stage) through reflection(stage). Validation
+    /// problems (e.g. mismatched stage interfaces) are logged as warnings.
+    /// @param vertStage Vertex stage from loadStage()
+    /// @param fragStage Fragment stage from loadStage()
+    /// @return Pipeline owned by ShaderManager, or Error if a stage is not from loadStage()
+    static Result<GLuint> pipeline(GLuint vertStage, GLuint fragStage);
+
+    /// Delete every stage program and pipeline and reset their counters (GL thread only).
+    static void clearStages();
+
+    /// Stage and pipeline counters.
+    static SeparableStats separableStats();
+
+    /// Reflection of a program built by ShaderManager (GL thread only).
+    /// Every successful link or binary load records the program's uniforms, blocks and
+    /// attributes; the entry lives until deleteProgram().
+    /// @param program OpenGL program ID
+    /// @return Reflection, or nullptr for programs not built by ShaderManager
+    static ShaderReflection* reflection(GLuint program);
+
+    /// Delete a shader program and its reflection.
     /// @param program OpenGL program ID to delete
     static void deleteProgram(GLuint program);
 
-private:
     /// Read entire file contents into string.
     /// @param path Path to file
     /// @return File contents on success, or Error on failure
     static Result<std::string> readFile(const std::string& path);
 
+    /// Read a shader file with its `#include`s expanded (see ShaderPreprocessor).
+    /// All shader loading goes through this, so unchanged files are not re-read.
+    /// @param path Path to the shader file
+    /// @return Expanded source on success, or Error on failure
+    static Result<std::string> readSource(const std::string& path);
+
+    /// Process-wide include cache used by readSource() (thread-safe).
+    static ShaderPreprocessor& preprocessor();
+
+    /// Serve shader files from the copies compiled into the executable.
+    /// Builds with EMBED_SHADERS (the default) start with this on, so loading shaders
+    /// needs no file I/O; turn it off during development to read (and hot reload) the
+    /// files on disk instead. Has no effect in builds without embedded shaders.
+    static void setEmbeddedShadersEnabled(bool enabled);
+
+    /// Check whether embedded shader files are being served.
+    static bool embeddedShadersEnabled();
+
+    /// Embedded copy of a shader file (thread-safe).
+    /// A path matches an embedded file if it ends with the file's path relative to the
+    /// source root, e.g. "/opt/app/data/shaders/cube_gl46.vert".
+    /// @return Contents, or nullopt if the file is not embedded or embedding is off
+    static std::optional<std::string_view> embeddedFile(const std::filesystem::path& path);
+
+private:
     /// Compile a shader from source.
     /// @param type GL_VERTEX_SHADER or GL_FRAGMENT_SHADER
     /// @param source GLSL source code
@@ -55,6 +250,16 @@ private:
     /// @param fragShader Compiled fragment shader
     /// @return Program ID on success, or Error on failure
     static Result<GLuint> linkProgram(GLuint vertShader, GLuint fragShader);
+
+    /// Compile and link a single separable stage.
+    static Result<GLuint> linkStage(GLenum type, const std::string& source);
+
+    /// Compile and link sources that already contain their defines.
+    static Result<GLuint> compileAndLink(const std::string& vertSource,
+                                         const std::string& fragSource);
+
+    /// Insert preprocessor lines after the #version line of a shader source.
+    static std::string injectDefines(const std::string& source, const std::string& defines);
 };
 
 } // namespace vibegl
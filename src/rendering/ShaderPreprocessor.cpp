@@ -0,0 +1,254 @@
+#include "ShaderPreprocessor.hpp"
+
+#include <algorithm>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "../core/MappedFile.hpp"
+#include "ShaderManager.hpp"
+
+namespace vibegl
+{
+
+namespace
+{
+
+/// Cache key of a path: lexically normalized so "a/../b.glsl" and "b.glsl" match.
+std::string chunkKey(const std::filesystem::path& path)
+{
+    return path.lexically_normal().string();
+}
+
+} // namespace
+
+Result<std::string> ShaderPreprocessor::process(const std::filesystem::path& file)
+{
+    const std::scoped_lock lock(mutex_);
+    const std::string key = chunkKey(file);
+
+    Expansion expansion;
+    auto expanded = expand(key, expansion);
+    if (!expanded)
+    {
+        return std::unexpected(expanded.error());
+    }
+
+    // #version must stay first; the legend maps #line source numbers back to files
+    const Chunk& root = chunks_.at(key);
+    std::string source;
+    source.reserve(expansion.body.size() + 256);
+    if (!root.version.empty())
+    {
+        source += root.version;
+        source += '\n';
+    }
+    for (std::size_t i = 0; i < expansion.files.size(); ++i)
+    {
+        source += "// source " + std::to_string(i) + ": " + expansion.files[i] + '\n';
+    }
+    source += expansion.body;
+    return source;
+}
+
+std::vector<std::filesystem::path>
+ShaderPreprocessor::dependencies(const std::filesystem::path& file)
+{
+    const std::scoped_lock lock(mutex_);
+    std::vector<std::filesystem::path> result;
+    std::vector<std::string> pending = {chunkKey(file)};
+    std::unordered_set<std::string> seen(pending.begin(), pending.end());
+    while (!pending.empty())
+    {
+        const auto chunk = chunks_.find(pending.back());
+        pending.pop_back();
+        if (chunk == chunks_.end())
+        {
+            continue;
+        }
+        for (const std::string& include : chunk->second.includes)
+        {
+            if (seen.insert(include).second)
+            {
+                result.emplace_back(include);
+                pending.push_back(include);
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<std::filesystem::path> ShaderPreprocessor::dependents(const std::filesystem::path& file)
+{
+    const std::scoped_lock lock(mutex_);
+    std::vector<std::filesystem::path> result;
+    std::vector<std::string> pending = {chunkKey(file)};
+    std::unordered_set<std::string> seen(pending.begin(), pending.end());
+    while (!pending.empty())
+    {
+        const std::string current = std::move(pending.back());
+        pending.pop_back();
+        for (const auto& [key, chunk] : chunks_)
+        {
+            if (!seen.contains(key) &&
+                std::find(chunk.includes.begin(), chunk.includes.end(), current) !=
+                    chunk.includes.end())
+            {
+                seen.insert(key);
+                result.emplace_back(key);
+                pending.push_back(key);
+            }
+        }
+    }
+    return result;
+}
+
+void ShaderPreprocessor::clear()
+{
+    const std::scoped_lock lock(mutex_);
+    chunks_.clear();
+}
+
+ShaderPreprocessor::Stats ShaderPreprocessor::stats()
+{
+    const std::scoped_lock lock(mutex_);
+    return stats_;
+}
+
+Result<const ShaderPreprocessor::Chunk*> ShaderPreprocessor::refresh(const std::string& key)
+{
+    // Embedded files never change: parse once, never touch the file system
+    if (const auto embedded = ShaderManager::embeddedFile(key))
+    {
+        const auto cached = chunks_.find(key);
+        if (cached != chunks_.end() && cached->second.embedded)
+        {
+            ++stats_.reuses;
+            return &cached->second;
+        }
+        Chunk& stored = chunks_[key];
+        stored = parse(key, *embedded);
+        stored.embedded = true;
+        ++stats_.parses;
+        return &stored;
+    }
+
+    // A stat is all an unchanged file costs
+    std::error_code error;
+    const auto modified = std::filesystem::last_write_time(key, error);
+    const auto cached = chunks_.find(key);
+    if (!error && cached != chunks_.end() && !cached->second.embedded &&
+        cached->second.modified == modified)
+    {
+        ++stats_.reuses;
+        return &cached->second;
+    }
+
+    // Parsed straight from the file's pages; the chunk keeps only its own copy of the text
+    auto file = MappedFile::open(key);
+    if (!file)
+    {
+        chunks_.erase(key);
+        return std::unexpected(
+            Error{.message = "Failed to open shader file", .context = file.error().context});
+    }
+
+    Chunk chunk = parse(key, file->text());
+    chunk.modified = modified;
+    ++stats_.parses;
+    Chunk& stored = chunks_[key];
+    stored = std::move(chunk);
+    return &stored;
+}
+
+ShaderPreprocessor::Chunk ShaderPreprocessor::parse(const std::string& key,
+                                                    std::string_view contents)
+{
+    const std::filesystem::path directory = std::filesystem::path(key).parent_path();
+    Chunk chunk;
+    Piece current;
+    int line = 0;
+    for (std::size_t position = 0; position < contents.size();)
+    {
+        std::size_t end = contents.find('\n', position);
+        end = end == std::string::npos ? contents.size() : end;
+        const std::string_view text(contents.data() + position, end - position);
+        position = end + 1;
+        ++line;
+
+        if (line == 1 && text.starts_with("#version"))
+        {
+            chunk.version = text;
+            current.firstLine = 2;
+            continue;
+        }
+
+        const std::string_view trimmed =
+            text.substr(std::min(text.find_first_not_of(" \t"), text.size()));
+        if (trimmed.starts_with("#include"))
+        {
+            const std::size_t open = trimmed.find('"');
+            const std::size_t close =
+                open == std::string_view::npos ? open : trimmed.find('"', open + 1);
+            if (close != std::string_view::npos)
+            {
+                const std::string_view name = trimmed.substr(open + 1, close - open - 1);
+                current.include = chunkKey(directory / name);
+                current.includeLine = line;
+                chunk.includes.push_back(current.include);
+                chunk.pieces.push_back(std::move(current));
+                current = Piece{};
+                current.firstLine = line + 1;
+                continue;
+            }
+            // Malformed directive: leave it in place for the compiler to report
+        }
+
+        current.text.append(text);
+        current.text += '\n';
+    }
+    chunk.pieces.push_back(std::move(current));
+    return chunk;
+}
+
+Result<void> ShaderPreprocessor::expand(const std::string& key, Expansion& expansion)
+{
+    if (!expansion.included.insert(key).second)
+    {
+        return {};
+    }
+
+    auto chunk = refresh(key);
+    if (!chunk)
+    {
+        return std::unexpected(chunk.error());
+    }
+
+    const std::string sourceNumber = std::to_string(expansion.files.size());
+    expansion.files.push_back(key);
+
+    for (const Piece& piece : chunk.value()->pieces)
+    {
+        if (!piece.text.empty())
+        {
+            expansion.body +=
+                "#line " + std::to_string(piece.firstLine) + ' ' + sourceNumber + '\n';
+            expansion.body += piece.text;
+        }
+        if (!piece.include.empty())
+        {
+            auto included = expand(piece.include, expansion);
+            if (!included)
+            {
+                Error error = std::move(included.error());
+                error.context += " (included from " + key + ':' +
+                                 std::to_string(piece.includeLine) + ')';
+                return std::unexpected(std::move(error));
+            }
+        }
+    }
+
+    return {};
+}
+
+} // namespace vibegl
@@ -0,0 +1,98 @@
+#pragma once
+
+/// @file
+/// GLSL `#include` expansion with an in-memory cache of parsed files.
+
+#include "../core/Result.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace vibegl {
+
+/// Expands `#include "path"` directives in shader sources.
+///
+/// Every file (a chunk) is parsed once into text runs and include edges and kept in
+/// memory with its modification time. Expanding a shader only stats its files and
+/// re-reads the ones that changed, and the include graph tells which shaders depend
+/// on an edited include. Paths in `#include` are relative to the including file. Each
+/// file is included at most once per expansion (as with `#pragma once`), so shared
+/// headers need no guards and include cycles terminate.
+///
+/// Files compiled into the executable (ShaderManager::embeddedFile()) are parsed from
+/// memory once and never stat'ed.
+///
+/// The output keeps the root's `#version` line first, followed by a `// source N: path`
+/// legend and `#line <line> <N>` directives, so compile errors report the source
+/// string number N and the line within that file.
+///
+/// All methods are thread-safe.
+class ShaderPreprocessor {
+public:
+    /// Cache effectiveness counters.
+    struct Stats {
+        std::uint64_t parses = 0;  ///< Files read and parsed from disk
+        std::uint64_t reuses = 0;  ///< Files served from memory because they were unchanged
+    };
+
+    /// Expand a shader file and everything it includes.
+    /// @param file Root shader file
+    /// @return Source ready for glShaderSource(), or Error naming the missing include
+    Result<std::string> process(const std::filesystem::path& file);
+
+    /// Files the given file includes, directly or indirectly, as of its last process().
+    std::vector<std::filesystem::path> dependencies(const std::filesystem::path& file);
+
+    /// Cached files that include the given file, directly or indirectly.
+    std::vector<std::filesystem::path> dependents(const std::filesystem::path& file);
+
+    /// Drop every cached chunk.
+    void clear();
+
+    /// Parse/reuse counters since construction.
+    Stats stats();
+
+private:
+    /// Text between includes, then the include that follows it (if any).
+    struct Piece {
+        std::string text;     ///< Consecutive source lines, each ending in '\n'
+        int firstLine = 1;    ///< 1-based line number of the first line of `text`
+        std::string include;  ///< Cache key of the included file, or empty
+        int includeLine = 0;  ///< Line of the #include directive
+    };
+
+    struct Chunk {
+        std::filesystem::file_time_type modified{};
+        std::string version;  ///< `#version` line if it is the file's first line
+        std::vector<Piece> pieces;
+        std::vector<std::string> includes;  ///< Direct dependency edges
+        bool embedded = false;  ///< Parsed from the copy compiled into the executable
+    };
+
+    /// Per-expansion state.
+    struct Expansion {
+        std::string body;
+        std::vector<std::string> files;  ///< Source string number -> key
+        std::unordered_set<std::string> included;
+    };
+
+    /// Return the up-to-date chunk for a key, re-reading the file if it changed.
+    Result<const Chunk*> refresh(const std::string& key);
+
+    /// Parse file contents into pieces.
+    static Chunk parse(const std::string& key, std::string_view contents);
+
+    /// Append a chunk and its includes to the expansion.
+    Result<void> expand(const std::string& key, Expansion& expansion);
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, Chunk> chunks_;  ///< Keyed by lexically normal path
+    Stats stats_;
+};
+
+} // namespace vibegl
@@ -0,0 +1,393 @@
+#include "ShaderReflection.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace vibegl
+{
+
+namespace
+{
+
+/// Which setter a uniform type accepts.
+enum class UniformKind { Float, Int, Unsupported };
+
+/// Classify a uniform type and count its components per array element.
+UniformKind classify(GLenum type, std::size_t& components)
+{
+    switch (type)
+    {
+    case GL_FLOAT:
+        components = 1;
+        return UniformKind::Float;
+    case GL_FLOAT_VEC2:
+        components = 2;
+        return UniformKind::Float;
+    case GL_FLOAT_VEC3:
+        components = 3;
+        return UniformKind::Float;
+    case GL_FLOAT_VEC4:
+    case GL_FLOAT_MAT2:
+        components = 4;
+        return UniformKind::Float;
+    case GL_FLOAT_MAT2x3:
+    case GL_FLOAT_MAT3x2:
+        components = 6;
+        return UniformKind::Float;
+    case GL_FLOAT_MAT2x4:
+    case GL_FLOAT_MAT4x2:
+        components = 8;
+        return UniformKind::Float;
+    case GL_FLOAT_MAT3:
+        components = 9;
+        return UniformKind::Float;
+    case GL_FLOAT_MAT3x4:
+    case GL_FLOAT_MAT4x3:
+        components = 12;
+        return UniformKind::Float;
+    case GL_FLOAT_MAT4:
+        components = 16;
+        return UniformKind::Float;
+    case GL_INT:
+    case GL_BOOL:
+        components = 1;
+        return UniformKind::Int;
+    case GL_INT_VEC2:
+    case GL_BOOL_VEC2:
+        components = 2;
+        return UniformKind::Int;
+    case GL_INT_VEC3:
+    case GL_BOOL_VEC3:
+        components = 3;
+        return UniformKind::Int;
+    case GL_INT_VEC4:
+    case GL_BOOL_VEC4:
+        components = 4;
+        return UniformKind::Int;
+    case GL_UNSIGNED_INT:
+    case GL_UNSIGNED_INT_VEC2:
+    case GL_UNSIGNED_INT_VEC3:
+    case GL_UNSIGNED_INT_VEC4:
+        components = 0;
+        return UniformKind::Unsupported;
+    default:
+        // Samplers and images take a texture unit
+        components = 1;
+        return UniformKind::Int;
+    }
+}
+
+void uploadFloats(const UniformInfo& info, GLsizei count, const float* data)
+{
+    switch (info.type)
+    {
+    case GL_FLOAT:
+        glUniform1fv(info.location, count, data);
+        break;
+    case GL_FLOAT_VEC2:
+        glUniform2fv(info.location, count, data);
+        break;
+    case GL_FLOAT_VEC3:
+        glUniform3fv(info.location, count, data);
+        break;
+    case GL_FLOAT_VEC4:
+        glUniform4fv(info.location, count, data);
+        break;
+    case GL_FLOAT_MAT2:
+        glUniformMatrix2fv(info.location, count, GL_FALSE, data);
+        break;
+    case GL_FLOAT_MAT3:
+        glUniformMatrix3fv(info.location, count, GL_FALSE, data);
+        break;
+    case GL_FLOAT_MAT4:
+        glUniformMatrix4fv(info.location, count, GL_FALSE, data);
+        break;
+    case GL_FLOAT_MAT2x3:
+        glUniformMatrix2x3fv(info.location, count, GL_FALSE, data);
+        break;
+    case GL_FLOAT_MAT3x2:
+        glUniformMatrix3x2fv(info.location, count, GL_FALSE, data);
+        break;
+    case GL_FLOAT_MAT2x4:
+        glUniformMatrix2x4fv(info.location, count, GL_FALSE, data);
+        break;
+    case GL_FLOAT_MAT4x2:
+        glUniformMatrix4x2fv(info.location, count, GL_FALSE, data);
+        break;
+    case GL_FLOAT_MAT3x4:
+        glUniformMatrix3x4fv(info.location, count, GL_FALSE, data);
+        break;
+    case GL_FLOAT_MAT4x3:
+        glUniformMatrix4x3fv(info.location, count, GL_FALSE, data);
+        break;
+    default:
+        break;
+    }
+}
+
+void uploadInts(const UniformInfo& info, GLsizei count, const GLint* data)
+{
+    switch (info.type)
+    {
+    case GL_INT_VEC2:
+    case GL_BOOL_VEC2:
+        glUniform2iv(info.location, count, data);
+        break;
+    case GL_INT_VEC3:
+    case GL_BOOL_VEC3:
+        glUniform3iv(info.location, count, data);
+        break;
+    case GL_INT_VEC4:
+    case GL_BOOL_VEC4:
+        glUniform4iv(info.location, count, data);
+        break;
+    default:
+        glUniform1iv(info.location, count, data);
+        break;
+    }
+}
+
+/// Sort a table by name hash and report hash collisions.
+template<typename T>
+void sortByName(std::vector<T>& table, GLuint program, const char* what)
+{
+    std::ranges::sort(table, {}, &T::name);
+    const auto duplicate = std::ranges::adjacent_find(table, {}, &T::name);
+    if (duplicate != table.end())
+    {
+        spdlog::warn("Program {}: two {} names hash to {:#018x}; lookups return one of them",
+                     program, what, duplicate->name.value);
+    }
+}
+
+template<typename T>
+const T* findByName(const std::vector<T>& table, NameHash name)
+{
+    const auto it = std::ranges::lower_bound(table, name, {}, &T::name);
+    return it != table.end() && it->name == name ? &*it : nullptr;
+}
+
+} // namespace
+
+ShaderReflection ShaderReflection::reflect(GLuint program)
+{
+    std::vector<UniformInfo> uniforms;
+    std::vector<UniformBlockInfo> blocks;
+    std::vector<AttributeInfo> attributes;
+
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<char> name(static_cast<std::size_t>(std::max(maxLength, 1)));
+    for (GLuint i = 0; i < static_cast<GLuint>(count); ++i)
+    {
+        // Members of uniform blocks are set through buffers, not glUniform*()
+        GLint blockIndex = -1;
+        glGetActiveUniformsiv(program, 1, &i, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+        if (blockIndex != -1)
+        {
+            continue;
+        }
+
+        GLsizei length = 0;
+        UniformInfo info;
+        glGetActiveUniform(program, i, static_cast<GLsizei>(name.size()), &length, &info.size,
+                           &info.type, name.data());
+        const std::string_view uniformName(name.data(), static_cast<std::size_t>(length));
+        info.name = NameHash::fromString(uniformName);
+        info.location = glGetUniformLocation(program, name.data());
+        uniforms.push_back(info);
+
+        // Arrays are reported as "name[0]"; make the plain name work as well
+        if (uniformName.ends_with("[0]"))
+        {
+            info.name = NameHash::fromString(uniformName.substr(0, uniformName.size() - 3));
+            uniforms.push_back(info);
+        }
+    }
+
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+    name.resize(static_cast<std::size_t>(std::max(maxLength, 1)));
+    for (GLuint i = 0; i < static_cast<GLuint>(count); ++i)
+    {
+        GLsizei length = 0;
+        glGetActiveUniformBlockName(program, i, static_cast<GLsizei>(name.size()), &length,
+                                    name.data());
+        UniformBlockInfo info;
+        info.name = NameHash::fromString(
+            std::string_view(name.data(), static_cast<std::size_t>(length)));
+        info.index = i;
+        glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_DATA_SIZE, &info.dataSize);
+        glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_BINDING, &info.binding);
+        blocks.push_back(info);
+    }
+
+    glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &count);
+    glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+    name.resize(static_cast<std::size_t>(std::max(maxLength, 1)));
+    for (GLuint i = 0; i < static_cast<GLuint>(count); ++i)
+    {
+        GLsizei length = 0;
+        AttributeInfo info;
+        glGetActiveAttrib(program, i, static_cast<GLsizei>(name.size()), &length, &info.size,
+                          &info.type, name.data());
+        info.name = NameHash::fromString(
+            std::string_view(name.data(), static_cast<std::size_t>(length)));
+        info.location = glGetAttribLocation(program, name.data());
+        attributes.push_back(info);
+    }
+
+    return fromTables(program, std::move(uniforms), std::move(blocks), std::move(attributes));
+}
+
+ShaderReflection ShaderReflection::fromTables(GLuint program, std::vector<UniformInfo> uniforms,
+                                              std::vector<UniformBlockInfo> blocks,
+                                              std::vector<AttributeInfo> attributes)
+{
+    ShaderReflection reflection;
+    reflection.program_ = program;
+    reflection.uniforms_ = std::move(uniforms);
+    reflection.blocks_ = std::move(blocks);
+    reflection.attributes_ = std::move(attributes);
+
+    for (auto info = reflection.uniforms_.begin(); info != reflection.uniforms_.end(); ++info)
+    {
+        info->cached = false;
+        std::size_t components = 0;
+        if (classify(info->type, components) == UniformKind::Unsupported || info->size != 1)
+        {
+            continue;
+        }
+
+        // An array's "[0]" alias shares the slot of the name GL reported
+        const GLint location = info->location;
+        const auto alias = std::find_if(reflection.uniforms_.begin(), info,
+                                        [location](const UniformInfo& other)
+                                        { return other.location == location; });
+        if (location != -1 && alias != info)
+        {
+            info->valueOffset = alias->valueOffset;
+            continue;
+        }
+        info->valueOffset = static_cast<std::uint32_t>(reflection.values_.size());
+        reflection.values_.resize(reflection.values_.size() + (components * sizeof(float)));
+    }
+
+    sortByName(reflection.uniforms_, program, "uniform");
+    sortByName(reflection.blocks_, program, "uniform block");
+    sortByName(reflection.attributes_, program, "attribute");
+    return reflection;
+}
+
+const UniformInfo* ShaderReflection::uniform(NameHash name) const
+{
+    return findByName(uniforms_, name);
+}
+
+GLint ShaderReflection::location(NameHash name) const
+{
+    const UniformInfo* info = uniform(name);
+    return info != nullptr ? info->location : -1;
+}
+
+const UniformBlockInfo* ShaderReflection::block(NameHash name) const
+{
+    return findByName(blocks_, name);
+}
+
+GLint ShaderReflection::attribute(NameHash name) const
+{
+    const AttributeInfo* info = findByName(attributes_, name);
+    return info != nullptr ? info->location : -1;
+}
+
+bool ShaderReflection::bindBlock(NameHash name, GLuint binding)
+{
+    const auto it = std::ranges::lower_bound(blocks_, name, {}, &UniformBlockInfo::name);
+    if (it == blocks_.end() || it->name != name)
+    {
+        return false;
+    }
+    // The binding is program state, so the program does not need to be current
+    glUniformBlockBinding(program_, it->index, binding);
+    it->binding = static_cast<GLint>(binding);
+    return true;
+}
+
+UniformInfo* ShaderReflection::findUniform(NameHash name)
+{
+    const auto it = std::ranges::lower_bound(uniforms_, name, {}, &UniformInfo::name);
+    return it != uniforms_.end() && it->name == name ? &*it : nullptr;
+}
+
+bool ShaderReflection::set(NameHash name, std::span<const float> values)
+{
+    UniformInfo* info = findUniform(name);
+    std::size_t components = 0;
+    if (info == nullptr || classify(info->type, components) != UniformKind::Float)
+    {
+        return false;
+    }
+    return upload(*info, values, components);
+}
+
+bool ShaderReflection::set(NameHash name, std::span<const GLint> values)
+{
+    UniformInfo* info = findUniform(name);
+    std::size_t components = 0;
+    if (info == nullptr || classify(info->type, components) != UniformKind::Int)
+    {
+        return false;
+    }
+    return upload(*info, values, components);
+}
+
+void ShaderReflection::invalidateValues()
+{
+    for (UniformInfo& info : uniforms_)
+    {
+        info.cached = false;
+    }
+}
+
+template<typename T>
+bool ShaderReflection::upload(UniformInfo& info, std::span<const T> values, std::size_t components)
+{
+    const std::size_t count =
+        std::min(values.size() / components, static_cast<std::size_t>(info.size));
+    if (count == 0)
+    {
+        return false;
+    }
+
+    if (info.size == 1)
+    {
+        std::byte* cache = values_.data() + info.valueOffset;
+        const std::size_t bytes = components * sizeof(T);
+        if (info.cached && std::memcmp(cache, values.data(), bytes) == 0)
+        {
+            return false;
+        }
+        std::memcpy(cache, values.data(), bytes);
+        info.cached = true;
+    }
+
+    if constexpr (std::is_same_v<T, float>)
+    {
+        uploadFloats(info, static_cast<GLsizei>(count), values.data());
+    }
+    else
+    {
+        uploadInts(info, static_cast<GLsizei>(count), values.data());
+    }
+    return true;
+}
+
+} // namespace vibegl
@@ -0,0 +1,126 @@
+#pragma once
+
+/// @file
+/// Uniform, uniform block and attribute tables of a linked program.
+
+#include "../core/GLIncludes.hpp"
+#include "../core/Hash.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace vibegl {
+
+/// Active default-block uniform.
+struct UniformInfo {
+    NameHash name;              ///< Hash of the name ("uLights[0]" is also found as "uLights")
+    GLint location = -1;        ///< Location for glUniform*()
+    GLenum type = 0;            ///< GL_FLOAT_MAT4, GL_SAMPLER_2D, ...
+    GLint size = 1;             ///< Array length (1 for non-arrays)
+    std::uint32_t valueOffset = 0;  ///< Byte offset of the cached value (non-arrays)
+    bool cached = false;        ///< valueOffset holds the last uploaded value
+};
+
+/// Active uniform block.
+struct UniformBlockInfo {
+    NameHash name;
+    GLuint index = 0;     ///< Block index for glUniformBlockBinding()
+    GLint dataSize = 0;   ///< Minimum buffer size in bytes
+    GLint binding = 0;    ///< Current binding point
+};
+
+/// Active vertex attribute.
+struct AttributeInfo {
+    NameHash name;
+    GLint location = -1;
+    GLenum type = 0;
+    GLint size = 1;
+};
+
+/// Reflection of a linked program with typed uniform setters.
+///
+/// Tables are flat arrays sorted by name hash, so a lookup is a short binary search
+/// over contiguous memory with no string handling; pass names as literals so their
+/// hashes are computed at compile time. The setters remember the last value uploaded
+/// for every non-array uniform and skip glUniform*() when it has not changed, which
+/// stays correct because uniform values are per-program state.
+///
+/// Setters require the program to be current (glUseProgram()), or for a separable stage
+/// bound through a program pipeline, active (glActiveShaderProgram()).
+///
+/// Example:
+/// ```cpp
+/// ShaderReflection* uniforms = ShaderManager::reflection(program);
+/// glUseProgram(program);
+/// uniforms->set("uMVP", mvp);        // std::span<const float> of 16 values
+/// uniforms->set("uTexture", 0);
+/// ```
+class ShaderReflection {
+public:
+    /// Query every active uniform, block and attribute of a linked program.
+    static ShaderReflection reflect(GLuint program);
+
+    /// Build from tables that are already known (reflect() passes what GL reported).
+    /// Assigns a value cache slot to every non-array uniform the setters accept (entries
+    /// with the same location share one) and sorts the tables, warning about colliding
+    /// name hashes. Makes no GL calls.
+    static ShaderReflection fromTables(GLuint program, std::vector<UniformInfo> uniforms,
+                                       std::vector<UniformBlockInfo> blocks = {},
+                                       std::vector<AttributeInfo> attributes = {});
+
+    /// Uniform by name, or nullptr if it is not active.
+    const UniformInfo* uniform(NameHash name) const;
+
+    /// Uniform location, or -1 if the uniform is not active.
+    GLint location(NameHash name) const;
+
+    /// Uniform block by name, or nullptr if it is not active.
+    const UniformBlockInfo* block(NameHash name) const;
+
+    /// Attribute location, or -1 if the attribute is not active.
+    GLint attribute(NameHash name) const;
+
+    /// Assign a uniform block to a buffer binding point.
+    /// @return false if the block is not active
+    bool bindBlock(NameHash name, GLuint binding);
+
+    /// Upload float data (float, vecN, matN) to a uniform. For vectors and matrices the
+    /// first components of `values` are used, so a vec4 array can feed a vec3 uniform;
+    /// arrays take as many whole elements as `values` holds.
+    /// @return true if glUniform*() was called
+    bool set(NameHash name, std::span<const float> values);
+
+    /// Upload integer data (int, ivecN, bool, samplers) to a uniform.
+    /// @return true if glUniform*() was called
+    bool set(NameHash name, std::span<const GLint> values);
+
+    /// Upload a float scalar.
+    bool set(NameHash name, float value) { return set(name, std::span<const float>(&value, 1)); }
+
+    /// Upload an int scalar or texture unit.
+    bool set(NameHash name, GLint value) { return set(name, std::span<const GLint>(&value, 1)); }
+
+    /// Forget cached values, e.g. after uniforms were set behind the setters' back.
+    void invalidateValues();
+
+    /// Tables sorted by name hash.
+    std::span<const UniformInfo> uniforms() const { return uniforms_; }
+    std::span<const UniformBlockInfo> blocks() const { return blocks_; }
+    std::span<const AttributeInfo> attributes() const { return attributes_; }
+
+private:
+    /// Upload `count` elements, skipping the call if a cached scalar value is unchanged.
+    template<typename T>
+    bool upload(UniformInfo& info, std::span<const T> values, std::size_t components);
+
+    UniformInfo* findUniform(NameHash name);
+
+    std::vector<UniformInfo> uniforms_;
+    std::vector<UniformBlockInfo> blocks_;
+    std::vector<AttributeInfo> attributes_;
+    std::vector<std::byte> values_;  ///< Last uploaded value of every non-array uniform
+    GLuint program_ = 0;
+};
+
+} // namespace vibegl
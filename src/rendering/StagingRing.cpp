@@ -0,0 +1,148 @@
+#include "StagingRing.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <limits>
+
+namespace vibegl
+{
+
+StagingRing::~StagingRing()
+{
+    destroy();
+}
+
+bool StagingRing::isSupported()
+{
+#ifdef __EMSCRIPTEN__
+    // WebGL 2 cannot map buffers
+    return false;
+#else
+    return true;
+#endif
+}
+
+bool StagingRing::create(std::size_t bytesPerFrame)
+{
+    destroy();
+#ifdef __EMSCRIPTEN__
+    static_cast<void>(bytesPerFrame);
+    return false;
+#else
+    const std::size_t total = bytesPerFrame * kFrames;
+    if (bytesPerFrame == 0 ||
+        total > static_cast<std::size_t>(std::numeric_limits<GLsizeiptr>::max()))
+    {
+        return false;
+    }
+
+    // Coherent mapping: writes become visible to the GPU without explicit flushes
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenBuffers(1, &buffer_);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer_);
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(total), nullptr, flags);
+    mapped_ = static_cast<std::byte*>(
+        glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(total), flags));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (mapped_ == nullptr)
+    {
+        spdlog::warn("Failed to map staging buffer ({} bytes), uploading from client memory",
+                     total);
+        glDeleteBuffers(1, &buffer_);
+        buffer_ = 0;
+        return false;
+    }
+    sectionSize_ = bytesPerFrame;
+    return true;
+#endif
+}
+
+void StagingRing::destroy()
+{
+    for (GLsync& fence : fences_)
+    {
+        if (fence != nullptr)
+        {
+            glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                             std::numeric_limits<GLuint64>::max());
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    if (buffer_ != 0)
+    {
+#ifndef __EMSCRIPTEN__
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer_);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+#endif
+        glDeleteBuffers(1, &buffer_);
+    }
+    buffer_ = 0;
+    mapped_ = nullptr;
+    sectionSize_ = 0;
+    section_ = kFrames - 1;
+    used_ = 0;
+    writable_ = false;
+    stats_ = {};
+}
+
+bool StagingRing::beginFrame()
+{
+    writable_ = false;
+    if (buffer_ == 0)
+    {
+        return false;
+    }
+
+    const std::size_t next = (section_ + 1) % kFrames;
+    GLsync& fence = fences_[next];
+    if (fence != nullptr)
+    {
+        // Poll only: a late GPU must not turn into a stall on this thread
+        const GLenum status = glClientWaitSync(fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        {
+            ++stats_.busyFrames;
+            return false;
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    section_ = next;
+    used_ = 0;
+    writable_ = true;
+    ++stats_.frames;
+    return true;
+}
+
+StagingRing::Region StagingRing::allocate(std::size_t bytes, std::size_t alignment)
+{
+    if (!writable_)
+    {
+        return {};
+    }
+    const std::size_t start = (used_ + alignment - 1) & ~(alignment - 1);
+    if (start > sectionSize_ || bytes > sectionSize_ - start)
+    {
+        return {};
+    }
+    used_ = start + bytes;
+    stats_.bytes += bytes;
+
+    const std::size_t offset = (section_ * sectionSize_) + start;
+    return Region{.data = mapped_ + offset, .offset = offset, .size = bytes};
+}
+
+void StagingRing::endFrame()
+{
+    if (writable_ && used_ > 0)
+    {
+        fences_[section_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    writable_ = false;
+}
+
+} // namespace vibegl
@@ -0,0 +1,120 @@
+#pragma once
+
+/// @file
+/// Persistently mapped pixel unpack buffer for streaming texture uploads.
+
+#include "../core/GLIncludes.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace vibegl {
+
+/// Ring of per-frame sections in one persistently mapped GL_PIXEL_UNPACK_BUFFER.
+///
+/// Pixels are written straight into mapped buffer memory and glTexSubImage2D() then
+/// sources them by offset from the bound buffer, so the driver neither copies client
+/// memory nor blocks the call: the transfer runs on the GPU while later commands are
+/// recorded. Each frame allocates linearly from its own section, endFrame() fences it,
+/// and the section is reused kFrames frames later once its fence has signaled. A
+/// section whose fence is still pending is not waited for; beginFrame() reports it
+/// busy and the caller falls back to client memory for that frame.
+///
+/// Needs glBufferStorage() (GL 4.4), so it is desktop only; on the web isSupported()
+/// is false and create() fails.
+///
+/// Example:
+/// ```cpp
+/// StagingRing ring;
+/// ring.create(8 * 1024 * 1024);
+///
+/// // Each frame, on the GL thread:
+/// if (ring.beginFrame()) {
+///     StagingRing::Region region = ring.allocate(bytes);
+///     std::memcpy(region.data, pixels, bytes);
+///     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, ring.buffer());
+///     glTexSubImage2D(..., region.pointer());
+///     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+///     ring.endFrame();
+/// }
+/// ```
+class StagingRing {
+public:
+    /// Sections in flight: the frame being recorded plus two the GPU may still read.
+    static constexpr std::size_t kFrames = 3;
+
+    /// Space handed out by allocate().
+    struct Region {
+        std::byte* data = nullptr;  ///< Mapped memory to write, or nullptr if out of space
+        std::size_t offset = 0;     ///< Byte offset in buffer()
+        std::size_t size = 0;
+
+        /// Check whether the allocation succeeded.
+        bool isValid() const { return data != nullptr; }
+
+        /// Offset in the form GL pixel transfer calls take while the buffer is bound.
+        const void* pointer() const { return reinterpret_cast<const void*>(offset); }
+    };
+
+    /// Usage counters since create().
+    struct Stats {
+        std::uint64_t frames = 0;      ///< beginFrame() calls that returned true
+        std::uint64_t busyFrames = 0;  ///< beginFrame() calls that found the section in use
+        std::uint64_t bytes = 0;       ///< Bytes allocated
+    };
+
+    StagingRing() = default;
+    ~StagingRing();
+
+    StagingRing(const StagingRing&) = delete;
+    StagingRing& operator=(const StagingRing&) = delete;
+    StagingRing(StagingRing&&) = delete;
+    StagingRing& operator=(StagingRing&&) = delete;
+
+    /// Check whether persistent mapping is available on this platform (false on the web).
+    static bool isSupported();
+
+    /// Allocate and map the buffer (GL thread only).
+    /// @param bytesPerFrame Size of each of the kFrames sections
+    /// @return true if the ring is ready
+    bool create(std::size_t bytesPerFrame);
+
+    /// Wait for the GPU to finish with every section, then unmap and delete the buffer.
+    void destroy();
+
+    /// Check whether create() succeeded.
+    bool isCreated() const { return buffer_ != 0; }
+
+    /// Advance to the next section (GL thread, once per frame before allocate()).
+    /// @return false if the GPU is still reading that section; allocate() then fails
+    bool beginFrame();
+
+    /// Take space from the current section.
+    /// @param bytes Size to allocate
+    /// @param alignment Power-of-two alignment of the offset
+    /// @return Region to fill, or an invalid region if the section is full or busy
+    Region allocate(std::size_t bytes, std::size_t alignment = 4);
+
+    /// Fence the current section if anything was allocated from it (GL thread).
+    void endFrame();
+
+    /// GL buffer to bind as GL_PIXEL_UNPACK_BUFFER.
+    GLuint buffer() const { return buffer_; }
+
+    /// Size of one section.
+    std::size_t bytesPerFrame() const { return sectionSize_; }
+
+    Stats stats() const { return stats_; }
+
+private:
+    GLuint buffer_ = 0;
+    std::byte* mapped_ = nullptr;
+    std::size_t sectionSize_ = 0;
+    std::size_t section_ = kFrames - 1;  ///< Section of the current frame
+    std::size_t used_ = 0;               ///< Bytes allocated from the current section
+    bool writable_ = false;              ///< The current section's fence has signaled
+    std::array<GLsync, kFrames> fences_{};
+    Stats stats_;
+};
+
+} // namespace vibegl
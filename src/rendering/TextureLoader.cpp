@@ -4,25 +4,327 @@
 
 #include <stb_image.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <initializer_list>
+#include <limits>
+#include <mutex>
+
+#include "../core/Hash.hpp"
+#include "../core/MappedFile.hpp"
+#include "../core/Platform.hpp"
+#include "../core/Profiler.hpp"
+#include "MipGenerator.hpp"
+
 namespace vibegl
 {
 
-Result<GLuint> TextureLoader::loadTexture(const std::string& filepath, bool flipVertically)
+namespace
+{
+
+std::atomic<bool>& cpuMipmaps()
+{
+    static std::atomic<bool> enabled{true};
+    return enabled;
+}
+
+struct CompressionState {
+    std::mutex mutex;
+    TextureCompression settings;
+};
+
+CompressionState& compressionState()
+{
+    static CompressionState state;
+    return state;
+}
+
+/// Bump when BlockEncoder output changes so stale cache entries are not reused.
+constexpr std::string_view kEncoderVersion = "2";
+
+/// Block format accepted in KTX2 files.
+struct Ktx2Format {
+    std::uint32_t vkFormat;  ///< VkFormat value stored in the KTX2 header
+    GLenum glFormat;
+    int blockBytes;
+};
+
+// Extension enums (S3TC) are not in every loader's core headers, so list them by value
+constexpr std::array<Ktx2Format, 14> kBlockFormats = {{
+    {131, 0x83F0, 8},   // BC1_RGB_UNORM      -> COMPRESSED_RGB_S3TC_DXT1
+    {132, 0x8C4C, 8},   // BC1_RGB_SRGB       -> COMPRESSED_SRGB_S3TC_DXT1
+    {133, 0x83F1, 8},   // BC1_RGBA_UNORM     -> COMPRESSED_RGBA_S3TC_DXT1
+    {134, 0x8C4D, 8},   // BC1_RGBA_SRGB      -> COMPRESSED_SRGB_ALPHA_S3TC_DXT1
+    {137, 0x83F3, 16},  // BC3_UNORM          -> COMPRESSED_RGBA_S3TC_DXT5
+    {138, 0x8C4F, 16},  // BC3_SRGB           -> COMPRESSED_SRGB_ALPHA_S3TC_DXT5
+    {145, 0x8E8C, 16},  // BC7_UNORM          -> COMPRESSED_RGBA_BPTC_UNORM
+    {146, 0x8E8D, 16},  // BC7_SRGB           -> COMPRESSED_SRGB_ALPHA_BPTC_UNORM
+    {147, 0x9274, 8},   // ETC2_R8G8B8_UNORM  -> COMPRESSED_RGB8_ETC2
+    {148, 0x9275, 8},   // ETC2_R8G8B8_SRGB   -> COMPRESSED_SRGB8_ETC2
+    {149, 0x9276, 8},   // ETC2_R8G8B8A1_UNORM -> COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+    {150, 0x9277, 8},   // ETC2_R8G8B8A1_SRGB -> COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2
+    {151, 0x9278, 16},  // ETC2_R8G8B8A8_UNORM -> COMPRESSED_RGBA8_ETC2_EAC
+    {152, 0x9279, 16},  // ETC2_R8G8B8A8_SRGB -> COMPRESSED_SRGB8_ALPHA8_ETC2_EAC
+}};
+
+/// File identifier: «KTX 20»\r\n\x1A\n.
+constexpr std::array<unsigned char, 12> kKtx2Identifier = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32,
+                                                           0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+/// Identifier, nine uint32 header fields, then the DFD/KVD/SGD index.
+constexpr std::size_t kKtx2HeaderSize = 80;
+
+/// byteOffset, byteLength and uncompressedByteLength (uint64 each) per level.
+constexpr std::size_t kKtx2LevelEntrySize = 24;
+
+/// Key/value entry giving the direction of each texel axis in the file.
+constexpr std::string_view kOrientationKey = "KTXorientation";
+
+static_assert(std::endian::native == std::endian::little, "KTX2 fields are read in place");
+
+template<typename T>
+T readField(std::span<const std::byte> bytes, std::size_t offset)
+{
+    T value{};
+    std::memcpy(&value, bytes.data() + offset, sizeof(T));
+    return value;
+}
+
+template<typename T>
+void writeField(std::span<std::byte> bytes, std::size_t offset, T value)
+{
+    std::memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+
+Error ktx2Error(const std::string& filepath, const char* reason)
+{
+    return Error{.message = "Failed to load texture", .context = filepath + " (" + reason + ")"};
+}
+
+/// Value of a key/value data entry without its terminating NUL, or nullopt if absent.
+/// Each entry is a uint32 byte length, `key\0value`, then padding to 4 bytes.
+std::optional<std::string_view> keyValue(std::span<const std::byte> kvd, std::string_view key)
+{
+    std::size_t offset = 0;
+    while (offset + sizeof(std::uint32_t) <= kvd.size())
+    {
+        const auto length = readField<std::uint32_t>(kvd, offset);
+        offset += sizeof(std::uint32_t);
+        if (length > kvd.size() - offset)
+        {
+            break;
+        }
+        const std::string_view entry(reinterpret_cast<const char*>(kvd.data() + offset), length);
+        const auto separator = entry.find('\0');
+        if (separator != std::string_view::npos && entry.substr(0, separator) == key)
+        {
+            std::string_view value = entry.substr(separator + 1);
+            if (!value.empty() && value.back() == '\0')
+            {
+                value.remove_suffix(1);
+            }
+            return value;
+        }
+        offset += (length + 3U) & ~std::size_t{3};
+    }
+    return std::nullopt;
+}
+
+std::uint32_t vkFormatOf(BlockFormat format)
+{
+    switch (format)
+    {
+    case BlockFormat::BC1:
+        return 131;
+    case BlockFormat::BC3:
+        return 137;
+    case BlockFormat::BC7:
+        return 145;
+    }
+    return 0;
+}
+
+GLenum glFormatOf(BlockFormat format)
+{
+    const auto entry =
+        std::ranges::find(kBlockFormats, vkFormatOf(format), &Ktx2Format::vkFormat);
+    return entry->glFormat;
+}
+
+std::string_view formatName(std::optional<BlockFormat> format)
+{
+    if (!format)
+    {
+        return "auto";
+    }
+    switch (*format)
+    {
+    case BlockFormat::BC1:
+        return "bc1";
+    case BlockFormat::BC3:
+        return "bc3";
+    case BlockFormat::BC7:
+        return "bc7";
+    }
+    return "";
+}
+
+std::string_view qualityName(BlockQuality quality)
+{
+    switch (quality)
+    {
+    case BlockQuality::Fast:
+        return "fast";
+    case BlockQuality::Normal:
+        return "normal";
+    case BlockQuality::High:
+        return "high";
+    }
+    return "";
+}
+
+bool isOpaque(const ImageData& image)
 {
-    int width = 0;
-    int height = 0;
+    const std::size_t texels =
+        static_cast<std::size_t>(image.width) * static_cast<std::size_t>(image.height);
+    for (std::size_t i = 0; i < texels; ++i)
+    {
+        if (image.pixels[(i * 4) + 3] != 255)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Minimal basic data format descriptor (KDF 1.3) for a BCn format, including its
+/// leading dfdTotalSize word.
+std::vector<std::uint32_t> dataFormatDescriptor(BlockFormat format)
+{
+    // Colour models and channel ids from the Khronos Data Format specification
+    constexpr std::uint32_t kModelBc1 = 128;
+    constexpr std::uint32_t kModelBc3 = 130;
+    constexpr std::uint32_t kModelBc7 = 134;
+    constexpr std::uint32_t kChannelColor = 0;
+    constexpr std::uint32_t kChannelBc3Alpha = 15;
+    constexpr std::uint32_t kPrimariesBt709 = 1;
+    constexpr std::uint32_t kTransferLinear = 1;
+
+    struct Sample {
+        std::uint32_t channel;
+        std::uint32_t bitOffset;
+        std::uint32_t bitLength;
+    };
+    std::uint32_t model = kModelBc1;
+    std::vector<Sample> samples;
+    switch (format)
+    {
+    case BlockFormat::BC1:
+        samples = {{.channel = kChannelColor, .bitOffset = 0, .bitLength = 64}};
+        break;
+    case BlockFormat::BC3:
+        model = kModelBc3;
+        samples = {{.channel = kChannelBc3Alpha, .bitOffset = 0, .bitLength = 64},
+                   {.channel = kChannelColor, .bitOffset = 64, .bitLength = 64}};
+        break;
+    case BlockFormat::BC7:
+        model = kModelBc7;
+        samples = {{.channel = kChannelColor, .bitOffset = 0, .bitLength = 128}};
+        break;
+    }
+
+    const auto blockSize = static_cast<std::uint32_t>(24 + (16 * samples.size()));
+    std::vector<std::uint32_t> words = {
+        4 + blockSize,                                      // dfdTotalSize
+        0,                                                  // Khronos vendor, basic type
+        2U | (blockSize << 16U),                            // Version 1.3, block size
+        model | (kPrimariesBt709 << 8U) | (kTransferLinear << 16U),
+        3U | (3U << 8U),                                    // 4x4x1x1 texel block
+        static_cast<std::uint32_t>(BlockEncoder::blockBytes(format)),  // bytesPlane0
+        0,
+    };
+    for (const Sample& sample : samples)
+    {
+        words.push_back(sample.bitOffset | ((sample.bitLength - 1) << 16U) |
+                        (sample.channel << 24U));
+        words.push_back(0);            // Sample position
+        words.push_back(0);            // sampleLower
+        words.push_back(0xFFFFFFFFU);  // sampleUpper
+    }
+    return words;
+}
+
+} // namespace
+
+void ImageData::PixelDeleter::operator()(unsigned char* pixels) const
+{
+    stbi_image_free(pixels);
+}
+
+Result<ImageData> TextureLoader::decodeImage(const std::string& filepath, bool flipVertically)
+{
+    // stb decodes straight from the mapped file instead of through its own buffered reads
+    auto file = MappedFile::open(filepath);
+    if (!file)
+    {
+        return std::unexpected(
+            Error{.message = "Failed to load texture", .context = file.error().context});
+    }
+    if (file->size() > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+    {
+        return std::unexpected(
+            Error{.message = "Failed to load texture", .context = filepath + " (file too large)"});
+    }
+
+    ImageData image;
     int channels = 0;
 
-    stbi_set_flip_vertically_on_load(flipVertically ? 1 : 0);
-    unsigned char* data = stbi_load(filepath.c_str(), &width, &height, &channels, 4);
+    // Per-thread flag so concurrent decodes do not race on stb_image's global state
+    stbi_set_flip_vertically_on_load_thread(flipVertically ? 1 : 0);
+    image.pixels.reset(stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file->bytes().data()),
+                                             static_cast<int>(file->size()), &image.width,
+                                             &image.height, &channels, 4));
 
-    if (data == nullptr)
+    if (image.pixels == nullptr)
     {
         const char* reason = stbi_failure_reason();
         return std::unexpected(
             Error{.message = "Failed to load texture",
                   .context = filepath + " (" + (reason ? reason : "unknown error") + ")"});
     }
+    return image;
+}
+
+Result<GLuint> TextureLoader::loadTexture(const std::string& filepath, bool flipVertically)
+{
+    const std::vector<GLenum> formats = compressedFormats();
+    auto compressed = findCompressed(filepath, flipVertically, formats);
+    if (!compressed && compression().enabled)
+    {
+        compressed = compressImage(filepath, flipVertically, formats);
+    }
+    if (compressed)
+    {
+        const GLuint texture = uploadCompressed(*compressed);
+        spdlog::info("Loaded texture: {} ({}x{}, {} levels, compressed)", filepath,
+                     compressed->levels[0].width, compressed->levels[0].height,
+                     compressed->levels.size());
+        return texture;
+    }
+
+    auto image = decodeImage(filepath, flipVertically);
+    if (!image)
+    {
+        return std::unexpected(image.error());
+    }
+    const int width = image->width;
+    const int height = image->height;
 
     GLuint texture = 0;
     glGenTextures(1, &texture);
@@ -33,15 +335,428 @@ Result<GLuint> TextureLoader::loadTexture(const std::string& filepath, bool flip
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    const int levels = MipGenerator::levelCount(width, height);
+    glTexStorage2D(GL_TEXTURE_2D, levels, GL_RGBA8, width, height);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
+                    image->pixels.get());
+    if (cpuMipmapsEnabled())
+    {
+        const MipChain mips = MipGenerator::generate(image->pixels.get(), width, height);
+        for (std::size_t i = 0; i < mips.levels.size(); ++i)
+        {
+            glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(i + 1), 0, 0, mips.levels[i].width,
+                            mips.levels[i].height, GL_RGBA, GL_UNSIGNED_BYTE, mips.data(i));
+        }
+    }
+    else
+    {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    spdlog::info("Loaded texture: {} ({}x{}, {} levels)", filepath, width, height, levels);
+    return texture;
+}
+
+std::span<const std::byte> CompressedImage::data(std::size_t i) const
+{
+    return file.bytes().subspan(levels[i].offset, levels[i].size);
+}
+
+Result<CompressedImage> TextureLoader::readKtx2(const std::string& filepath)
+{
+    auto file = MappedFile::open(filepath);
+    if (!file)
+    {
+        return std::unexpected(
+            Error{.message = "Failed to load texture", .context = file.error().context});
+    }
+    return parseKtx2(std::move(file.value()), filepath);
+}
+
+Result<CompressedImage> TextureLoader::parseKtx2(MappedFile file, const std::string& filepath)
+{
+    const std::span<const std::byte> bytes = file.bytes();
+    if (bytes.size() < kKtx2HeaderSize ||
+        std::memcmp(bytes.data(), kKtx2Identifier.data(), kKtx2Identifier.size()) != 0)
+    {
+        return std::unexpected(ktx2Error(filepath, "not a KTX2 file"));
+    }
+
+    const auto vkFormat = readField<std::uint32_t>(bytes, 12);
+    const auto width = readField<std::uint32_t>(bytes, 20);
+    const auto height = readField<std::uint32_t>(bytes, 24);
+    const auto depth = readField<std::uint32_t>(bytes, 28);
+    const auto layers = readField<std::uint32_t>(bytes, 32);
+    const auto faces = readField<std::uint32_t>(bytes, 36);
+    const auto levelCount = std::max(readField<std::uint32_t>(bytes, 40), std::uint32_t{1});
+    const auto supercompression = readField<std::uint32_t>(bytes, 44);
+    const auto kvdOffset = readField<std::uint32_t>(bytes, 56);
+    const auto kvdLength = readField<std::uint32_t>(bytes, 60);
+
+    const auto format = std::ranges::find(kBlockFormats, vkFormat, &Ktx2Format::vkFormat);
+    if (format == kBlockFormats.end())
+    {
+        return std::unexpected(ktx2Error(filepath, "unsupported block format"));
+    }
+    if (supercompression != 0)
+    {
+        return std::unexpected(ktx2Error(filepath, "supercompressed"));
+    }
+    constexpr auto kMaxSize = static_cast<std::uint32_t>(std::numeric_limits<int>::max());
+    if (width == 0 || height == 0 || width > kMaxSize || height > kMaxSize || depth > 1 ||
+        layers > 1 || faces != 1)
+    {
+        return std::unexpected(ktx2Error(filepath, "not a single 2D texture"));
+    }
+    const auto fullChain = MipGenerator::levelCount(static_cast<int>(width),
+                                                    static_cast<int>(height));
+    if (levelCount > static_cast<std::uint32_t>(fullChain) ||
+        bytes.size() < kKtx2HeaderSize + (levelCount * kKtx2LevelEntrySize))
+    {
+        return std::unexpected(ktx2Error(filepath, "bad level index"));
+    }
+    if (kvdOffset > bytes.size() || kvdLength > bytes.size() - kvdOffset)
+    {
+        return std::unexpected(ktx2Error(filepath, "bad key/value data"));
+    }
+
+    CompressedImage image;
+    image.format = format->glFormat;
+    image.blockBytes = format->blockBytes;
+    const auto orientation = keyValue(bytes.subspan(kvdOffset, kvdLength), kOrientationKey);
+    image.bottomUp = orientation && orientation->size() >= 2 && (*orientation)[1] == 'u';
+    for (std::uint32_t level = 0; level < levelCount; ++level)
+    {
+        const std::size_t entry = kKtx2HeaderSize + (level * kKtx2LevelEntrySize);
+        const auto offset = readField<std::uint64_t>(bytes, entry);
+        const auto length = readField<std::uint64_t>(bytes, entry + 8);
+        const auto levelWidth = std::max(1U, width >> level);
+        const auto levelHeight = std::max(1U, height >> level);
+        const std::uint64_t expected = std::uint64_t{(levelWidth + 3) / 4} *
+                                       std::uint64_t{(levelHeight + 3) / 4} *
+                                       static_cast<std::uint64_t>(format->blockBytes);
+        if (length != expected || offset > bytes.size() || length > bytes.size() - offset)
+        {
+            return std::unexpected(ktx2Error(filepath, "bad level size"));
+        }
+        image.levels.push_back(CompressedImage::Level{.width = static_cast<int>(levelWidth),
+                                                      .height = static_cast<int>(levelHeight),
+                                                      .offset = static_cast<std::size_t>(offset),
+                                                      .size = static_cast<std::size_t>(length)});
+    }
+    image.file = std::move(file);
+    return image;
+}
+
+std::vector<std::byte> TextureLoader::encodeKtx2(const unsigned char* rgba, int width,
+                                                 int height, BlockFormat format,
+                                                 BlockQuality quality, bool bottomUp,
+                                                 JobSystem* jobs)
+{
+    // Levels are encoded straight into their place in the file
+    const MipChain mips = MipGenerator::generate(rgba, width, height, jobs);
+
+    struct Level {
+        const unsigned char* pixels;
+        int width;
+        int height;
+        std::size_t offset;
+        std::size_t size;
+    };
+    std::vector<Level> levels;
+    levels.push_back(Level{.pixels = rgba,
+                           .width = width,
+                           .height = height,
+                           .offset = 0,
+                           .size = BlockEncoder::encodedSize(format, width, height)});
+    for (std::size_t i = 0; i < mips.levels.size(); ++i)
+    {
+        const MipChain::Level& mip = mips.levels[i];
+        levels.push_back(Level{.pixels = mips.data(i),
+                               .width = mip.width,
+                               .height = mip.height,
+                               .offset = 0,
+                               .size = BlockEncoder::encodedSize(format, mip.width, mip.height)});
+    }
+
+    const std::vector<std::uint32_t> dfd = dataFormatDescriptor(format);
+    const std::size_t dfdOffset = kKtx2HeaderSize + (levels.size() * kKtx2LevelEntrySize);
+    const std::size_t dfdSize = dfd.size() * sizeof(std::uint32_t);
+
+    // Rows run up (first row at the bottom) when the image was flipped for GL
+    std::string orientation(kOrientationKey);
+    orientation += '\0';
+    orientation += bottomUp ? "ru" : "rd";
+    orientation += '\0';
+    const std::size_t kvdOffset = dfdOffset + dfdSize;
+    const std::size_t kvdSize = (sizeof(std::uint32_t) + orientation.size() + 3) & ~std::size_t{3};
+
+    // The format stores the smallest level first, each aligned to the block size
+    const std::size_t alignment = BlockEncoder::blockBytes(format);
+    std::size_t size = kvdOffset + kvdSize;
+    for (auto level = levels.rbegin(); level != levels.rend(); ++level)
+    {
+        size = ((size + alignment - 1) / alignment) * alignment;
+        level->offset = size;
+        size += level->size;
+    }
+
+    std::vector<std::byte> file(size);
+    const std::span<std::byte> bytes = file;
+    std::memcpy(bytes.data(), kKtx2Identifier.data(), kKtx2Identifier.size());
+    writeField<std::uint32_t>(bytes, 12, vkFormatOf(format));
+    writeField<std::uint32_t>(bytes, 16, 1);  // typeSize
+    writeField(bytes, 20, static_cast<std::uint32_t>(width));
+    writeField(bytes, 24, static_cast<std::uint32_t>(height));
+    writeField<std::uint32_t>(bytes, 36, 1);  // faceCount
+    writeField(bytes, 40, static_cast<std::uint32_t>(levels.size()));
+    writeField(bytes, 48, static_cast<std::uint32_t>(dfdOffset));
+    writeField(bytes, 52, static_cast<std::uint32_t>(dfdSize));
+    writeField(bytes, 56, static_cast<std::uint32_t>(kvdOffset));
+    writeField(bytes, 60, static_cast<std::uint32_t>(kvdSize));
+    std::memcpy(bytes.data() + dfdOffset, dfd.data(), dfdSize);
+    writeField(bytes, kvdOffset, static_cast<std::uint32_t>(orientation.size()));
+    std::memcpy(bytes.data() + kvdOffset + sizeof(std::uint32_t), orientation.data(),
+                orientation.size());
+
+    for (std::size_t i = 0; i < levels.size(); ++i)
+    {
+        const Level& level = levels[i];
+        const std::size_t entry = kKtx2HeaderSize + (i * kKtx2LevelEntrySize);
+        writeField<std::uint64_t>(bytes, entry, level.offset);
+        writeField<std::uint64_t>(bytes, entry + 8, level.size);
+        writeField<std::uint64_t>(bytes, entry + 16, level.size);
+        BlockEncoder::encode(level.pixels, level.width, level.height, format, quality,
+                             bytes.subspan(level.offset, level.size), jobs);
+    }
+    return file;
+}
+
+std::vector<GLenum> TextureLoader::compressedFormats()
+{
+    // GL_COMPRESSED_TEXTURE_FORMATS is no guide: drivers leave out the sRGB S3TC enums and
+    // may list ETC2, which desktop GL accepts but usually decompresses. Use the extensions.
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    std::vector<std::string_view> extensions;
+    for (GLint i = 0; i < count; ++i)
+    {
+        const auto* name =
+            reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        if (name != nullptr)
+        {
+            extensions.emplace_back(name);
+        }
+    }
+    const auto has = [&extensions](std::string_view name)
+    { return std::ranges::find(extensions, name) != extensions.end(); };
+
+    const bool s3tc =
+        has("GL_EXT_texture_compression_s3tc") || has("GL_WEBGL_compressed_texture_s3tc");
+    const bool s3tcSrgb = s3tc && (has("GL_EXT_texture_sRGB") ||
+                                   has("GL_EXT_texture_compression_s3tc_srgb") ||
+                                   has("GL_WEBGL_compressed_texture_s3tc_srgb"));
+    // BPTC is core since desktop GL 4.2; ETC2 is only native on GLES/WebGL
+    const bool bptc = kIsDesktop || has("GL_EXT_texture_compression_bptc");
+    const bool etc2 = kIsWeb && has("GL_WEBGL_compressed_texture_etc");
+
+    std::vector<GLenum> formats;
+    const auto add = [&formats](bool supported, std::initializer_list<GLenum> enums)
+    {
+        if (supported)
+        {
+            formats.insert(formats.end(), enums);
+        }
+    };
+    add(s3tc, {0x83F0, 0x83F1, 0x83F3});
+    add(s3tcSrgb, {0x8C4C, 0x8C4D, 0x8C4F});
+    add(bptc, {0x8E8C, 0x8E8D});
+    add(etc2, {0x9274, 0x9275, 0x9276, 0x9277, 0x9278, 0x9279});
+    return formats;
+}
+
+std::string TextureLoader::compressedPath(const std::string& filepath)
+{
+    return std::filesystem::path(filepath).replace_extension(".ktx2").string();
+}
+
+std::optional<CompressedImage> TextureLoader::findCompressed(const std::string& filepath,
+                                                             bool flipVertically,
+                                                             std::span<const GLenum> formats)
+{
+    const std::string path = compressedPath(filepath);
+    std::error_code error;
+    if (path != filepath && !std::filesystem::exists(path, error))
+    {
+        return std::nullopt;
+    }
+
+    auto image = readKtx2(path);
+    if (!image)
+    {
+        spdlog::warn("{} - {}", image.error().message, image.error().context);
+        return std::nullopt;
+    }
+    if (std::ranges::find(formats, image->format) == formats.end())
+    {
+        spdlog::warn("Compressed format 0x{:04X} of {} is not supported by this GPU",
+                     image->format, path);
+        return std::nullopt;
+    }
+    if (image->bottomUp != flipVertically)
+    {
+        // Flipping BCn rows means re-encoding every block, so use the image instead
+        if (path != filepath)
+        {
+            spdlog::warn("{} is stored {}, but the texture is loaded {}; decoding {} instead",
+                         path, image->bottomUp ? "bottom-up" : "top-down",
+                         flipVertically ? "bottom-up" : "top-down", filepath);
+            return std::nullopt;
+        }
+        spdlog::warn("{} is stored {}, but the texture is loaded {}; it will appear flipped",
+                     path, image->bottomUp ? "bottom-up" : "top-down",
+                     flipVertically ? "bottom-up" : "top-down");
+    }
+    return std::move(image.value());
+}
+
+std::filesystem::path TextureLoader::compressionCachePath(const std::string& filepath,
+                                                         std::string_view contents,
+                                                         const TextureCompression& settings,
+                                                         bool flipVertically)
+{
+    std::uint64_t key = fnv1a64(kEncoderVersion);
+    key = fnv1a64(formatName(settings.format), key);
+    key = fnv1a64(qualityName(settings.quality), key);
+    key = fnv1a64(flipVertically ? "flip" : "noflip", key);
+    key = fnv1a64(contents, key);
+
+    constexpr std::string_view kHexDigits = "0123456789abcdef";
+    std::string hash(16, '0');
+    for (auto digit = hash.rbegin(); digit != hash.rend(); ++digit, key >>= 4U)
+    {
+        *digit = kHexDigits[key & 0xFU];
+    }
+    const std::string stem = std::filesystem::path(filepath).stem().string();
+    return std::filesystem::path(settings.cacheDirectory) / (stem + "-" + hash + ".ktx2");
+}
 
-    stbi_image_free(data);
+std::optional<CompressedImage> TextureLoader::compressImage(const std::string& filepath,
+                                                            bool flipVertically,
+                                                            std::span<const GLenum> formats,
+                                                            JobSystem* jobs)
+{
+    VIBEGL_PROFILE_FUNCTION();
+    const TextureCompression settings = compression();
+    const auto supported = [formats](BlockFormat format) {
+        return std::ranges::find(formats, glFormatOf(format)) != formats.end();
+    };
+    if (settings.format ? !supported(*settings.format)
+                        : !supported(BlockFormat::BC1) || !supported(BlockFormat::BC3))
+    {
+        spdlog::warn("Cannot compress {}: {} is not supported by this GPU", filepath,
+                     formatName(settings.format));
+        return std::nullopt;
+    }
 
-    spdlog::info("Loaded texture: {} ({}x{})", filepath, width, height);
+    // The callers decode the image next and report any read error
+    auto source = MappedFile::open(filepath);
+    if (!source)
+    {
+        return std::nullopt;
+    }
+    const std::filesystem::path path =
+        compressionCachePath(filepath, source->text(), settings, flipVertically);
+    source = MappedFile();
+
+    std::error_code error;
+    if (std::filesystem::exists(path, error))
+    {
+        auto cached = readKtx2(path.string());
+        if (cached)
+        {
+            return std::move(cached.value());
+        }
+        spdlog::warn("{} - {}; encoding again", cached.error().message, cached.error().context);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto image = decodeImage(filepath, flipVertically);
+    if (!image)
+    {
+        return std::nullopt;
+    }
+    const BlockFormat format =
+        settings.format.value_or(isOpaque(*image) ? BlockFormat::BC1 : BlockFormat::BC3);
+    std::vector<std::byte> contents = encodeKtx2(image->pixels.get(), image->width, image->height,
+                                                 format, settings.quality, flipVertically, jobs);
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    spdlog::info("Compressed texture: {} -> {} ({}, {}, {:.1f} ms)", filepath, path.string(),
+                 formatName(format), qualityName(settings.quality), elapsed.count());
+
+    // Failures only cost an encode next run
+    if (auto written = writeFileAtomically(path, contents); !written)
+    {
+        spdlog::warn("Failed to store compressed texture: {}", written.error().context);
+    }
+    auto compressed = parseKtx2(MappedFile::fromBuffer(std::move(contents)), path.string());
+    if (!compressed)
+    {
+        spdlog::warn("{} - {}", compressed.error().message, compressed.error().context);
+        return std::nullopt;
+    }
+    return std::move(compressed.value());
+}
+
+GLuint TextureLoader::uploadCompressed(const CompressedImage& image)
+{
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // A partial chain is complete too: immutable storage clamps sampling to its levels
+    glTexStorage2D(GL_TEXTURE_2D, static_cast<GLsizei>(image.levels.size()), image.format,
+                   image.levels[0].width, image.levels[0].height);
+    for (std::size_t i = 0; i < image.levels.size(); ++i)
+    {
+        const std::span<const std::byte> blocks = image.data(i);
+        glCompressedTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), 0, 0,
+                                  image.levels[i].width, image.levels[i].height, image.format,
+                                  static_cast<GLsizei>(blocks.size()), blocks.data());
+    }
     return texture;
 }
 
+void TextureLoader::setCpuMipmapsEnabled(bool enabled)
+{
+    cpuMipmaps().store(enabled);
+}
+
+bool TextureLoader::cpuMipmapsEnabled()
+{
+    return cpuMipmaps().load();
+}
+
+void TextureLoader::setCompression(TextureCompression settings)
+{
+    CompressionState& state = compressionState();
+    const std::scoped_lock lock(state.mutex);
+    state.settings = std::move(settings);
+}
+
+TextureCompression TextureLoader::compression()
+{
+    CompressionState& state = compressionState();
+    const std::scoped_lock lock(state.mutex);
+    return state.settings;
+}
+
 void TextureLoader::deleteTexture(GLuint texture)
 {
     if (texture != 0)
@@ -4,15 +4,83 @@
 /// Texture loading utilities using stb_image.
 
 #include "../core/GLIncludes.hpp"
+#include "../core/MappedFile.hpp"
 #include "../core/Result.hpp"
+#include "BlockEncoder.hpp"
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace vibegl {
 
+class JobSystem;
+
+/// RGBA8 pixels decoded on the CPU, ready for upload.
+struct ImageData {
+    /// Releases pixels allocated by stb_image.
+    struct PixelDeleter {
+        void operator()(unsigned char* pixels) const;
+    };
+
+    int width = 0;   ///< Width in pixels
+    int height = 0;  ///< Height in pixels
+    std::unique_ptr<unsigned char[], PixelDeleter> pixels;  ///< width * height * 4 bytes
+};
+
+/// Block-compressed mip chain read from a KTX2 file, uploaded without decoding.
+struct CompressedImage {
+    struct Level {
+        int width = 0;
+        int height = 0;
+        std::size_t offset = 0;  ///< Byte offset of the level's blocks in the file
+        std::size_t size = 0;    ///< Bytes of blocks
+    };
+
+    GLenum format = 0;          ///< GL compressed internal format
+    int blockBytes = 0;         ///< Bytes per 4x4 block
+    bool bottomUp = false;      ///< First row is the bottom one (KTXorientation "ru")
+    std::vector<Level> levels;  ///< Level 0 (largest) first
+    MappedFile file;            ///< Keeps the block data alive
+
+    /// Blocks of levels[i].
+    std::span<const std::byte> data(std::size_t i) const;
+};
+
+/// Runtime block compression of decoded images (TextureLoader::compressImage()).
+struct TextureCompression {
+    bool enabled = false;
+    std::optional<BlockFormat> format;  ///< Empty: BC1 for opaque images, BC3 otherwise
+    BlockQuality quality = BlockQuality::Normal;
+    std::string cacheDirectory = "texture_cache";  ///< Where encoded KTX2 files are kept
+};
+
 /// Utilities for loading textures from image files.
 ///
 /// TextureLoader uses stb_image to load various image formats (PNG, JPEG, etc.)
-/// and creates OpenGL textures with appropriate settings.
+/// and creates OpenGL textures with appropriate settings. Textures get immutable
+/// storage (glTexStorage2D()) for the full mip chain; by default the chain is filtered
+/// on the CPU by MipGenerator, which averages in linear light, instead of by
+/// glGenerateMipmap().
+///
+/// A `.ktx2` file next to the requested image (`rock.ktx2` for `rock.png`) takes
+/// precedence when it holds BC1, BC3, BC7 or ETC2 blocks, no supercompression, and the
+/// context supports the format natively (compressedFormats()): its blocks and mip levels go
+/// to glCompressedTexSubImage2D() straight from the mapped file, at 4-8x less memory
+/// than RGBA8 and with no decode. Otherwise the image itself is decoded. Compressed
+/// blocks cannot be flipped, so the file's `KTXorientation` must match the requested
+/// flip: bottom row first (`toktx --lower_left_maps_to_s0t0`) for flipVertically, top
+/// row first otherwise. A mismatched file is skipped in favour of the image.
+///
+/// With runtime compression enabled (setCompression()), images without a KTX2 counterpart
+/// are encoded to BCn by BlockEncoder once and the result is written to the cache
+/// directory as a KTX2 file named after the image and a hash of its bytes and the
+/// encoder settings. Later loads read that file like an authored one, and editing the
+/// image changes the hash, so each version of an asset is encoded exactly once.
 class TextureLoader {
 public:
     /// Load a texture from an image file.
@@ -21,6 +89,90 @@ public:
     /// @return OpenGL texture ID on success, or Error on failure
     static Result<GLuint> loadTexture(const std::string& filepath, bool flipVertically = true);
 
+    /// Decode an image file to RGBA8 without touching OpenGL (safe on any thread).
+    /// @param filepath Path to the image file
+    /// @param flipVertically Whether to flip the image vertically (default: true)
+    /// @return Decoded pixels on success, or Error on failure
+    static Result<ImageData> decodeImage(const std::string& filepath, bool flipVertically = true);
+
+    /// Read and validate a KTX2 file without touching OpenGL (safe on any thread).
+    /// @param filepath Path to the .ktx2 file
+    /// @return Level table over the mapped file, or Error if the file is missing,
+    ///         malformed, supercompressed or not in a supported block format
+    static Result<CompressedImage> readKtx2(const std::string& filepath);
+
+    /// Validate KTX2 contents and build the level table over them (safe on any thread).
+    /// @param file Contents, e.g. from MappedFile::open() or MappedFile::fromBuffer()
+    /// @param filepath Name used in error messages
+    /// @return Level table owning `file`, or Error as for readKtx2()
+    static Result<CompressedImage> parseKtx2(MappedFile file, const std::string& filepath);
+
+    /// Encode an RGBA8 image and its MipGenerator chain as a KTX2 file (safe on any thread).
+    /// @param rgba width * height * 4 bytes
+    /// @param bottomUp Whether the first row is the bottom one (written as KTXorientation)
+    /// @param jobs Optional scheduler for the mip chain and the block encoding
+    /// @return File contents, readable with parseKtx2()
+    static std::vector<std::byte> encodeKtx2(const unsigned char* rgba, int width, int height,
+                                             BlockFormat format, BlockQuality quality,
+                                             bool bottomUp, JobSystem* jobs = nullptr);
+
+    /// Compressed texture formats the current context supports natively (GL thread only).
+    /// Decided from the S3TC, S3TC sRGB, BPTC and ETC2 extensions (BPTC is core on desktop)
+    /// rather than GL_COMPRESSED_TEXTURE_FORMATS, which omits sRGB S3TC on many drivers and
+    /// can list ETC2 that desktop drivers only emulate.
+    static std::vector<GLenum> compressedFormats();
+
+    /// Path of the KTX2 counterpart of an image file (same stem, `.ktx2`).
+    static std::string compressedPath(const std::string& filepath);
+
+    /// Read the KTX2 counterpart of an image if it exists, its format is supported and
+    /// its orientation matches the flip (safe on any thread). A malformed, unsupported or
+    /// mismatched file logs a warning. A .ktx2 path is used even if its orientation does
+    /// not match, since there is nothing else to load.
+    /// @param filepath Image path, or a .ktx2 path
+    /// @param flipVertically Whether the texture is wanted bottom row first
+    /// @param formats Result of compressedFormats()
+    /// @return Compressed image, or std::nullopt to decode `filepath` instead
+    static std::optional<CompressedImage> findCompressed(const std::string& filepath,
+                                                         bool flipVertically,
+                                                         std::span<const GLenum> formats);
+
+    /// Encode an image to BCn blocks with a full mip chain, or read the result of an
+    /// earlier run from the cache directory (safe on any thread). Uses the settings of
+    /// setCompression() whether or not they are enabled.
+    /// @param filepath Image path
+    /// @param flipVertically Whether to flip the image vertically
+    /// @param formats Result of compressedFormats()
+    /// @param jobs Optional scheduler for the mip chain and the block encoding
+    /// @return Compressed image, or std::nullopt if the GPU lacks the format or the image
+    ///         cannot be read
+    static std::optional<CompressedImage> compressImage(const std::string& filepath,
+                                                        bool flipVertically,
+                                                        std::span<const GLenum> formats,
+                                                        JobSystem* jobs = nullptr);
+
+    /// Cache file compressImage() uses for an image:
+    /// `<cacheDirectory>/<stem>-<hash>.ktx2`, where the hash covers the file contents, the
+    /// format, quality and flip, and the encoder version.
+    /// @param filepath Image path
+    /// @param contents Bytes of the image file
+    static std::filesystem::path compressionCachePath(const std::string& filepath,
+                                                      std::string_view contents,
+                                                      const TextureCompression& settings,
+                                                      bool flipVertically);
+
+    /// Create an immutable texture from compressed blocks (GL thread only).
+    static GLuint uploadCompressed(const CompressedImage& image);
+
+    /// Build mip chains with MipGenerator (default) or let the driver run
+    /// glGenerateMipmap() on the GL thread, e.g. to compare the two.
+    static void setCpuMipmapsEnabled(bool enabled);
+    static bool cpuMipmapsEnabled();
+
+    /// Runtime compression settings, read by loadTexture() and TextureStreamer.
+    static void setCompression(TextureCompression settings);
+    static TextureCompression compression();
+
     /// Delete a texture.
     /// @param texture OpenGL texture ID to delete
     static void deleteTexture(GLuint texture);
@@ -0,0 +1,405 @@
+#include "TextureStreamer.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+
+#include "../core/Profiler.hpp"
+#include "MipGenerator.hpp"
+
+namespace vibegl
+{
+
+namespace
+{
+
+/// Opaque mid grey: neutral under lighting while the real image streams in.
+constexpr std::array<unsigned char, 4> kPlaceholderPixel = {128, 128, 128, 255};
+
+constexpr std::size_t kBytesPerPixel = 4;
+
+/// Create a texture with TextureLoader::loadTexture()'s sampling parameters.
+GLuint createTexture()
+{
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return texture;
+}
+
+} // namespace
+
+TextureStreamer::~TextureStreamer()
+{
+    // Jobs hold a pointer to this object
+    jobs_.wait(decodes_);
+}
+
+void TextureStreamer::setBudget(const Budget& budget)
+{
+    if (budget.bytesPerFrame != budget_.bytesPerFrame)
+    {
+        staging_.destroy();
+    }
+    budget_ = budget;
+}
+
+TextureHandle TextureStreamer::load(const std::string& filepath, bool flipVertically)
+{
+    if (placeholder_ == 0)
+    {
+        placeholder_ = createTexture();
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, 1, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+                        kPlaceholderPixel.data());
+        compressedFormats_ = TextureLoader::compressedFormats();
+    }
+
+    const auto index = static_cast<std::uint32_t>(entries_.size());
+    entries_.push_back(Entry{.path = filepath,
+                             .flipVertically = flipVertically,
+                             .texture = 0,
+                             .state = State::Decoding});
+    ++pendingCount_;
+
+    if (jobs_.threadCount() <= 1)
+    {
+        inlineDecodes_.push_back(index);
+    }
+    else
+    {
+        jobs_.submit(
+            [this, index, filepath, flipVertically] {
+                finishDecode(index, decode(filepath, flipVertically, &jobs_));
+            },
+            &decodes_);
+    }
+    return TextureHandle{index};
+}
+
+GLuint TextureStreamer::texture(TextureHandle handle) const
+{
+    if (handle.index < entries_.size() && entries_[handle.index].state == State::Ready)
+    {
+        return entries_[handle.index].texture;
+    }
+    return placeholder_;
+}
+
+TextureStreamer::State TextureStreamer::state(TextureHandle handle) const
+{
+    return handle.index < entries_.size() ? entries_[handle.index].state : State::Failed;
+}
+
+Result<TextureStreamer::Decoded> TextureStreamer::decode(const std::string& filepath,
+                                                         bool flipVertically,
+                                                         JobSystem* jobs) const
+{
+    auto compressed = TextureLoader::findCompressed(filepath, flipVertically, compressedFormats_);
+    if (!compressed && TextureLoader::compression().enabled)
+    {
+        compressed = TextureLoader::compressImage(filepath, flipVertically, compressedFormats_,
+                                                  jobs);
+    }
+    if (compressed)
+    {
+        return Decoded{.image = {}, .mips = {}, .compressed = std::move(compressed)};
+    }
+
+    auto image = TextureLoader::decodeImage(filepath, flipVertically);
+    if (!image)
+    {
+        return std::unexpected(image.error());
+    }
+    Decoded decoded{.image = std::move(image.value()), .mips = {}, .compressed = std::nullopt};
+    if (TextureLoader::cpuMipmapsEnabled())
+    {
+        decoded.mips = MipGenerator::generate(decoded.image.pixels.get(), decoded.image.width,
+                                              decoded.image.height, jobs);
+    }
+    return decoded;
+}
+
+void TextureStreamer::finishDecode(std::uint32_t index, Result<Decoded> image)
+{
+    {
+        const std::scoped_lock lock(decodedMutex_);
+        decoded_.emplace_back(index, std::move(image));
+    }
+    if (onDecoded_)
+    {
+        onDecoded_();
+    }
+}
+
+void TextureStreamer::collectDecoded()
+{
+    std::vector<std::pair<std::uint32_t, Result<Decoded>>> decoded;
+    {
+        const std::scoped_lock lock(decodedMutex_);
+        decoded.swap(decoded_);
+    }
+
+    for (auto& [index, image] : decoded)
+    {
+        Entry& entry = entries_[index];
+        if (!image)
+        {
+            spdlog::error("{} - {}", image.error().message, image.error().context);
+            entry.state = State::Failed;
+            --pendingCount_;
+            continue;
+        }
+        entry.state = State::Uploading;
+        uploads_.push_back(Upload{.index = index,
+                                  .source = std::move(image.value()),
+                                  .levels = {},
+                                  .compressedFormat = 0,
+                                  .storageLevels = 1,
+                                  .texture = 0,
+                                  .level = 0,
+                                  .nextRow = 0});
+        prepareLevels(uploads_.back());
+    }
+}
+
+void TextureStreamer::prepareLevels(Upload& upload)
+{
+    if (upload.source.compressed)
+    {
+        const CompressedImage& image = *upload.source.compressed;
+        for (std::size_t i = 0; i < image.levels.size(); ++i)
+        {
+            const CompressedImage::Level& level = image.levels[i];
+            const auto blocksWide = static_cast<std::size_t>((level.width + 3) / 4);
+            upload.levels.push_back(UploadLevel{
+                .width = level.width,
+                .height = level.height,
+                .data = reinterpret_cast<const unsigned char*>(image.data(i).data()),
+                .rowBytes = blocksWide * static_cast<std::size_t>(image.blockBytes),
+                .rowHeight = 4});
+        }
+        upload.compressedFormat = image.format;
+        upload.storageLevels = static_cast<GLsizei>(image.levels.size());
+        return;
+    }
+
+    const ImageData& image = upload.source.image;
+    upload.levels.push_back(
+        UploadLevel{.width = image.width,
+                    .height = image.height,
+                    .data = image.pixels.get(),
+                    .rowBytes = static_cast<std::size_t>(image.width) * kBytesPerPixel,
+                    .rowHeight = 1});
+    const MipChain& mips = upload.source.mips;
+    for (std::size_t i = 0; i < mips.levels.size(); ++i)
+    {
+        upload.levels.push_back(UploadLevel{
+            .width = mips.levels[i].width,
+            .height = mips.levels[i].height,
+            .data = mips.data(i),
+            .rowBytes = static_cast<std::size_t>(mips.levels[i].width) * kBytesPerPixel,
+            .rowHeight = 1});
+    }
+    // Without a CPU chain the driver fills the remaining levels
+    upload.storageLevels = MipGenerator::levelCount(image.width, image.height);
+}
+
+void TextureStreamer::update()
+{
+    VIBEGL_PROFILE_SCOPE("TextureStreamer::update");
+    const auto start = std::chrono::steady_clock::now();
+    const auto elapsedMilliseconds = [start] {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+            .count();
+    };
+    bytesLastUpdate_ = 0;
+    stagedBytesLastUpdate_ = 0;
+
+    if (!inlineDecodes_.empty())
+    {
+        const std::uint32_t index = inlineDecodes_.front();
+        inlineDecodes_.pop_front();
+        const Entry& entry = entries_[index];
+        finishDecode(index, decode(entry.path, entry.flipVertically, nullptr));
+    }
+    collectDecoded();
+    if (uploads_.empty())
+    {
+        return;
+    }
+
+    if (StagingRing::isSupported() && !staging_.isCreated())
+    {
+        staging_.create(budget_.bytesPerFrame);
+    }
+    const bool staged = staging_.beginFrame();
+
+    GLint previousTexture = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+
+    while (!uploads_.empty())
+    {
+        Upload& upload = uploads_.front();
+        const UploadLevel& level = upload.levels[upload.level];
+        const int dataRows = (level.height + level.rowHeight - 1) / level.rowHeight;
+
+        // Always make progress: the first band of a frame may exceed the budget
+        const std::size_t remaining =
+            budget_.bytesPerFrame > bytesLastUpdate_ ? budget_.bytesPerFrame - bytesLastUpdate_ : 0;
+        std::size_t rows = remaining / level.rowBytes;
+        if (rows == 0 && bytesLastUpdate_ > 0)
+        {
+            break;
+        }
+        rows =
+            std::clamp<std::size_t>(rows, 1, static_cast<std::size_t>(dataRows - upload.nextRow));
+
+        if (upload.texture == 0)
+        {
+            // Immutable storage for the whole chain, allocated once
+            upload.texture = createTexture();
+            glTexStorage2D(GL_TEXTURE_2D, upload.storageLevels,
+                           upload.compressedFormat != 0 ? upload.compressedFormat : GL_RGBA8,
+                           level.width, level.height);
+        }
+        else
+        {
+            glBindTexture(GL_TEXTURE_2D, upload.texture);
+        }
+
+        const auto mip = static_cast<GLint>(upload.level);
+        const int y = upload.nextRow * level.rowHeight;
+        const int bandHeight = std::min(static_cast<int>(rows) * level.rowHeight, level.height - y);
+        const std::size_t bandBytes = rows * level.rowBytes;
+        const unsigned char* band =
+            level.data + (static_cast<std::size_t>(upload.nextRow) * level.rowBytes);
+        const auto uploadBand = [&](const void* pixels) {
+            if (upload.compressedFormat != 0)
+            {
+                glCompressedTexSubImage2D(GL_TEXTURE_2D, mip, 0, y, level.width, bandHeight,
+                                          upload.compressedFormat,
+                                          static_cast<GLsizei>(bandBytes), pixels);
+            }
+            else
+            {
+                glTexSubImage2D(GL_TEXTURE_2D, mip, 0, y, level.width, bandHeight, GL_RGBA,
+                                GL_UNSIGNED_BYTE, pixels);
+            }
+        };
+
+        const StagingRing::Region region = staging_.allocate(bandBytes);
+        if (region.isValid())
+        {
+            // The driver sources the band from the buffer and returns without copying
+            std::memcpy(region.data, band, bandBytes);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging_.buffer());
+            uploadBand(region.pointer());
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            stagedBytesLastUpdate_ += bandBytes;
+        }
+        else
+        {
+            // No staging this frame, or a single row wider than the ring section
+            uploadBand(band);
+        }
+        upload.nextRow += static_cast<int>(rows);
+        bytesLastUpdate_ += bandBytes;
+
+        if (upload.nextRow == dataRows)
+        {
+            upload.nextRow = 0;
+            ++upload.level;
+        }
+        if (upload.level == upload.levels.size())
+        {
+            // Without a CPU chain (TextureLoader::cpuMipmapsEnabled()) the driver builds it
+            if (upload.storageLevels > static_cast<GLsizei>(upload.levels.size()))
+            {
+                glGenerateMipmap(GL_TEXTURE_2D);
+            }
+            Entry& entry = entries_[upload.index];
+            entry.texture = upload.texture;
+            entry.state = State::Ready;
+            --pendingCount_;
+            spdlog::info("Streamed texture: {} ({}x{}, {} levels{})", entry.path,
+                         upload.levels[0].width, upload.levels[0].height, upload.storageLevels,
+                         upload.compressedFormat != 0 ? ", compressed" : "");
+            uploads_.pop_front();
+        }
+
+        if (bytesLastUpdate_ >= budget_.bytesPerFrame ||
+            elapsedMilliseconds() >= budget_.millisecondsPerFrame)
+        {
+            break;
+        }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(previousTexture));
+    if (staged)
+    {
+        staging_.endFrame();
+    }
+}
+
+TextureStreamer::Stats TextureStreamer::stats() const
+{
+    Stats stats;
+    stats.bytesLastUpdate = bytesLastUpdate_;
+    stats.stagedBytesLastUpdate = stagedBytesLastUpdate_;
+    for (const Entry& entry : entries_)
+    {
+        switch (entry.state)
+        {
+        case State::Decoding:
+            ++stats.decoding;
+            break;
+        case State::Uploading:
+            ++stats.uploading;
+            break;
+        case State::Ready:
+            ++stats.ready;
+            break;
+        case State::Failed:
+            ++stats.failed;
+            break;
+        }
+    }
+    return stats;
+}
+
+void TextureStreamer::clear()
+{
+    jobs_.wait(decodes_);
+    {
+        const std::scoped_lock lock(decodedMutex_);
+        decoded_.clear();
+    }
+    for (const Upload& upload : uploads_)
+    {
+        TextureLoader::deleteTexture(upload.texture);
+    }
+    for (const Entry& entry : entries_)
+    {
+        TextureLoader::deleteTexture(entry.texture);
+    }
+    TextureLoader::deleteTexture(placeholder_);
+    staging_.destroy();
+    uploads_.clear();
+    inlineDecodes_.clear();
+    entries_.clear();
+    pendingCount_ = 0;
+    bytesLastUpdate_ = 0;
+    stagedBytesLastUpdate_ = 0;
+    placeholder_ = 0;
+}
+
+} // namespace vibegl
@@ -0,0 +1,202 @@
+#pragma once
+
+/// @file
+/// Asynchronous texture loading: decode on job workers, upload under a per-frame budget.
+
+#include "../core/GLIncludes.hpp"
+#include "../core/JobSystem.hpp"
+#include "../core/Result.hpp"
+#include "MipGenerator.hpp"
+#include "StagingRing.hpp"
+#include "TextureLoader.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vibegl {
+
+/// Stable reference to a texture owned by a TextureStreamer.
+struct TextureHandle {
+    static constexpr std::uint32_t kInvalid = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t index = kInvalid;
+
+    /// Check whether the handle refers to a requested texture.
+    bool isValid() const { return index != kInvalid; }
+};
+
+/// Streams textures in without stalling frames.
+///
+/// load() returns immediately: the file is decoded on a JobSystem worker while
+/// texture() serves a shared 1x1 placeholder. update(), called once per frame on the
+/// thread owning the GL context, uploads decoded images in row bands until the frame's
+/// byte or time budget is spent, so a large texture spreads over several frames. Each
+/// texture is filled in a GL object of its own and only replaces the placeholder once
+/// complete (with mipmaps), so a half-uploaded image is never sampled.
+///
+/// Textures use immutable storage (glTexStorage2D()) for the full chain. The mip levels
+/// are built by MipGenerator on the decoding worker and streamed like the base level,
+/// so the GL thread never runs glGenerateMipmap() unless
+/// TextureLoader::cpuMipmapsEnabled() is off. A supported KTX2 counterpart of the file
+/// (TextureLoader::findCompressed()) is streamed instead, in bands of block rows, with
+/// nothing to decode or filter. With runtime compression enabled, images without one are
+/// encoded (or read from the compression cache) on the worker.
+///
+/// On desktop the bands are copied into a persistently mapped StagingRing sized to the
+/// byte budget and uploaded from there, so glTexSubImage2D() returns without copying
+/// and the transfer overlaps rendering. When the ring's section is still in use by the
+/// GPU, or on the web, bands are uploaded from client memory.
+///
+/// Without job worker threads (the web build) update() decodes one image per frame
+/// itself instead.
+///
+/// Example:
+/// ```cpp
+/// TextureStreamer textures(getJobSystem());
+/// TextureHandle albedo = textures.load(resolvePath("data/textures/rock.png"));
+///
+/// // Each frame, on the GL thread:
+/// textures.update();
+/// glBindTexture(GL_TEXTURE_2D, textures.texture(albedo));  // placeholder until ready
+/// ```
+class TextureStreamer {
+public:
+    /// Limits on the GL upload work done by one update().
+    struct Budget {
+        std::size_t bytesPerFrame = 8 * 1024 * 1024;  ///< Pixel bytes passed to the driver
+        double millisecondsPerFrame = 2.0;            ///< Time spent uploading
+    };
+
+    /// Progress of one texture.
+    enum class State {
+        Decoding,   ///< Waiting for or running on a worker
+        Uploading,  ///< Decoded; being uploaded by update()
+        Ready,      ///< texture() returns the real texture
+        Failed      ///< Could not be read or decoded; the placeholder stays
+    };
+
+    /// Textures per state, plus the last update()'s upload volume.
+    struct Stats {
+        std::size_t decoding = 0;
+        std::size_t uploading = 0;
+        std::size_t ready = 0;
+        std::size_t failed = 0;
+        std::size_t bytesLastUpdate = 0;
+        std::size_t stagedBytesLastUpdate = 0;  ///< Part of it sourced from the staging ring
+    };
+
+    explicit TextureStreamer(JobSystem& jobs) : jobs_(jobs) {}
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+    TextureStreamer(TextureStreamer&&) = delete;
+    TextureStreamer& operator=(TextureStreamer&&) = delete;
+
+    /// Set the per-frame upload budget. At least one row band is uploaded per update().
+    /// The staging ring is reallocated to match on the next update().
+    void setBudget(const Budget& budget);
+
+    /// Called on a worker thread whenever a decode finishes, e.g. to request a redraw
+    /// so update() runs in on-demand mode. Must be thread-safe.
+    void setOnDecoded(std::function<void()> onDecoded) { onDecoded_ = std::move(onDecoded); }
+
+    /// Start loading an image file (GL thread only).
+    /// @param filepath Path to the image file
+    /// @param flipVertically Whether to flip the image vertically (default: true)
+    /// @return Handle whose texture() is the placeholder until the image is uploaded
+    TextureHandle load(const std::string& filepath, bool flipVertically = true);
+
+    /// Texture to bind for a handle: the image once Ready, otherwise the placeholder.
+    GLuint texture(TextureHandle handle) const;
+
+    /// Progress of a handle (Failed for invalid handles).
+    State state(TextureHandle handle) const;
+
+    /// Collect finished decodes and upload within the budget (GL thread, once per frame).
+    void update();
+
+    /// Check whether every requested texture is Ready or Failed.
+    bool isIdle() const { return pendingCount_ == 0; }
+
+    /// Texture counts per state.
+    Stats stats() const;
+
+    /// Wait for running decodes and delete every texture (GL thread only).
+    /// Handles become invalid.
+    void clear();
+
+private:
+    struct Entry {
+        std::string path;
+        bool flipVertically = true;
+        GLuint texture = 0;  ///< Real texture once Ready
+        State state = State::Decoding;
+    };
+
+    /// Output of a decode job: RGBA8 pixels with their mip chain, or compressed blocks.
+    struct Decoded {
+        ImageData image;
+        MipChain mips;  ///< Empty when the driver generates mipmaps
+        std::optional<CompressedImage> compressed;
+    };
+
+    /// Source rows of one mip level.
+    struct UploadLevel {
+        int width = 0;
+        int height = 0;
+        const unsigned char* data = nullptr;
+        std::size_t rowBytes = 0;  ///< Bytes per texel row, or per row of 4x4 blocks
+        int rowHeight = 1;         ///< Texel rows per data row
+    };
+
+    /// A decoded image being uploaded band by band, level by level.
+    struct Upload {
+        std::uint32_t index = 0;
+        Decoded source;
+        std::vector<UploadLevel> levels;  ///< Views into `source`
+        GLenum compressedFormat = 0;      ///< 0 for RGBA8
+        GLsizei storageLevels = 1;
+        GLuint texture = 0;     ///< Storage allocated on the first band
+        std::size_t level = 0;  ///< Index into `levels` being uploaded
+        int nextRow = 0;        ///< Next data row of that level
+    };
+
+    /// Decode an image and build its mip chain, or read or produce its compressed
+    /// counterpart (any thread).
+    Result<Decoded> decode(const std::string& filepath, bool flipVertically,
+                           JobSystem* jobs) const;
+
+    /// Fill an upload's level views and storage format from its source.
+    static void prepareLevels(Upload& upload);
+
+    /// Hand a decode result to the GL thread.
+    void finishDecode(std::uint32_t index, Result<Decoded> image);
+
+    /// Move finished decodes into the upload queue.
+    void collectDecoded();
+
+    JobSystem& jobs_;
+    Budget budget_;
+    std::function<void()> onDecoded_;
+    std::vector<Entry> entries_;
+    std::deque<Upload> uploads_;
+    std::deque<std::uint32_t> inlineDecodes_;  ///< Decoded by update() without workers
+    std::size_t pendingCount_ = 0;             ///< Entries still Decoding or Uploading
+    std::size_t bytesLastUpdate_ = 0;
+    std::size_t stagedBytesLastUpdate_ = 0;
+    StagingRing staging_;
+    GLuint placeholder_ = 0;
+    std::vector<GLenum> compressedFormats_;  ///< Queried on the first load(), read by jobs
+    JobCounter decodes_;
+    std::mutex decodedMutex_;  ///< Guards decoded_
+    std::vector<std::pair<std::uint32_t, Result<Decoded>>> decoded_;
+};
+
+} // namespace vibegl
@@ -0,0 +1,20 @@
+#include "VertexLayout.hpp"
+
+#include <cstdint>
+
+namespace vibegl
+{
+
+void VertexLayout::apply() const
+{
+    for (const VertexAttribute& attribute : attributes)
+    {
+        glVertexAttribPointer(attribute.location, attribute.components, attribute.type,
+                              attribute.normalized, stride,
+                              // NOLINTNEXTLINE(performance-no-int-to-ptr)
+                              reinterpret_cast<const void*>(std::uintptr_t{attribute.offset}));
+        glEnableVertexAttribArray(attribute.location);
+    }
+}
+
+} // namespace vibegl
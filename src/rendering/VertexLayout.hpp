@@ -0,0 +1,40 @@
+#pragma once
+
+/// @file
+/// Description of interleaved vertex attributes.
+
+#include "../core/GLIncludes.hpp"
+#include <vector>
+
+namespace vibegl {
+
+/// One attribute in an interleaved vertex buffer.
+struct VertexAttribute {
+    GLuint location = 0;              ///< Shader attribute location
+    GLint components = 4;             ///< 1-4
+    GLenum type = GL_FLOAT;           ///< Component type
+    GLboolean normalized = GL_FALSE;  ///< Map integer types to [0, 1] / [-1, 1]
+    GLuint offset = 0;                ///< Byte offset within a vertex
+};
+
+/// Interleaved vertex format, shared by geometry setup and pipeline warm-up so both
+/// present the driver with the same layout.
+///
+/// Example:
+/// ```cpp
+/// const VertexLayout layout{.stride = 5 * sizeof(float),
+///                           .attributes = {{.location = 0, .components = 3},
+///                                          {.location = 1, .components = 2, .offset = 12}}};
+/// glBindVertexArray(vao);
+/// glBindBuffer(GL_ARRAY_BUFFER, vbo);
+/// layout.apply();
+/// ```
+struct VertexLayout {
+    GLsizei stride = 0;  ///< Bytes per vertex
+    std::vector<VertexAttribute> attributes;
+
+    /// Point and enable every attribute of the bound VAO at the bound GL_ARRAY_BUFFER.
+    void apply() const;
+};
+
+} // namespace vibegl
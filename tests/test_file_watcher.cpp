@@ -0,0 +1,187 @@
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+#include "core/FileWatcher.hpp"
+
+using vibegl::FileWatcher;
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+// Mirrors the platforms FileWatcher uses inotify on
+#ifdef __linux__
+constexpr bool kHasInotify = true;
+#else
+constexpr bool kHasInotify = false;
+#endif
+
+/// Scratch directory, removed again by the destructor.
+class ScratchDirectory {
+public:
+    explicit ScratchDirectory(std::string_view name)
+        : root_(std::filesystem::temp_directory_path() / "vibegl_tests" / name)
+    {
+        std::error_code error;
+        std::filesystem::remove_all(root_, error);
+        std::filesystem::create_directories(root_);
+    }
+
+    ~ScratchDirectory()
+    {
+        std::error_code error;
+        std::filesystem::remove_all(root_, error);
+    }
+
+    ScratchDirectory(const ScratchDirectory&) = delete;
+    ScratchDirectory& operator=(const ScratchDirectory&) = delete;
+
+    const std::filesystem::path& root() const { return root_; }
+
+private:
+    std::filesystem::path root_;
+};
+
+/// Callback target that records every reported path and when it arrived.
+class ChangeLog {
+public:
+    FileWatcher::Callback callback()
+    {
+        return [this](const std::filesystem::path& path)
+        {
+            {
+                const std::scoped_lock lock(mutex_);
+                paths_.push_back(path);
+                times_.push_back(Clock::now());
+            }
+            changed_.notify_all();
+        };
+    }
+
+    /// Wait up to `timeout` for at least `count` callbacks.
+    bool waitFor(std::size_t count, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock lock(mutex_);
+        return changed_.wait_for(lock, timeout, [&] { return paths_.size() >= count; });
+    }
+
+    std::vector<std::filesystem::path> paths()
+    {
+        const std::scoped_lock lock(mutex_);
+        return paths_;
+    }
+
+    Clock::time_point lastTime()
+    {
+        const std::scoped_lock lock(mutex_);
+        return times_.back();
+    }
+
+    void clear()
+    {
+        const std::scoped_lock lock(mutex_);
+        paths_.clear();
+        times_.clear();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::vector<std::filesystem::path> paths_;
+    std::vector<Clock::time_point> times_;
+};
+
+/// Save the way most tools do: truncate, then write in several chunks.
+void writeInPlace(const std::filesystem::path& path, std::string_view text)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    for (const char c : text)
+    {
+        file << c;
+        file.flush();
+    }
+}
+
+/// Save the way editors with atomic saves do: write a temporary, rename it over.
+void replaceByRename(const std::filesystem::path& path, std::string_view text)
+{
+    std::filesystem::path temporary = path;
+    temporary += ".tmp";
+    writeInPlace(temporary, text);
+    std::filesystem::rename(temporary, path);
+}
+
+/// Check that each kind of save of `watched` is reported once and `other` never is.
+void checkSaves(FileWatcher::Backend backend, std::string_view name)
+{
+    // Polling compares modification times, which only change at the file system's
+    // timestamp granularity; waiting a poll interval also proves nothing else arrives
+    const bool polling = backend == FileWatcher::Backend::Polling || !kHasInotify;
+    const std::chrono::milliseconds quiet =
+        polling ? FileWatcher::kPollInterval * 2 : FileWatcher::kSettleTime * 4;
+    const std::chrono::milliseconds timeout = FileWatcher::kPollInterval * 4;
+
+    ScratchDirectory dir(name);
+    const std::filesystem::path watched = dir.root() / "watched.glsl";
+    const std::filesystem::path other = dir.root() / "other.glsl";
+    writeInPlace(watched, "v1");
+    writeInPlace(other, "v1");
+
+    ChangeLog log;
+    FileWatcher watcher;
+    watcher.watch(watched);
+    REQUIRE(watcher.start(log.callback(), backend));
+    std::this_thread::sleep_for(quiet);
+
+    // In-place write: one callback, kSettleTime after the last event of the burst
+    const Clock::time_point saved = Clock::now();
+    writeInPlace(watched, "version 2");
+    REQUIRE(log.waitFor(1, timeout));
+    if (!polling)
+    {
+        CHECK(log.lastTime() - saved >= FileWatcher::kSettleTime);
+    }
+    std::this_thread::sleep_for(quiet);
+    CHECK(log.paths() == std::vector<std::filesystem::path>{watched});
+
+    // Atomic save: the temporary is not watched, the rename over the file is
+    log.clear();
+    replaceByRename(watched, "version 3");
+    REQUIRE(log.waitFor(1, timeout));
+    std::this_thread::sleep_for(quiet);
+    CHECK(log.paths() == std::vector<std::filesystem::path>{watched});
+
+    // Files that were never watched are ignored, even next to watched ones
+    log.clear();
+    writeInPlace(other, "version 2");
+    replaceByRename(other, "version 3");
+    std::this_thread::sleep_for(quiet);
+    CHECK(log.paths().empty());
+
+    watcher.stop();
+    CHECK_FALSE(watcher.isRunning());
+}
+
+} // namespace
+
+TEST_CASE("FileWatcher reports each save once with native notifications")
+{
+    checkSaves(FileWatcher::Backend::Native, "file_watcher_native");
+}
+
+TEST_CASE("FileWatcher reports each save once when polling")
+{
+    checkSaves(FileWatcher::Backend::Polling, "file_watcher_polling");
+}
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+#include "core/FrameArena.hpp"
+#include "core/JobSystem.hpp"
+
+using vibegl::FrameArena;
+using vibegl::JobSystem;
+
+namespace
+{
+
+bool aligned(const void* pointer, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;  // NOLINT
+}
+
+} // namespace
+
+TEST_CASE("FrameArena bump-allocates and resets")
+{
+    JobSystem jobs;
+    jobs.start(0);
+    FrameArena arena(jobs, 1024);
+    CHECK(arena.stats().subArenas == 2);
+    CHECK(arena.stats().capacityPerThread == 1024);
+
+    SUBCASE("Allocations are aligned, contiguous and reused after reset")
+    {
+        auto* first = static_cast<std::byte*>(arena.allocate(3, 1));
+        auto* second = static_cast<std::byte*>(arena.allocate(8, 8));
+        auto* third = static_cast<std::byte*>(arena.allocate(1, 64));
+        CHECK(second - first == 8);
+        CHECK(aligned(second, 8));
+        CHECK(aligned(third, 64));
+
+        arena.reset();
+        CHECK(arena.stats().lastFrameBytes == 65);
+        CHECK(arena.stats().lastFrameOverflowBytes == 0);
+        CHECK(arena.allocate(3, 1) == first);
+    }
+
+    SUBCASE("Typed arrays")
+    {
+        double* values = arena.allocateArray<double>(16);
+        CHECK(aligned(values, alignof(double)));
+        std::fill_n(values, 16, 1.5);
+        CHECK(values[15] == 1.5);
+    }
+
+    SUBCASE("Backs std::pmr containers")
+    {
+        std::pmr::vector<int> values(arena.resource());
+        for (int i = 0; i < 100; ++i)
+        {
+            values.push_back(i);
+        }
+        CHECK(values.size() == 100);
+        CHECK(values[99] == 99);
+        CHECK(arena.resource()->is_equal(*arena.resource()));
+        CHECK_FALSE(arena.resource()->is_equal(*std::pmr::new_delete_resource()));
+    }
+
+    jobs.stop();
+}
+
+TEST_CASE("FrameArena spills allocations that do not fit to the heap")
+{
+    JobSystem jobs;
+    jobs.start(0);
+    FrameArena arena(jobs, 1024);
+
+    void* inside = arena.allocate(1000);
+    void* spilled = arena.allocate(100, 32);
+    CHECK(aligned(spilled, 32));
+    std::memset(spilled, 0xAB, 100);
+    CHECK(arena.allocate(32) != inside);
+
+    arena.reset();
+    CHECK(arena.stats().lastFrameOverflowBytes == 132);
+    CHECK(arena.stats().lastFrameBytes == 1132);
+    CHECK(arena.stats().highWaterBytes == 1132);
+    CHECK(arena.stats().overflowAllocations == 2);
+
+    // The high-water mark and overflow count survive a quieter frame
+    arena.allocate(8);
+    arena.reset();
+    CHECK(arena.stats().lastFrameBytes == 8);
+    CHECK(arena.stats().highWaterBytes == 1132);
+    CHECK(arena.stats().overflowAllocations == 2);
+
+    jobs.stop();
+}
+
+TEST_CASE("FrameArena gives each worker its own sub-arena")
+{
+    JobSystem jobs;
+    jobs.start(-1);
+    constexpr std::size_t kBlock = 64;
+    constexpr std::size_t kBlocks = 256;
+    FrameArena arena(jobs, kBlock * kBlocks);
+    CHECK(arena.stats().subArenas == jobs.threadCount() + 1);
+
+    // Every block gets a distinct address and keeps its own contents
+    std::vector<std::byte*> blocks(kBlocks);
+    jobs.parallelFor(kBlocks, 4,
+                     [&](std::size_t begin, std::size_t end)
+                     {
+                         for (std::size_t i = begin; i < end; ++i)
+                         {
+                             blocks[i] = static_cast<std::byte*>(arena.allocate(kBlock));
+                             std::memset(blocks[i], static_cast<int>(i), kBlock);
+                         }
+                     });
+
+    // Threads that are not workers share the last sub-arena
+    std::vector<std::byte*> outside(2);
+    std::thread thread(
+        [&]
+        {
+            for (std::byte*& block : outside)
+            {
+                block = static_cast<std::byte*>(arena.allocate(kBlock));
+            }
+        });
+    thread.join();
+    CHECK(outside[1] - outside[0] == static_cast<std::ptrdiff_t>(kBlock));
+
+    std::size_t intact = 0;
+    for (std::size_t i = 0; i < kBlocks; ++i)
+    {
+        const auto expected = static_cast<std::byte>(i);
+        if (std::all_of(blocks[i], blocks[i] + kBlock,
+                        [expected](std::byte value) { return value == expected; }))
+        {
+            ++intact;
+        }
+    }
+    CHECK(intact == kBlocks);
+    std::ranges::sort(blocks);
+    CHECK(std::ranges::adjacent_find(blocks) == blocks.end());
+
+    arena.reset();
+    CHECK(arena.stats().lastFrameBytes == (kBlocks + outside.size()) * kBlock);
+    CHECK(arena.stats().overflowAllocations == 0);
+    jobs.stop();
+}
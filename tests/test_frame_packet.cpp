@@ -0,0 +1,285 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <doctest/doctest.h>
+#include <imgui.h>
+
+#include "core/FramePacket.hpp"
+
+using vibegl::FramePacket;
+using vibegl::FramePacketQueue;
+using vibegl::UiDrawSnapshot;
+
+namespace
+{
+
+/// Long enough for a thread that is not blocked to get past its wait.
+constexpr auto kBlockedTime = std::chrono::milliseconds(50);
+
+/// ImGui context with a built font atlas, so frames render without a backend.
+class ImGuiContextScope {
+public:
+    ImGuiContextScope() : context_(ImGui::CreateContext())
+    {
+        ImGuiIO& io = ImGui::GetIO();
+        io.IniFilename = nullptr;
+        io.DisplaySize = ImVec2(320.0f, 240.0f);
+        io.Fonts->Build();
+    }
+
+    ~ImGuiContextScope() { ImGui::DestroyContext(context_); }
+
+    ImGuiContextScope(const ImGuiContextScope&) = delete;
+    ImGuiContextScope& operator=(const ImGuiContextScope&) = delete;
+
+private:
+    ImGuiContext* context_;
+};
+
+/// Render one ImGui frame with a window holding `lines` lines of text.
+ImDrawData* renderFrame(int lines)
+{
+    ImGui::NewFrame();
+    ImGui::Begin("Snapshot");
+    for (int i = 0; i < lines; ++i)
+    {
+        ImGui::TextUnformatted("frame packet");
+    }
+    ImGui::End();
+    ImGui::Render();
+    return ImGui::GetDrawData();
+}
+
+/// Byte copy of one draw list's buffers.
+struct ListContents {
+    std::vector<std::byte> commands;
+    std::vector<std::byte> indices;
+    std::vector<std::byte> vertices;
+
+    bool operator==(const ListContents&) const = default;
+};
+
+template<typename T>
+std::vector<std::byte> bytesOf(const ImVector<T>& buffer)
+{
+    std::vector<std::byte> bytes(sizeof(T) * static_cast<std::size_t>(buffer.Size));
+    if (!bytes.empty())
+    {
+        std::memcpy(bytes.data(), buffer.Data, bytes.size());
+    }
+    return bytes;
+}
+
+std::vector<ListContents> contentsOf(const ImDrawData& data)
+{
+    std::vector<ListContents> lists;
+    for (int i = 0; i < data.CmdListsCount; ++i)
+    {
+        const ImDrawList& list = *data.CmdLists[i];
+        lists.push_back({.commands = bytesOf(list.CmdBuffer),
+                         .indices = bytesOf(list.IdxBuffer),
+                         .vertices = bytesOf(list.VtxBuffer)});
+    }
+    return lists;
+}
+
+} // namespace
+
+TEST_CASE("FramePacketQueue hands packets over in publish order")
+{
+    FramePacketQueue queue(3);
+    constexpr std::uint64_t kFrames = 200;
+
+    std::thread producer(
+        [&queue]
+        {
+            for (std::uint64_t frame = 1; frame <= kFrames; ++frame)
+            {
+                FramePacket* packet = queue.acquireForBuild();
+                if (packet == nullptr)
+                {
+                    return;
+                }
+                packet->frameIndex = frame;
+                packet->draws.assign(frame % 4, vibegl::DrawCommand{.mesh = 7});
+                queue.publish(packet);
+            }
+        });
+
+    std::uint64_t expected = 1;
+    std::size_t mismatches = 0;
+    while (expected <= kFrames)
+    {
+        FramePacket* packet = queue.acquireForRender();
+        if (packet == nullptr)
+        {
+            break;
+        }
+        if (packet->frameIndex != expected || packet->draws.size() != expected % 4)
+        {
+            ++mismatches;
+        }
+        queue.release(packet);
+        ++expected;
+    }
+    producer.join();
+    CHECK(expected == kFrames + 1);
+    CHECK(mismatches == 0);
+}
+
+TEST_CASE("FramePacketQueue blocks the producer while every packet is in flight")
+{
+    FramePacketQueue queue(2);
+    FramePacket* first = queue.acquireForBuild();
+    FramePacket* second = queue.acquireForBuild();
+    REQUIRE(first != nullptr);
+    REQUIRE(second != nullptr);
+    CHECK(first != second);
+    first->frameIndex = 1;
+    second->frameIndex = 2;
+    queue.publish(first);
+    queue.publish(second);
+
+    std::atomic<FramePacket*> third = nullptr;
+    std::thread producer([&] { third = queue.acquireForBuild(); });
+    std::this_thread::sleep_for(kBlockedTime);
+    CHECK(third.load() == nullptr);
+
+    // Rendering the oldest frame frees its packet for the waiting producer
+    FramePacket* rendered = queue.acquireForRender();
+    CHECK(rendered == first);
+    queue.release(rendered);
+    producer.join();
+    CHECK(third.load() == first);
+    queue.waitForRendered(1);
+
+    CHECK(queue.acquireForRender() == second);
+}
+
+TEST_CASE("FramePacketQueue keeps at least two packets")
+{
+    FramePacketQueue queue(0);
+    CHECK(queue.acquireForBuild() != nullptr);
+    CHECK(queue.acquireForBuild() != nullptr);
+}
+
+TEST_CASE("FramePacketQueue waits for rendered frames")
+{
+    FramePacketQueue queue(2);
+    FramePacket* packet = queue.acquireForBuild();
+    packet->frameIndex = 5;
+    queue.publish(packet);
+
+    std::atomic<bool> done = false;
+    std::thread waiter(
+        [&]
+        {
+            queue.waitForRendered(5);
+            done = true;
+        });
+    std::this_thread::sleep_for(kBlockedTime);
+    CHECK_FALSE(done.load());
+
+    queue.release(queue.acquireForRender());
+    waiter.join();
+    CHECK(done.load());
+}
+
+TEST_CASE("FramePacketQueue close wakes waiters and drains published packets")
+{
+    FramePacketQueue queue(2);
+    FramePacket* published = queue.acquireForBuild();
+    queue.publish(published);
+    queue.acquireForBuild();
+
+    // The producer is out of packets and the renderer never releases one
+    std::atomic<bool> woken = false;
+    std::atomic<FramePacket*> acquired = published;
+    std::thread producer(
+        [&]
+        {
+            acquired = queue.acquireForBuild();
+            woken = true;
+        });
+    std::this_thread::sleep_for(kBlockedTime);
+    CHECK_FALSE(woken.load());
+    queue.close();
+    producer.join();
+    CHECK(woken.load());
+    CHECK(acquired.load() == nullptr);
+
+    // Work published before closing is still rendered
+    CHECK(queue.acquireForRender() == published);
+    CHECK(queue.acquireForRender() == nullptr);
+    queue.waitForRendered(100);
+}
+
+TEST_CASE("UiDrawSnapshot is empty until draw data is captured")
+{
+    const ImGuiContextScope context;
+    UiDrawSnapshot snapshot;
+    CHECK(snapshot.get() == nullptr);
+
+    snapshot.capture(renderFrame(1));
+    CHECK(snapshot.get() != nullptr);
+
+    snapshot.capture(nullptr);
+    CHECK(snapshot.get() == nullptr);
+    CHECK_FALSE(snapshot.hasTextureUpdates());
+}
+
+TEST_CASE("UiDrawSnapshot stays valid after the source draw lists are cleared")
+{
+    const ImGuiContextScope context;
+    UiDrawSnapshot snapshot;
+
+    ImDrawData* source = renderFrame(3);
+    REQUIRE(source->CmdListsCount > 0);
+    const std::vector<ListContents> expected = contentsOf(*source);
+    const int totalVertices = source->TotalVtxCount;
+    snapshot.capture(source);
+
+    // Release the source buffers, as the next frame would reuse them
+    for (ImDrawList* list : source->CmdLists)
+    {
+        list->CmdBuffer.clear();
+        list->IdxBuffer.clear();
+        list->VtxBuffer.clear();
+    }
+
+    const ImDrawData* copy = snapshot.get();
+    REQUIRE(copy != nullptr);
+    REQUIRE(copy->CmdListsCount == static_cast<int>(expected.size()));
+    CHECK(copy->TotalVtxCount == totalVertices);
+    CHECK(copy->DisplaySize.x == 320.0f);
+    for (int i = 0; i < copy->CmdListsCount; ++i)
+    {
+        CHECK(copy->CmdLists[i] != source->CmdLists[i]);
+    }
+    CHECK(contentsOf(*copy) == expected);
+}
+
+TEST_CASE("UiDrawSnapshot is independent of later frames and reuses its lists")
+{
+    const ImGuiContextScope context;
+    UiDrawSnapshot snapshot;
+
+    snapshot.capture(renderFrame(2));
+    const std::vector<ListContents> captured = contentsOf(*snapshot.get());
+    const ImDrawList* firstList = snapshot.get()->CmdLists[0];
+
+    // A different UI on the next frame does not show through
+    const std::vector<ListContents> next = contentsOf(*renderFrame(8));
+    CHECK(next != captured);
+    CHECK(contentsOf(*snapshot.get()) == captured);
+
+    // Capturing again copies into the lists it already owns
+    snapshot.capture(renderFrame(8));
+    CHECK(snapshot.get()->CmdLists[0] == firstList);
+    CHECK(contentsOf(*snapshot.get()) == next);
+}
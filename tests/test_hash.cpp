@@ -0,0 +1,50 @@
+#include <algorithm>
+#include <array>
+#include <string>
+#include <string_view>
+
+#include <doctest/doctest.h>
+
+#include "core/Hash.hpp"
+
+using vibegl::fnv1a64;
+using vibegl::NameHash;
+
+// Literal hashes are computed by the compiler
+static_assert(NameHash("uMVP").value == fnv1a64("uMVP"));
+static_assert(NameHash("uMVP") == NameHash::fromString("uMVP"));
+static_assert(NameHash().value == 0);
+
+TEST_CASE("fnv1a64 matches the reference FNV-1a values")
+{
+    CHECK(fnv1a64("") == vibegl::kFnv1aSeed);
+    CHECK(fnv1a64("a") == 0xAF63DC4C8601EC8CULL);
+    CHECK(fnv1a64("foobar") == 0x85944171F73967E8ULL);
+
+    // Bytes above 0x7F hash as unsigned, whatever the signedness of char
+    CHECK(fnv1a64("\xFF") == ((vibegl::kFnv1aSeed ^ 0xFFULL) * 1099511628211ULL));
+}
+
+TEST_CASE("fnv1a64 chains through the seed")
+{
+    CHECK(fnv1a64("bar", fnv1a64("foo")) == fnv1a64("foobar"));
+    CHECK(fnv1a64("", fnv1a64("foo")) == fnv1a64("foo"));
+    CHECK(fnv1a64("foo", 1) != fnv1a64("foo"));
+
+    // Embedded zero bytes count, so lengths are not ambiguous
+    CHECK(fnv1a64(std::string_view("a\0b", 3)) != fnv1a64("ab"));
+}
+
+TEST_CASE("NameHash compares by value")
+{
+    const std::string runtime = std::string("uLig") + "hts";
+    CHECK(NameHash::fromString(runtime) == NameHash("uLights"));
+    CHECK(NameHash("uLights") != NameHash("uLights[0]"));
+    CHECK(NameHash("uMVP") != NameHash("uMvp"));
+
+    // Ordering is the hash order the reflection tables are sorted by
+    std::array<NameHash, 4> names = {"uMVP", "uTexture", "uLights", "uTime"};
+    std::ranges::sort(names);
+    CHECK(std::ranges::is_sorted(names, {}, &NameHash::value));
+    CHECK(std::ranges::adjacent_find(names) == names.end());
+}
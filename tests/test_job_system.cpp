@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+#include "core/JobSystem.hpp"
+
+using vibegl::JobCounter;
+using vibegl::JobSystem;
+
+TEST_CASE("JobSystem runs submitted jobs")
+{
+    JobSystem jobs;
+    jobs.start(-1);
+    REQUIRE(jobs.isRunning());
+    CHECK(jobs.threadCount() >= 1);
+    CHECK(jobs.currentWorkerIndex() == 0);
+
+    SUBCASE("Every job runs exactly once")
+    {
+        constexpr std::size_t kJobs = 10000;
+        std::vector<std::atomic<int>> runs(kJobs);
+        JobCounter counter;
+        for (std::size_t i = 0; i < kJobs; ++i)
+        {
+            jobs.submit([&runs, i] { runs[i].fetch_add(1, std::memory_order_relaxed); },
+                        &counter);
+        }
+        jobs.wait(counter);
+        CHECK(counter.isDone());
+        CHECK(std::ranges::all_of(runs, [](const std::atomic<int>& run) { return run == 1; }));
+    }
+
+    SUBCASE("Jobs submitted from jobs are counted")
+    {
+        // Nested submits go through the workers' own deques and get stolen from there
+        std::atomic<int> leaves{0};
+        JobCounter counter;
+        for (int i = 0; i < 64; ++i)
+        {
+            jobs.submit(
+                [&jobs, &leaves, &counter]
+                {
+                    for (int j = 0; j < 64; ++j)
+                    {
+                        jobs.submit([&leaves] { leaves.fetch_add(1); }, &counter);
+                    }
+                },
+                &counter);
+        }
+        jobs.wait(counter);
+        CHECK(leaves.load() == 64 * 64);
+    }
+
+    SUBCASE("More jobs than a deque holds")
+    {
+        std::atomic<std::size_t> runs{0};
+        JobCounter counter;
+        jobs.submit(
+            [&jobs, &runs, &counter]
+            {
+                for (std::size_t i = 0; i < JobSystem::kDequeCapacity * 2; ++i)
+                {
+                    jobs.submit([&runs] { runs.fetch_add(1); }, &counter);
+                }
+            },
+            &counter);
+        jobs.wait(counter);
+        CHECK(runs.load() == JobSystem::kDequeCapacity * 2);
+    }
+
+    SUBCASE("Submits from a thread that is not a worker")
+    {
+        std::atomic<int> runs{0};
+        JobCounter counter;
+        std::thread outside(
+            [&]
+            {
+                CHECK(jobs.currentWorkerIndex() == JobSystem::kNotAWorker);
+                for (int i = 0; i < 1000; ++i)
+                {
+                    jobs.submit([&runs] { runs.fetch_add(1); }, &counter);
+                }
+            });
+        outside.join();
+        jobs.wait(counter);
+        CHECK(runs.load() == 1000);
+    }
+
+    SUBCASE("A job waits for its dependency")
+    {
+        std::atomic<int> finished{0};
+        std::atomic<bool> orderKept{true};
+        JobCounter first;
+        JobCounter second;
+        for (int i = 0; i < 32; ++i)
+        {
+            jobs.submit([&finished] { finished.fetch_add(1); }, &first);
+        }
+        for (int i = 0; i < 32; ++i)
+        {
+            jobs.submit(
+                [&finished, &orderKept]
+                {
+                    if (finished.load() != 32)
+                    {
+                        orderKept.store(false);
+                    }
+                },
+                &second, &first);
+        }
+        jobs.wait(second);
+        CHECK(first.isDone());
+        CHECK(orderKept.load());
+    }
+
+    jobs.stop();
+    CHECK_FALSE(jobs.isRunning());
+}
+
+TEST_CASE("JobSystem parallelFor covers the range once")
+{
+    JobSystem jobs;
+    jobs.start(-1);
+
+    for (const std::size_t grain : {std::size_t{0}, std::size_t{1}, std::size_t{7},
+                                    std::size_t{1000}, std::size_t{5000}})
+    {
+        INFO("grain " << grain);
+        std::vector<int> hits(1000, 0);
+        jobs.parallelFor(hits.size(), grain,
+                         [&hits](std::size_t begin, std::size_t end)
+                         {
+                             for (std::size_t i = begin; i < end; ++i)
+                             {
+                                 ++hits[i];
+                             }
+                         });
+        CHECK(std::accumulate(hits.begin(), hits.end(), 0) == 1000);
+        CHECK(std::ranges::all_of(hits, [](int hit) { return hit == 1; }));
+    }
+
+    bool called = false;
+    jobs.parallelFor(0, 1, [&called](std::size_t, std::size_t) { called = true; });
+    CHECK_FALSE(called);
+
+    jobs.stop();
+}
+
+TEST_CASE("JobSystem without worker threads runs jobs while waiting")
+{
+    JobSystem jobs;
+    jobs.start(0);
+    CHECK(jobs.threadCount() == 1);
+
+    int runs = 0;
+    JobCounter counter;
+    for (int i = 0; i < 100; ++i)
+    {
+        jobs.submit([&runs] { ++runs; }, &counter);
+    }
+    CHECK(runs == 0);
+    jobs.wait(counter);
+    CHECK(runs == 100);
+
+    jobs.stop();
+}
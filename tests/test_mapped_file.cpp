@@ -0,0 +1,151 @@
+#include <cstddef>
+#include <filesystem>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+#include "core/MappedFile.hpp"
+
+using vibegl::MappedFile;
+
+namespace
+{
+
+// Mirrors the platforms MappedFile maps on
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+constexpr bool kMapsLargeFiles = true;
+#else
+constexpr bool kMapsLargeFiles = false;
+#endif
+
+/// Scratch directory, removed again by the destructor.
+class ScratchDirectory {
+public:
+    explicit ScratchDirectory(std::string_view name)
+        : root_(std::filesystem::temp_directory_path() / "vibegl_tests" / name)
+    {
+        std::error_code error;
+        std::filesystem::remove_all(root_, error);
+        std::filesystem::create_directories(root_);
+    }
+
+    ~ScratchDirectory()
+    {
+        std::error_code error;
+        std::filesystem::remove_all(root_, error);
+    }
+
+    ScratchDirectory(const ScratchDirectory&) = delete;
+    ScratchDirectory& operator=(const ScratchDirectory&) = delete;
+
+    const std::filesystem::path& root() const { return root_; }
+
+private:
+    std::filesystem::path root_;
+};
+
+std::vector<std::byte> pattern(std::size_t size)
+{
+    std::vector<std::byte> bytes(size);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        bytes[i] = static_cast<std::byte>((i * 31) % 253);
+    }
+    return bytes;
+}
+
+std::vector<std::byte> copy(std::span<const std::byte> bytes)
+{
+    return {bytes.begin(), bytes.end()};
+}
+
+} // namespace
+
+TEST_CASE("MappedFile reads files on both sides of the mapping threshold")
+{
+    ScratchDirectory dir("mapped_file_sizes");
+
+    for (const std::size_t size : {std::size_t{0}, std::size_t{1}, MappedFile::kMapThreshold - 1,
+                                   MappedFile::kMapThreshold, MappedFile::kMapThreshold * 3 + 17})
+    {
+        INFO("size " << size);
+        const std::filesystem::path path = dir.root() / ("file" + std::to_string(size));
+        const std::vector<std::byte> contents = pattern(size);
+        REQUIRE(vibegl::writeFileAtomically(path, contents).has_value());
+
+        auto file = MappedFile::open(path);
+        REQUIRE(file.has_value());
+        CHECK(file->size() == size);
+        CHECK(file->isMapped() == (kMapsLargeFiles && size >= MappedFile::kMapThreshold));
+        CHECK(copy(file->bytes()) == contents);
+    }
+}
+
+TEST_CASE("MappedFile keeps its contents when moved")
+{
+    ScratchDirectory dir("mapped_file_move");
+    const std::vector<std::byte> contents = pattern(MappedFile::kMapThreshold);
+    REQUIRE(vibegl::writeFileAtomically(dir.root() / "large.bin", contents).has_value());
+
+    auto opened = MappedFile::open(dir.root() / "large.bin");
+    REQUIRE(opened.has_value());
+    MappedFile moved = std::move(*opened);
+    CHECK(opened->size() == 0);  // NOLINT(bugprone-use-after-move)
+    CHECK_FALSE(opened->isMapped());  // NOLINT(bugprone-use-after-move)
+    CHECK(copy(moved.bytes()) == contents);
+
+    MappedFile assigned = MappedFile::fromBuffer(pattern(4));
+    assigned = std::move(moved);
+    CHECK(assigned.isMapped() == kMapsLargeFiles);
+    CHECK(copy(assigned.bytes()) == contents);
+}
+
+TEST_CASE("MappedFile reports a missing file")
+{
+    ScratchDirectory dir("mapped_file_missing");
+    const std::filesystem::path path = dir.root() / "missing.bin";
+
+    const auto file = MappedFile::open(path);
+    REQUIRE_FALSE(file.has_value());
+    CHECK(file.error().message == "Failed to read file");
+    CHECK(file.error().context.find(path.string()) != std::string::npos);
+    CHECK(file.error().context.find("errno") != std::string::npos);
+}
+
+TEST_CASE("MappedFile wraps a buffer")
+{
+    const MappedFile file = MappedFile::fromBuffer(pattern(100));
+    CHECK(file.size() == 100);
+    CHECK_FALSE(file.isMapped());
+    CHECK(copy(file.bytes()) == pattern(100));
+
+    const MappedFile text = MappedFile::fromBuffer({std::byte{'h'}, std::byte{'i'}});
+    CHECK(text.text() == "hi");
+}
+
+TEST_CASE("writeFileAtomically replaces files and leaves no temporaries")
+{
+    ScratchDirectory dir("mapped_file_write");
+    const std::filesystem::path path = dir.root() / "nested" / "deeper" / "file.bin";
+
+    REQUIRE(vibegl::writeFileAtomically(path, pattern(1000)).has_value());
+    REQUIRE(vibegl::writeFileAtomically(path, pattern(10)).has_value());
+    auto file = MappedFile::open(path);
+    REQUIRE(file.has_value());
+    CHECK(copy(file->bytes()) == pattern(10));
+
+    const std::filesystem::directory_iterator entries(path.parent_path());
+    CHECK(std::distance(begin(entries), end(entries)) == 1);
+
+    // A directory in the way cannot be replaced
+    const auto blocked = vibegl::writeFileAtomically(dir.root() / "nested", pattern(10));
+    REQUIRE_FALSE(blocked.has_value());
+    CHECK(blocked.error().message == "Failed to write file");
+    CHECK(std::filesystem::is_directory(dir.root() / "nested"));
+}
@@ -0,0 +1,149 @@
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+#include "core/JobSystem.hpp"
+#include "core/Simd.hpp"
+#include "rendering/MipGenerator.hpp"
+
+using vibegl::MipChain;
+using vibegl::MipGenerator;
+
+namespace
+{
+
+/// Noisy gradient; odd sizes exercise the clamped edge rows and columns.
+std::vector<unsigned char> testImage(int width, int height)
+{
+    std::vector<unsigned char> rgba(static_cast<std::size_t>(width) *
+                                    static_cast<std::size_t>(height) * 4);
+    std::uint32_t noise = 2463534242U;
+    for (std::size_t i = 0; i < rgba.size(); ++i)
+    {
+        noise ^= noise << 13U;
+        noise ^= noise >> 17U;
+        noise ^= noise << 5U;
+        rgba[i] = static_cast<unsigned char>((i / 7) + (noise >> 29U));
+    }
+    return rgba;
+}
+
+/// Every texel of a level, in order.
+std::vector<unsigned char> levelPixels(const MipChain& chain, std::size_t level)
+{
+    const unsigned char* data = chain.data(level);
+    const auto size = static_cast<std::size_t>(chain.levels[level].width) *
+                      static_cast<std::size_t>(chain.levels[level].height) * 4;
+    return {data, data + size};
+}
+
+std::vector<std::vector<unsigned char>> allLevels(const MipChain& chain)
+{
+    std::vector<std::vector<unsigned char>> levels;
+    for (std::size_t i = 0; i < chain.levels.size(); ++i)
+    {
+        levels.push_back(levelPixels(chain, i));
+    }
+    return levels;
+}
+
+double linearToSrgb(double value)
+{
+    return value <= 0.0031308 ? value * 12.92 : (1.055 * std::pow(value, 1.0 / 2.4)) - 0.055;
+}
+
+} // namespace
+
+TEST_CASE("MipGenerator level sizes")
+{
+    CHECK(MipGenerator::levelCount(1, 1) == 1);
+    CHECK(MipGenerator::levelCount(2, 1) == 2);
+    CHECK(MipGenerator::levelCount(256, 256) == 9);
+    CHECK(MipGenerator::levelCount(257, 131) == 9);
+    CHECK(MipGenerator::levelCount(1, 1000) == 10);
+
+    const std::vector<unsigned char> rgba = testImage(257, 131);
+    const MipChain chain = MipGenerator::generate(rgba.data(), 257, 131);
+    REQUIRE(chain.levels.size() == 8);
+
+    // Each level halves and rounds down, never below 1
+    constexpr std::array<int, 8> kWidths = {128, 64, 32, 16, 8, 4, 2, 1};
+    constexpr std::array<int, 8> kHeights = {65, 32, 16, 8, 4, 2, 1, 1};
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < chain.levels.size(); ++i)
+    {
+        INFO("level " << i + 1);
+        CHECK(chain.levels[i].width == kWidths[i]);
+        CHECK(chain.levels[i].height == kHeights[i]);
+        CHECK(chain.levels[i].offset == offset);
+        offset += static_cast<std::size_t>(kWidths[i]) * static_cast<std::size_t>(kHeights[i]) * 4;
+    }
+
+    CHECK(MipGenerator::generate(rgba.data(), 1, 1).levels.empty());
+    CHECK(MipGenerator::generate(nullptr, 257, 131).levels.empty());
+}
+
+TEST_CASE("MipGenerator averages colour in linear light and alpha as stored")
+{
+    // Black and white checker with alpha alternating the same way
+    constexpr int kSize = 8;
+    std::vector<unsigned char> rgba(kSize * kSize * 4);
+    for (int y = 0; y < kSize; ++y)
+    {
+        for (int x = 0; x < kSize; ++x)
+        {
+            const unsigned char value = (x + y) % 2 == 0 ? 0 : 255;
+            const auto texel = static_cast<std::size_t>((y * kSize) + x) * 4;
+            rgba[texel + 0] = value;
+            rgba[texel + 1] = value;
+            rgba[texel + 2] = value;
+            rgba[texel + 3] = value;
+        }
+    }
+
+    // Half the light of white, re-encoded: 188, where gamma-space averaging gives 128
+    const auto expected = static_cast<int>(std::lround(linearToSrgb(0.5) * 255.0));
+    REQUIRE(expected == 188);
+
+    const MipChain chain = MipGenerator::generate(rgba.data(), kSize, kSize);
+    REQUIRE(chain.levels.size() == 3);
+    for (std::size_t level = 0; level < chain.levels.size(); ++level)
+    {
+        INFO("level " << level + 1);
+        const std::vector<unsigned char> pixels = levelPixels(chain, level);
+        for (std::size_t i = 0; i < pixels.size(); i += 4)
+        {
+            CHECK(pixels[i + 0] == expected);
+            CHECK(pixels[i + 1] == expected);
+            CHECK(pixels[i + 2] == expected);
+            CHECK(pixels[i + 3] == 128);
+        }
+    }
+}
+
+TEST_CASE("MipGenerator SIMD, scalar and parallel output match")
+{
+    vibegl::JobSystem jobs;
+    jobs.start(-1);
+
+    // Large enough for the first levels to be split across workers
+    for (const auto& [width, height] : {std::pair{1031, 517}, std::pair{257, 131},
+                                        std::pair{6, 5}})
+    {
+        INFO(width << "x" << height);
+        const std::vector<unsigned char> rgba = testImage(width, height);
+        const auto serial = allLevels(MipGenerator::generate(rgba.data(), width, height));
+        CHECK(allLevels(MipGenerator::generate(rgba.data(), width, height, &jobs)) == serial);
+
+        vibegl::Simd::setEnabled(false);
+        CHECK(allLevels(MipGenerator::generate(rgba.data(), width, height)) == serial);
+        CHECK(allLevels(MipGenerator::generate(rgba.data(), width, height, &jobs)) == serial);
+        vibegl::Simd::setEnabled(true);
+    }
+    jobs.stop();
+}
@@ -0,0 +1,148 @@
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <doctest/doctest.h>
+
+#include "rendering/PipelineWarmup.hpp"
+
+using vibegl::PipelineKey;
+using vibegl::PipelineWarmup;
+using vibegl::ShaderLibrary;
+
+namespace
+{
+
+/// Scratch directory, removed again by the destructor.
+class ScratchDirectory {
+public:
+    explicit ScratchDirectory(std::string_view name)
+        : root_(std::filesystem::temp_directory_path() / "vibegl_tests" / name)
+    {
+        std::error_code error;
+        std::filesystem::remove_all(root_, error);
+        std::filesystem::create_directories(root_);
+    }
+
+    ~ScratchDirectory()
+    {
+        std::error_code error;
+        std::filesystem::remove_all(root_, error);
+    }
+
+    ScratchDirectory(const ScratchDirectory&) = delete;
+    ScratchDirectory& operator=(const ScratchDirectory&) = delete;
+
+    const std::filesystem::path& root() const { return root_; }
+
+private:
+    std::filesystem::path root_;
+};
+
+void writeText(const std::filesystem::path& path, std::string_view text)
+{
+    std::ofstream(path, std::ios::binary) << text;
+}
+
+std::string readText(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+} // namespace
+
+TEST_CASE("PipelineWarmup manifests round-trip entries for shaders not loaded")
+{
+    ScratchDirectory dir("pipeline_manifest_round_trip");
+    writeText(dir.root() / "in.txt", "# VibeGL pipeline manifest v1\r\n"
+                                     "water 3 mesh 7\r\n"
+                                     "\n"
+                                     "# comments and blank lines are ignored\n"
+                                     "cube 1 cube 1\n"
+                                     "  cube 0 cube 1  \n"
+                                     "cube 1 cube 1\n");
+
+    // No GL is needed: nothing resolves against an empty library, so every entry is kept
+    ShaderLibrary library;
+    PipelineWarmup warmup(library);
+    warmup.addLayout("cube", {});
+    const auto loaded = warmup.loadManifest(dir.root() / "in.txt");
+    REQUIRE(loaded.has_value());
+    CHECK(loaded.value() == 4);
+
+    // Keys for shaders the library does not know cannot be named, so they are dropped
+    warmup.record(PipelineKey{.shader = {}, .features = 5, .layout = 0, .state = 2});
+
+    REQUIRE(warmup.saveManifest(dir.root() / "out.txt").has_value());
+    const std::string saved = readText(dir.root() / "out.txt");
+    CHECK(saved == "# VibeGL pipeline manifest v1\n"
+                   "cube 0 cube 1\n"
+                   "cube 1 cube 1\n"
+                   "water 3 mesh 7\n");
+
+    // A saved manifest reads back to the same file
+    PipelineWarmup reloaded(library);
+    const auto reread = reloaded.loadManifest(dir.root() / "out.txt");
+    REQUIRE(reread.has_value());
+    CHECK(reread.value() == 3);
+    REQUIRE(reloaded.saveManifest(dir.root() / "again.txt").has_value());
+    CHECK(readText(dir.root() / "again.txt") == saved);
+}
+
+TEST_CASE("PipelineWarmup skips malformed manifest lines")
+{
+    ScratchDirectory dir("pipeline_manifest_lines");
+    writeText(dir.root() / "in.txt", "# VibeGL pipeline manifest v1\n"
+                                     "cube 1 cube\n"            // Missing state
+                                     "cube 1 cube 1 extra\n"    // Trailing field
+                                     "cube -1 cube 1\n"         // Negative mask
+                                     "cube 1x cube 1\n"         // Not a number
+                                     "cube 1 cube 4294967296\n" // Out of range
+                                     "cube 2 cube 1\n");
+
+    ShaderLibrary library;
+    PipelineWarmup warmup(library);
+    const auto loaded = warmup.loadManifest(dir.root() / "in.txt");
+    REQUIRE(loaded.has_value());
+    CHECK(loaded.value() == 1);
+
+    REQUIRE(warmup.saveManifest(dir.root() / "out.txt").has_value());
+    CHECK(readText(dir.root() / "out.txt") == "# VibeGL pipeline manifest v1\n"
+                                               "cube 2 cube 1\n");
+}
+
+TEST_CASE("PipelineWarmup rejects files that are not manifests")
+{
+    ScratchDirectory dir("pipeline_manifest_rejected");
+    ShaderLibrary library;
+    PipelineWarmup warmup(library);
+
+    const auto missing = warmup.loadManifest(dir.root() / "missing.txt");
+    REQUIRE_FALSE(missing.has_value());
+    CHECK(missing.error().message == "Failed to read pipeline manifest");
+
+    for (const std::string_view text :
+         {std::string_view(""), std::string_view("cube 1 cube 1\n"),
+          std::string_view("# VibeGL pipeline manifest v2\ncube 1 cube 1\n")})
+    {
+        INFO(text);
+        writeText(dir.root() / "other.txt", text);
+        const auto rejected = warmup.loadManifest(dir.root() / "other.txt");
+        REQUIRE_FALSE(rejected.has_value());
+        CHECK(rejected.error().message == "Unsupported pipeline manifest");
+    }
+
+    // Nothing was taken from the rejected files
+    REQUIRE(warmup.saveManifest(dir.root() / "out.txt").has_value());
+    CHECK(readText(dir.root() / "out.txt") == "# VibeGL pipeline manifest v1\n");
+
+    // A directory in the way cannot be replaced
+    std::filesystem::create_directories(dir.root() / "blocked");
+    const auto blocked = warmup.saveManifest(dir.root() / "blocked");
+    REQUIRE_FALSE(blocked.has_value());
+    CHECK(blocked.error().message == "Failed to write pipeline manifest");
+}
@@ -0,0 +1,342 @@
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <doctest/doctest.h>
+
+#include "core/Profiler.hpp"
+
+using vibegl::Profiler;
+
+namespace
+{
+
+/// Minimal JSON syntax checker (RFC 8259 grammar, no semantic checks).
+class JsonValidator {
+public:
+    explicit JsonValidator(std::string_view text) : text_(text) {}
+
+    bool valid()
+    {
+        return value() && (skipSpace(), at_ == text_.size());
+    }
+
+private:
+    void skipSpace()
+    {
+        while (at_ < text_.size() && std::string_view(" \t\r\n").find(text_[at_]) !=
+                                         std::string_view::npos)
+        {
+            ++at_;
+        }
+    }
+
+    bool consume(char c)
+    {
+        skipSpace();
+        if (at_ < text_.size() && text_[at_] == c)
+        {
+            ++at_;
+            return true;
+        }
+        return false;
+    }
+
+    bool literal(std::string_view word)
+    {
+        if (text_.substr(at_, word.size()) != word)
+        {
+            return false;
+        }
+        at_ += word.size();
+        return true;
+    }
+
+    bool string()
+    {
+        if (!consume('"'))
+        {
+            return false;
+        }
+        while (at_ < text_.size())
+        {
+            const auto c = static_cast<unsigned char>(text_[at_++]);
+            if (c == '"')
+            {
+                return true;
+            }
+            if (c < 0x20)
+            {
+                return false;
+            }
+            if (c == '\\')
+            {
+                if (at_ >= text_.size())
+                {
+                    return false;
+                }
+                const char escape = text_[at_++];
+                if (escape == 'u')
+                {
+                    for (int i = 0; i < 4; ++i, ++at_)
+                    {
+                        if (at_ >= text_.size() ||
+                            std::isxdigit(static_cast<unsigned char>(text_[at_])) == 0)
+                        {
+                            return false;
+                        }
+                    }
+                }
+                else if (std::string_view("\"\\/bfnrt").find(escape) == std::string_view::npos)
+                {
+                    return false;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool number()
+    {
+        const std::size_t start = at_;
+        while (at_ < text_.size() &&
+               (std::isdigit(static_cast<unsigned char>(text_[at_])) != 0 ||
+                std::string_view("+-.eE").find(text_[at_]) != std::string_view::npos))
+        {
+            ++at_;
+        }
+        return at_ > start;
+    }
+
+    bool value()
+    {
+        skipSpace();
+        if (at_ >= text_.size())
+        {
+            return false;
+        }
+        switch (text_[at_])
+        {
+        case '{':
+            ++at_;
+            if (consume('}'))
+            {
+                return true;
+            }
+            do
+            {
+                if (!string() || !consume(':') || !value())
+                {
+                    return false;
+                }
+            } while (consume(','));
+            return consume('}');
+        case '[':
+            ++at_;
+            if (consume(']'))
+            {
+                return true;
+            }
+            do
+            {
+                if (!value())
+                {
+                    return false;
+                }
+            } while (consume(','));
+            return consume(']');
+        case '"':
+            return string();
+        case 't':
+            return literal("true");
+        case 'f':
+            return literal("false");
+        case 'n':
+            return literal("null");
+        default:
+            return number();
+        }
+    }
+
+    std::string_view text_;
+    std::size_t at_ = 0;
+};
+
+bool validJson(std::string_view text)
+{
+    return JsonValidator(text).valid();
+}
+
+/// Write a trace to a temporary file and return its contents.
+std::string chromeTrace()
+{
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "vibegl_tests" / "trace.json";
+    std::filesystem::create_directories(path.parent_path());
+    CHECK(Profiler::writeChromeTrace(path.string()).has_value());
+    std::ifstream file(path);
+    std::string contents{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    std::error_code error;
+    std::filesystem::remove(path, error);
+    return contents;
+}
+
+/// Run `body` on a fresh thread, so it records into a buffer of its own.
+template<typename F>
+void onThread(F&& body)
+{
+    std::thread thread(std::forward<F>(body));
+    thread.join();
+}
+
+} // namespace
+
+TEST_CASE("JSON validator")
+{
+    CHECK(validJson(R"({"a":[1,-2.5e3,"x\n\u0001"],"b":{},"c":true,"d":null})"));
+    CHECK_FALSE(validJson(R"({"a":1,})"));
+    CHECK_FALSE(validJson("{\"a\":\"raw\nnewline\"}"));
+    CHECK_FALSE(validJson(R"({"a":"\x"})"));
+}
+
+TEST_CASE("Profiler records nested zone depth")
+{
+    onThread(
+        []
+        {
+            Profiler::markFrame();
+            {
+                const Profiler::Scope outer("test.outer");
+                {
+                    const Profiler::Scope inner("test.inner");
+                    const Profiler::Scope innermost("test.innermost");
+                }
+                const Profiler::Scope inner("test.inner");
+            }
+            Profiler::markFrame();
+
+            const Profiler::ZoneList zones = Profiler::lastFrameZones();
+            REQUIRE(zones.size() == 3);
+            CHECK(std::string_view(zones[0].name) == "test.outer");
+            CHECK(zones[0].depth == 0);
+            CHECK(zones[0].calls == 1);
+            CHECK(std::string_view(zones[1].name) == "test.inner");
+            CHECK(zones[1].depth == 1);
+            CHECK(zones[1].calls == 2);
+            CHECK(std::string_view(zones[2].name) == "test.innermost");
+            CHECK(zones[2].depth == 2);
+            CHECK(zones[0].milliseconds >= zones[2].milliseconds);
+        });
+}
+
+TEST_CASE("Profiler lastFrameZones orders zones by start time")
+{
+    onThread(
+        []
+        {
+            Profiler::setThreadName("test.ordering");
+            Profiler::markFrame();
+            const std::int64_t t0 = Profiler::now();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            Profiler::markFrame();
+
+            // Stored in completion order: children end before their parents
+            Profiler::record("test.second", t0 + 1, t0 + 2, 1);
+            Profiler::record("test.third", t0 + 2, t0 + 3, 1);
+            Profiler::record("test.first", t0, t0 + 3, 0);
+
+            const Profiler::ZoneList zones = Profiler::lastFrameZones("test.ordering");
+            REQUIRE(zones.size() == 3);
+            CHECK(std::string_view(zones[0].name) == "test.first");
+            CHECK(std::string_view(zones[1].name) == "test.second");
+            CHECK(std::string_view(zones[2].name) == "test.third");
+        });
+
+    // The thread has exited, so its name no longer resolves
+    CHECK(Profiler::lastFrameZones("test.ordering").empty());
+}
+
+TEST_CASE("Profiler reuses the buffers of exited threads")
+{
+    onThread(
+        []
+        {
+            Profiler::setThreadName("test.first worker");
+            Profiler::record("test.exited", Profiler::now(), Profiler::now());
+        });
+    CHECK(chromeTrace().find("test.exited") != std::string::npos);
+
+    // Naming a thread does not give it a buffer
+    onThread([] { Profiler::setThreadName("test.idle"); });
+    CHECK(chromeTrace().find("test.idle") == std::string::npos);
+
+    // The next recording thread takes the exited thread's buffer over
+    onThread(
+        []
+        {
+            Profiler::setThreadName("test.second worker");
+            Profiler::record("test.replacement", Profiler::now(), Profiler::now());
+        });
+    const std::string trace = chromeTrace();
+    CHECK(trace.find("test.replacement") != std::string::npos);
+    CHECK(trace.find("test.second worker") != std::string::npos);
+    CHECK(trace.find("test.exited") == std::string::npos);
+    CHECK(trace.find("test.first worker") == std::string::npos);
+}
+
+TEST_CASE("Profiler ring buffer size is configurable")
+{
+    Profiler::setEventsPerThread(5);
+    CHECK(Profiler::eventsPerThread() == 8);
+
+    static constexpr std::array<const char*, 12> kNames = {
+        "test.ring0", "test.ring1", "test.ring2", "test.ring3",  "test.ring4",  "test.ring5",
+        "test.ring6", "test.ring7", "test.ring8", "test.ring9", "test.ring10", "test.ring11"};
+    onThread(
+        []
+        {
+            for (const char* name : kNames)
+            {
+                Profiler::record(name, Profiler::now(), Profiler::now());
+            }
+        });
+    Profiler::setEventsPerThread(Profiler::kDefaultEventsPerThread);
+
+    // Only the newest eight events survive
+    const std::string trace = chromeTrace();
+    for (std::size_t i = 0; i < kNames.size(); ++i)
+    {
+        INFO(kNames[i]);
+        CHECK((trace.find(std::string(kNames[i]) + "\"") != std::string::npos) == (i >= 4));
+    }
+}
+
+TEST_CASE("Profiler Chrome trace export is valid JSON")
+{
+    onThread(
+        []
+        {
+            Profiler::setThreadName("test.\"quoted\"\tthread\\name\n");
+            const Profiler::Scope outer("test.trace outer");
+            const Profiler::Scope inner("test.trace\ninner");
+        });
+    const Profiler::TrackId track = Profiler::createTrack("test.track");
+    Profiler::recordOnTrack(track, "test.track zone", Profiler::now(), Profiler::now());
+
+    const std::string trace = chromeTrace();
+    CHECK(validJson(trace));
+    CHECK(trace.find(R"("name":"thread_name")") != std::string::npos);
+    CHECK(trace.find(R"("test.\"quoted\"\u0009thread\\name\u000a")") != std::string::npos);
+    CHECK(trace.find(R"("test.trace\u000ainner")") != std::string::npos);
+    CHECK(trace.find(R"("name":"test.track zone","ph":"X")") != std::string::npos);
+}
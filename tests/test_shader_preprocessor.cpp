@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+#include "rendering/ShaderPreprocessor.hpp"
+
+using vibegl::ShaderPreprocessor;
+
+namespace
+{
+
+/// Scratch directory of shader files, removed again by the destructor.
+class ShaderDirectory {
+public:
+    explicit ShaderDirectory(std::string_view name)
+        : root_(std::filesystem::temp_directory_path() / "vibegl_tests" / name)
+    {
+        std::error_code error;
+        std::filesystem::remove_all(root_, error);
+        std::filesystem::create_directories(root_);
+    }
+
+    ~ShaderDirectory()
+    {
+        std::error_code error;
+        std::filesystem::remove_all(root_, error);
+    }
+
+    ShaderDirectory(const ShaderDirectory&) = delete;
+    ShaderDirectory& operator=(const ShaderDirectory&) = delete;
+
+    /// Write a file and return its path. Rewrites get a later modification time.
+    std::filesystem::path write(const std::string& name, std::string_view contents)
+    {
+        const std::filesystem::path path = root_ / name;
+        const bool existed = std::filesystem::exists(path);
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path, std::ios::trunc) << contents;
+        if (existed)
+        {
+            // Coarse file system timestamps must not hide the edit
+            std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) +
+                                                       std::chrono::seconds(2));
+        }
+        return path;
+    }
+
+    /// Cache key the preprocessor uses for a file.
+    std::string key(const std::string& name) const
+    {
+        return (root_ / name).lexically_normal().string();
+    }
+
+private:
+    std::filesystem::path root_;
+};
+
+std::vector<std::string> sorted(const std::vector<std::filesystem::path>& paths)
+{
+    std::vector<std::string> names;
+    for (const std::filesystem::path& path : paths)
+    {
+        names.push_back(path.string());
+    }
+    std::ranges::sort(names);
+    return names;
+}
+
+std::size_t occurrences(std::string_view text, std::string_view needle)
+{
+    std::size_t count = 0;
+    for (std::size_t at = text.find(needle); at != std::string_view::npos;
+         at = text.find(needle, at + needle.size()))
+    {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+TEST_CASE("ShaderPreprocessor expands nested includes with #line directives")
+{
+    ShaderDirectory dir("preprocessor_nested");
+    dir.write("lib/b.glsl", "float b() { return 1.0; }\n");
+    dir.write("lib/a.glsl", "#include \"b.glsl\"\nfloat a() { return b(); }\n");
+    const auto root = dir.write("main.frag", "#version 460 core\n"
+                                             "out vec4 color;\n"
+                                             "#include \"lib/a.glsl\"\n"
+                                             "void main() { color = vec4(a()); }\n");
+
+    ShaderPreprocessor preprocessor;
+    const auto source = preprocessor.process(root);
+    REQUIRE(source.has_value());
+
+    // #version first, then the legend, then each run of lines tagged with its file and line
+    std::string expected = "#version 460 core\n";
+    expected += "// source 0: " + dir.key("main.frag") + "\n";
+    expected += "// source 1: " + dir.key("lib/a.glsl") + "\n";
+    expected += "// source 2: " + dir.key("lib/b.glsl") + "\n";
+    expected += "#line 2 0\n"
+                "out vec4 color;\n"
+                "#line 1 2\n"
+                "float b() { return 1.0; }\n"
+                "#line 2 1\n"
+                "float a() { return b(); }\n"
+                "#line 4 0\n"
+                "void main() { color = vec4(a()); }\n";
+    CHECK(*source == expected);
+}
+
+TEST_CASE("ShaderPreprocessor includes each file once and stops at cycles")
+{
+    ShaderDirectory dir("preprocessor_once");
+    dir.write("common.glsl", "const float kCommon = 1.0;\n");
+    dir.write("a.glsl", "#include \"common.glsl\"\n#include \"b.glsl\"\nfloat a;\n");
+    dir.write("b.glsl", "#include \"a.glsl\"\n#include \"common.glsl\"\nfloat b;\n");
+    const auto root = dir.write("main.frag", "#version 460 core\n"
+                                             "#include \"common.glsl\"\n"
+                                             "#include \"a.glsl\"\n"
+                                             "#include \"common.glsl\"\n"
+                                             "void main() {}\n");
+
+    ShaderPreprocessor preprocessor;
+    const auto source = preprocessor.process(root);
+    REQUIRE(source.has_value());
+    CHECK(occurrences(*source, "const float kCommon") == 1);
+    CHECK(occurrences(*source, "float a;") == 1);
+    CHECK(occurrences(*source, "float b;") == 1);
+    CHECK(occurrences(*source, "// source ") == 4);
+    CHECK(source->find("float b;") < source->find("float a;"));
+}
+
+TEST_CASE("ShaderPreprocessor reports where a missing include was included from")
+{
+    ShaderDirectory dir("preprocessor_missing");
+    dir.write("a.glsl", "float a;\n\n#include \"missing.glsl\"\n");
+    const auto root =
+        dir.write("main.frag", "#version 460 core\n#include \"a.glsl\"\nvoid main() {}\n");
+
+    ShaderPreprocessor preprocessor;
+    const auto source = preprocessor.process(root);
+    REQUIRE_FALSE(source.has_value());
+    CHECK(source.error().message == "Failed to open shader file");
+    const std::string& context = source.error().context;
+    CHECK(context.find("missing.glsl") != std::string::npos);
+    const std::size_t fromA = context.find("(included from " + dir.key("a.glsl") + ":3)");
+    const std::size_t fromMain = context.find("(included from " + dir.key("main.frag") + ":2)");
+    REQUIRE(fromA != std::string::npos);
+    REQUIRE(fromMain != std::string::npos);
+    CHECK(fromA < fromMain);
+}
+
+TEST_CASE("ShaderPreprocessor tracks dependencies across edits")
+{
+    ShaderDirectory dir("preprocessor_graph");
+    dir.write("b.glsl", "float b;\n");
+    dir.write("a.glsl", "#include \"b.glsl\"\nfloat a;\n");
+    const auto root = dir.write("main.frag", "#include \"a.glsl\"\nvoid main() {}\n");
+    const auto other = dir.write("other.frag", "#include \"b.glsl\"\nvoid main() {}\n");
+
+    ShaderPreprocessor preprocessor;
+    REQUIRE(preprocessor.process(root).has_value());
+    REQUIRE(preprocessor.process(other).has_value());
+    CHECK(sorted(preprocessor.dependencies(root)) ==
+          std::vector<std::string>{dir.key("a.glsl"), dir.key("b.glsl")});
+    CHECK(sorted(preprocessor.dependents(dir.key("b.glsl"))) ==
+          std::vector<std::string>{dir.key("a.glsl"), dir.key("main.frag"),
+                                   dir.key("other.frag")});
+
+    // Unchanged files are served from memory
+    const ShaderPreprocessor::Stats before = preprocessor.stats();
+    REQUIRE(preprocessor.process(root).has_value());
+    CHECK(preprocessor.stats().parses == before.parses);
+    CHECK(preprocessor.stats().reuses == before.reuses + 3);
+
+    // Dropping the include from a.glsl removes main.frag from b.glsl's dependents
+    dir.write("a.glsl", "float a;\n");
+    const auto source = preprocessor.process(root);
+    REQUIRE(source.has_value());
+    CHECK(source->find("float b;") == std::string::npos);
+    CHECK(preprocessor.stats().parses == before.parses + 1);
+    CHECK(sorted(preprocessor.dependencies(root)) == std::vector<std::string>{dir.key("a.glsl")});
+    CHECK(sorted(preprocessor.dependents(dir.key("b.glsl"))) ==
+          std::vector<std::string>{dir.key("other.frag")});
+}
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <doctest/doctest.h>
+#include <spdlog/sinks/ringbuffer_sink.h>
+#include <spdlog/spdlog.h>
+
+#include "rendering/ShaderReflection.hpp"
+
+using vibegl::NameHash;
+using vibegl::ShaderReflection;
+using vibegl::UniformInfo;
+
+namespace
+{
+
+/// One glUniform*() call seen by UploadRecorder.
+struct Upload {
+    GLint location = -1;
+    GLsizei count = 0;
+    float first = 0.0f;  ///< First value, converted
+};
+
+std::vector<Upload>& uploads()
+{
+    static std::vector<Upload> calls;
+    return calls;
+}
+
+void APIENTRY recordFloats(GLint location, GLsizei count, const GLfloat* value)
+{
+    uploads().push_back({.location = location, .count = count, .first = value[0]});
+}
+
+void APIENTRY recordMatrix(GLint location, GLsizei count, GLboolean /*transpose*/,
+                           const GLfloat* value)
+{
+    uploads().push_back({.location = location, .count = count, .first = value[0]});
+}
+
+void APIENTRY recordInts(GLint location, GLsizei count, const GLint* value)
+{
+    uploads().push_back(
+        {.location = location, .count = count, .first = static_cast<float>(value[0])});
+}
+
+/// Points glad's uniform setters at recorders for its lifetime, so no context is needed.
+class UploadRecorder {
+public:
+    UploadRecorder()
+        : float1_(glad_glUniform1fv), float3_(glad_glUniform3fv), int1_(glad_glUniform1iv),
+          matrix4_(glad_glUniformMatrix4fv)
+    {
+        glad_glUniform1fv = recordFloats;
+        glad_glUniform3fv = recordFloats;
+        glad_glUniform1iv = recordInts;
+        glad_glUniformMatrix4fv = recordMatrix;
+        uploads().clear();
+    }
+
+    ~UploadRecorder()
+    {
+        glad_glUniform1fv = float1_;
+        glad_glUniform3fv = float3_;
+        glad_glUniform1iv = int1_;
+        glad_glUniformMatrix4fv = matrix4_;
+    }
+
+    UploadRecorder(const UploadRecorder&) = delete;
+    UploadRecorder& operator=(const UploadRecorder&) = delete;
+
+private:
+    PFNGLUNIFORM1FVPROC float1_;
+    PFNGLUNIFORM3FVPROC float3_;
+    PFNGLUNIFORM1IVPROC int1_;
+    PFNGLUNIFORMMATRIX4FVPROC matrix4_;
+};
+
+UniformInfo uniform(const char* name, GLint location, GLenum type, GLint size = 1)
+{
+    return UniformInfo{.name = NameHash::fromString(name),
+                       .location = location,
+                       .type = type,
+                       .size = size};
+}
+
+/// What reflect() would report for a small material shader.
+ShaderReflection materialTable()
+{
+    return ShaderReflection::fromTables(
+        7, {uniform("uMVP", 0, GL_FLOAT_MAT4), uniform("uColor", 1, GL_FLOAT_VEC3),
+            uniform("uTexture", 2, GL_SAMPLER_2D), uniform("uWeights[0]", 3, GL_FLOAT, 4),
+            uniform("uWeights", 3, GL_FLOAT, 4), uniform("uScale[0]", 7, GL_FLOAT),
+            uniform("uScale", 7, GL_FLOAT), uniform("uMask", 8, GL_UNSIGNED_INT_VEC2)});
+}
+
+} // namespace
+
+TEST_CASE("ShaderReflection lookups on an empty table")
+{
+    const ShaderReflection reflection;
+    CHECK(reflection.uniform("uMVP") == nullptr);
+    CHECK(reflection.location("uMVP") == -1);
+    CHECK(reflection.block("Lights") == nullptr);
+    CHECK(reflection.attribute("aPosition") == -1);
+}
+
+TEST_CASE("ShaderReflection tables built without GL are sorted and searchable")
+{
+    const ShaderReflection reflection = ShaderReflection::fromTables(
+        3, {uniform("uColor", 1, GL_FLOAT_VEC3), uniform("uMVP", 0, GL_FLOAT_MAT4)},
+        {vibegl::UniformBlockInfo{.name = "Lights", .index = 0, .dataSize = 64, .binding = 2}},
+        {vibegl::AttributeInfo{.name = "aPosition", .location = 0, .type = GL_FLOAT_VEC3},
+         vibegl::AttributeInfo{.name = "aTexCoord", .location = 1, .type = GL_FLOAT_VEC2}});
+
+    CHECK(std::ranges::is_sorted(reflection.uniforms(), {}, &UniformInfo::name));
+    CHECK(reflection.location("uMVP") == 0);
+    CHECK(reflection.location("uColor") == 1);
+    REQUIRE(reflection.block("Lights") != nullptr);
+    CHECK(reflection.block("Lights")->dataSize == 64);
+    CHECK(reflection.attribute("aTexCoord") == 1);
+    CHECK(reflection.attribute("aNormal") == -1);
+}
+
+TEST_CASE("ShaderReflection skips redundant uploads")
+{
+    const UploadRecorder recorder;
+    ShaderReflection reflection = materialTable();
+
+    const std::array<float, 4> white = {1.0f, 1.0f, 1.0f, 1.0f};
+    const std::array<float, 4> red = {1.0f, 0.0f, 0.0f, 1.0f};
+    CHECK(reflection.set("uColor", white));
+    CHECK_FALSE(reflection.set("uColor", white));
+    CHECK(reflection.set("uColor", red));
+    CHECK_FALSE(reflection.set("uColor", red));
+
+    // Only the components the uniform has are compared
+    CHECK_FALSE(reflection.set("uColor", std::array<float, 4>{1.0f, 0.0f, 0.0f, 0.5f}));
+
+    std::array<float, 16> mvp = {};
+    mvp[0] = 2.0f;
+    CHECK(reflection.set("uMVP", mvp));
+    CHECK_FALSE(reflection.set("uMVP", mvp));
+    CHECK(reflection.set("uTexture", 0));
+    CHECK_FALSE(reflection.set("uTexture", 0));
+    CHECK(reflection.set("uTexture", 1));
+    REQUIRE(uploads().size() == 5);
+    CHECK(uploads()[0].location == 1);
+    CHECK(uploads()[1].first == 1.0f);
+    CHECK(uploads()[2].location == 0);
+    CHECK(uploads()[2].first == 2.0f);
+    CHECK(uploads()[4].first == 1.0f);
+
+    // A value set behind the setters' back is uploaded again once invalidated
+    reflection.invalidateValues();
+    CHECK(reflection.set("uColor", red));
+    CHECK(reflection.set("uTexture", 1));
+    CHECK_FALSE(reflection.set("uTexture", 1));
+    CHECK(uploads().size() == 7);
+}
+
+TEST_CASE("ShaderReflection uploads arrays every time and shares slots with aliases")
+{
+    const UploadRecorder recorder;
+    ShaderReflection reflection = materialTable();
+
+    // Arrays are not cached; whole elements up to the array length are sent
+    const std::array<float, 6> weights = {0.5f, 0.25f, 0.125f, 0.0625f, 9.0f, 9.0f};
+    CHECK(reflection.set("uWeights", weights));
+    CHECK(reflection.set("uWeights[0]", weights));
+    REQUIRE(uploads().size() == 2);
+    CHECK(uploads()[0].count == 4);
+    CHECK(uploads()[1].location == 3);
+
+    // A one-element array and its "[0]" name share one cached value
+    CHECK(reflection.uniform("uScale")->valueOffset ==
+          reflection.uniform("uScale[0]")->valueOffset);
+    CHECK(reflection.uniform("uScale")->valueOffset != reflection.uniform("uColor")->valueOffset);
+    CHECK(reflection.set("uScale", 2.0f));
+    CHECK_FALSE(reflection.set("uScale", 2.0f));
+    CHECK(reflection.set("uScale[0]", 3.0f));
+    CHECK(reflection.set("uScale", 2.0f));
+    CHECK(uploads().size() == 5);
+}
+
+TEST_CASE("ShaderReflection setters reject mismatched types")
+{
+    const UploadRecorder recorder;
+    ShaderReflection reflection = materialTable();
+
+    // Float data for samplers and integer data for float uniforms
+    CHECK_FALSE(reflection.set("uTexture", 0.0f));
+    CHECK_FALSE(reflection.set("uColor", 1));
+    CHECK_FALSE(reflection.set("uMVP", std::array<GLint, 16>{}));
+
+    // Unsigned types have no setter yet
+    CHECK_FALSE(reflection.set("uMask", std::array<GLint, 2>{1, 2}));
+    CHECK_FALSE(reflection.set("uMask", std::array<float, 2>{1.0f, 2.0f}));
+
+    // Unknown names and too few components for one element
+    CHECK_FALSE(reflection.set("uMissing", 1.0f));
+    CHECK_FALSE(reflection.set("uColor", std::array<float, 2>{1.0f, 1.0f}));
+    CHECK(uploads().empty());
+}
+
+TEST_CASE("ShaderReflection warns about colliding name hashes")
+{
+    const auto sink = std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(8);
+    const std::shared_ptr<spdlog::logger> previous = spdlog::default_logger();
+    spdlog::set_default_logger(std::make_shared<spdlog::logger>("test", sink));
+
+    static_cast<void>(ShaderReflection::fromTables(
+        42, {uniform("uLights", 0, GL_FLOAT_VEC4), uniform("uColor", 1, GL_FLOAT_VEC3),
+             uniform("uLights", 2, GL_FLOAT_VEC4)}));
+    static_cast<void>(materialTable());
+    spdlog::set_default_logger(previous);
+
+    // Only the table with two entries under one hash warns
+    const std::vector<std::string> messages = sink->last_formatted();
+    REQUIRE(messages.size() == 1);
+    CHECK(messages[0].find("Program 42: two uniform names hash to") != std::string::npos);
+}
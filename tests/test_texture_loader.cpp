@@ -0,0 +1,210 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+#include "core/MappedFile.hpp"
+#include "rendering/BlockEncoder.hpp"
+#include "rendering/MipGenerator.hpp"
+#include "rendering/TextureLoader.hpp"
+
+using vibegl::BlockFormat;
+using vibegl::BlockQuality;
+using vibegl::MappedFile;
+using vibegl::TextureLoader;
+
+namespace
+{
+
+constexpr int kWidth = 37;
+constexpr int kHeight = 21;
+
+std::vector<unsigned char> testImage()
+{
+    std::vector<unsigned char> rgba(static_cast<std::size_t>(kWidth) * kHeight * 4);
+    for (std::size_t i = 0; i < rgba.size(); ++i)
+    {
+        rgba[i] = static_cast<unsigned char>((i * 7) % 251);
+    }
+    return rgba;
+}
+
+template<typename T>
+void patch(std::vector<std::byte>& file, std::size_t offset, T value)
+{
+    std::memcpy(file.data() + offset, &value, sizeof(T));
+}
+
+bool parses(std::vector<std::byte> file)
+{
+    return TextureLoader::parseKtx2(MappedFile::fromBuffer(std::move(file)), "test.ktx2")
+        .has_value();
+}
+
+} // namespace
+
+TEST_CASE("KTX2 files written by encodeKtx2 read back")
+{
+    const std::vector<unsigned char> rgba = testImage();
+    const std::vector<std::byte> file =
+        TextureLoader::encodeKtx2(rgba.data(), kWidth, kHeight, BlockFormat::BC7,
+                                  BlockQuality::Fast, true);
+
+    SUBCASE("From memory")
+    {
+        auto image = TextureLoader::parseKtx2(MappedFile::fromBuffer(file), "test.ktx2");
+        REQUIRE(image.has_value());
+        CHECK(image->format == 0x8E8C);
+        CHECK(image->blockBytes == 16);
+        CHECK(image->bottomUp);
+        REQUIRE(image->levels.size() ==
+                static_cast<std::size_t>(vibegl::MipGenerator::levelCount(kWidth, kHeight)));
+        CHECK(image->levels[0].width == kWidth);
+        CHECK(image->levels[0].height == kHeight);
+        CHECK(image->levels.back().width == 1);
+        CHECK(image->levels.back().height == 1);
+
+        // Level 0 holds exactly what BlockEncoder produces for the base image
+        std::vector<std::byte> blocks(
+            vibegl::BlockEncoder::encodedSize(BlockFormat::BC7, kWidth, kHeight));
+        vibegl::BlockEncoder::encode(rgba.data(), kWidth, kHeight, BlockFormat::BC7,
+                                     BlockQuality::Fast, blocks);
+        const std::span<const std::byte> level0 = image->data(0);
+        CHECK(std::vector<std::byte>(level0.begin(), level0.end()) == blocks);
+    }
+
+    SUBCASE("From disk")
+    {
+        const std::filesystem::path path =
+            std::filesystem::temp_directory_path() / "vibegl_tests" / "roundtrip.ktx2";
+        REQUIRE(vibegl::writeFileAtomically(path, file).has_value());
+        auto image = TextureLoader::readKtx2(path.string());
+        REQUIRE(image.has_value());
+        CHECK(image->levels.size() == 6);
+        CHECK(image->file.size() == file.size());
+        std::error_code error;
+        std::filesystem::remove_all(path.parent_path(), error);
+    }
+
+    SUBCASE("Top-down orientation")
+    {
+        const std::vector<std::byte> topDown = TextureLoader::encodeKtx2(
+            rgba.data(), kWidth, kHeight, BlockFormat::BC1, BlockQuality::Fast, false);
+        auto image = TextureLoader::parseKtx2(MappedFile::fromBuffer(topDown), "test.ktx2");
+        REQUIRE(image.has_value());
+        CHECK(image->format == 0x83F0);
+        CHECK_FALSE(image->bottomUp);
+    }
+}
+
+TEST_CASE("parseKtx2 rejects malformed files")
+{
+    const std::vector<unsigned char> rgba = testImage();
+    const std::vector<std::byte> file = TextureLoader::encodeKtx2(
+        rgba.data(), kWidth, kHeight, BlockFormat::BC1, BlockQuality::Fast, false);
+    REQUIRE(parses(file));
+
+    // Header: identifier, vkFormat at 12, levelCount at 40, level index from 80
+    constexpr std::size_t kLevelCount = 40;
+    constexpr std::size_t kLevelIndex = 80;
+
+    SUBCASE("Truncated header")
+    {
+        CHECK_FALSE(parses(std::vector<std::byte>(file.begin(), file.begin() + 79)));
+        CHECK_FALSE(parses({}));
+    }
+
+    SUBCASE("Truncated level data")
+    {
+        CHECK_FALSE(parses(std::vector<std::byte>(file.begin(), file.end() - 1)));
+    }
+
+    SUBCASE("Bad identifier")
+    {
+        std::vector<std::byte> bad = file;
+        bad[1] = std::byte{'Q'};
+        CHECK_FALSE(parses(bad));
+    }
+
+    SUBCASE("Level count beyond the full chain")
+    {
+        std::vector<std::byte> bad = file;
+        patch<std::uint32_t>(bad, kLevelCount, 7);
+        CHECK_FALSE(parses(bad));
+        patch<std::uint32_t>(bad, kLevelCount, std::numeric_limits<std::uint32_t>::max());
+        CHECK_FALSE(parses(bad));
+    }
+
+    SUBCASE("Level offsets that overflow")
+    {
+        std::vector<std::byte> bad = file;
+        patch<std::uint64_t>(bad, kLevelIndex, std::numeric_limits<std::uint64_t>::max() - 4);
+        CHECK_FALSE(parses(bad));
+
+        bad = file;
+        patch<std::uint64_t>(bad, kLevelIndex, file.size() - 8);
+        CHECK_FALSE(parses(bad));
+    }
+
+    SUBCASE("Level size that does not match the dimensions")
+    {
+        std::vector<std::byte> bad = file;
+        patch<std::uint64_t>(bad, kLevelIndex + 8, 8);
+        CHECK_FALSE(parses(bad));
+    }
+
+    SUBCASE("Unsupported format")
+    {
+        std::vector<std::byte> bad = file;
+        patch<std::uint32_t>(bad, 12, 37);  // VK_FORMAT_R8G8B8A8_UNORM
+        CHECK_FALSE(parses(bad));
+    }
+}
+
+TEST_CASE("Compression cache key")
+{
+    vibegl::TextureCompression settings;
+    settings.cacheDirectory = "cache";
+    const std::string contents = "image bytes";
+    const auto path = [&](const vibegl::TextureCompression& s, bool flip, std::string_view data)
+    { return TextureLoader::compressionCachePath("textures/rock.png", data, s, flip); };
+
+    const std::filesystem::path base = path(settings, true, contents);
+    CHECK(base.parent_path() == "cache");
+    CHECK(base.extension() == ".ktx2");
+    CHECK(base.filename().string().starts_with("rock-"));
+    CHECK(path(settings, true, contents) == base);
+
+    SUBCASE("Changes with the flip")
+    {
+        CHECK(path(settings, false, contents) != base);
+    }
+
+    SUBCASE("Changes with the quality")
+    {
+        vibegl::TextureCompression high = settings;
+        high.quality = BlockQuality::High;
+        CHECK(path(high, true, contents) != base);
+    }
+
+    SUBCASE("Changes with the format")
+    {
+        vibegl::TextureCompression bc7 = settings;
+        bc7.format = BlockFormat::BC7;
+        CHECK(path(bc7, true, contents) != base);
+    }
+
+    SUBCASE("Changes with the contents")
+    {
+        CHECK(path(settings, true, "edited bytes") != base);
+    }
+}